@@ -0,0 +1,140 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+/**
+ * Measures the time to load text data files, comparing the original line-by-line
+ * loader (reproduced below) with load_text_matrix on one thread and on all cores.
+ * Each data file given, such as the test resources, is scaled up by repeating its rows. Run as
+ *
+ *   grf_load_benchmark [num_copies] [file...]
+ *
+ * which defaults to 50 copies of test/forest/resources/gaussian_data.csv.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "commons/MatrixFile.h"
+
+using namespace grf;
+
+namespace {
+
+typedef std::pair<std::vector<double>, std::vector<size_t>> Matrix;
+
+/**
+ * The loader previously used by load_data: each line is read twice, and every value
+ * is tokenized with a stringstream and parsed with std::stod.
+ */
+Matrix load_data_line_by_line(const std::string& file_name) {
+  std::ifstream input_file(file_name);
+  if (!input_file.good()) {
+    throw std::runtime_error("Could not open input file.");
+  }
+
+  size_t num_rows = 0;
+  std::string line;
+  std::string first_line;
+  while (getline(input_file, line)) {
+    if (num_rows == 0) {
+      first_line = line;
+    }
+    ++num_rows;
+  }
+  input_file.close();
+  input_file.open(file_name);
+
+  size_t num_cols = 0;
+  std::string token;
+  std::stringstream first_line_stream(first_line);
+  while (first_line_stream >> token) {
+    num_cols++;
+  }
+
+  std::vector<double> storage(num_rows * num_cols);
+  size_t row = 0;
+  while (getline(input_file, line)) {
+    std::stringstream line_stream(line);
+    size_t column = 0;
+    while (line_stream >> token) {
+      storage.at(column * num_rows + row) = std::stod(token);
+      ++column;
+    }
+    ++row;
+  }
+  return std::make_pair(storage, std::vector<size_t>({num_rows, num_cols}));
+}
+
+std::string scale_up(const std::string& file_name, size_t num_copies) {
+  std::ifstream input_file(file_name, std::ios::binary);
+  if (!input_file.good()) {
+    throw std::runtime_error("Could not open input file " + file_name + ".");
+  }
+  std::stringstream contents;
+  contents << input_file.rdbuf();
+
+  std::string scaled_file_name = "load_benchmark_data.txt";
+  std::ofstream output_file(scaled_file_name, std::ios::binary);
+  for (size_t i = 0; i < num_copies; i++) {
+    output_file << contents.str();
+  }
+  return scaled_file_name;
+}
+
+template<typename Loader>
+double time_seconds(Loader load, size_t& num_rows) {
+  auto start = std::chrono::steady_clock::now();
+  Matrix matrix = load();
+  auto end = std::chrono::steady_clock::now();
+  num_rows = matrix.second[0];
+  return std::chrono::duration<double>(end - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  size_t num_copies = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 50;
+  std::vector<std::string> file_names(argv + std::min(argc, 2), argv + argc);
+  if (file_names.empty()) {
+    file_names.push_back("test/forest/resources/gaussian_data.csv");
+  }
+
+  std::printf("%-40s %10s %8s %12s %12s %12s\n", "file", "rows", "MB",
+              "original s", "1 thread s", "all cores s");
+  for (const std::string& file_name : file_names) {
+    std::string scaled_file_name = scale_up(file_name, num_copies);
+    std::ifstream scaled_file(scaled_file_name, std::ios::binary | std::ios::ate);
+    double megabytes = static_cast<double>(scaled_file.tellg()) / (1 << 20);
+
+    size_t num_rows;
+    double original = time_seconds([&] { return load_data_line_by_line(scaled_file_name); }, num_rows);
+    double single_thread = time_seconds([&] { return load_text_matrix(scaled_file_name, 1); }, num_rows);
+    double all_cores = time_seconds([&] { return load_text_matrix(scaled_file_name, 0); }, num_rows);
+    std::printf("%-40s %10zu %8.1f %12.3f %12.3f %12.3f\n", file_name.c_str(), num_rows, megabytes,
+                original, single_thread, all_cores);
+    std::remove(scaled_file_name.c_str());
+  }
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+/**
+ * Measures the per-row latency of predicting a few rows at a time, comparing the
+ * multi-threaded ForestPredictor::predict with ForestPredictor::predict_micro_batch,
+ * for regression and causal forests. Run as
+ *
+ *   grf_benchmark [num_trees] [num_requests]
+ *
+ * Every request predicts a fresh batch of rows, and the p50 and p99 latencies are
+ * reported in microseconds per row.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "forest/ForestPredictor.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainer.h"
+#include "forest/ForestTrainers.h"
+
+using namespace grf;
+
+namespace {
+
+const size_t NUM_FEATURES = 10;
+const size_t NUM_TRAIN_ROWS = 5000;
+const size_t OUTCOME_INDEX = NUM_FEATURES;
+const size_t TREATMENT_INDEX = NUM_FEATURES + 1;
+
+/**
+ * Simulates column-major data [X, Y, W] with a heterogeneous treatment effect.
+ */
+std::vector<double> simulate_data(size_t num_rows, std::mt19937_64& random) {
+  std::normal_distribution<double> normal;
+  std::bernoulli_distribution coin(0.5);
+  std::vector<double> values((NUM_FEATURES + 2) * num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    for (size_t col = 0; col < NUM_FEATURES; col++) {
+      values[row + col * num_rows] = normal(random);
+    }
+    double x0 = values[row];
+    double x1 = values[row + num_rows];
+    double w = coin(random) ? 1.0 : 0.0;
+    values[row + OUTCOME_INDEX * num_rows] = x0 + std::max(x1, 0.0) * w + normal(random);
+    values[row + TREATMENT_INDEX * num_rows] = w;
+  }
+  return values;
+}
+
+double percentile(std::vector<double> values, double quantile) {
+  std::sort(values.begin(), values.end());
+  size_t index = static_cast<size_t>(quantile * (values.size() - 1));
+  return values[index];
+}
+
+void run(const std::string& name,
+         const ForestPredictor& predictor,
+         const Forest& forest,
+         const Data& train_data,
+         const std::vector<double>& test_values,
+         size_t num_test_rows,
+         size_t batch_size,
+         size_t num_requests) {
+  size_t num_cols = NUM_FEATURES + 2;
+  size_t prediction_length = predictor.get_prediction_length();
+  std::vector<double> batch_values(batch_size * num_cols);
+  std::vector<double> predictions(batch_size * prediction_length);
+  PredictionScratch scratch;
+
+  std::vector<double> threaded_latencies;
+  std::vector<double> micro_batch_latencies;
+  for (size_t request = 0; request < num_requests; request++) {
+    size_t first_row = (request * batch_size) % (num_test_rows - batch_size);
+    for (size_t col = 0; col < num_cols; col++) {
+      for (size_t i = 0; i < batch_size; i++) {
+        batch_values[i + col * batch_size] = test_values[first_row + i + col * num_test_rows];
+      }
+    }
+    Data batch(batch_values, batch_size, num_cols);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Prediction> result = predictor.predict(forest, train_data, batch, false);
+    auto end = std::chrono::steady_clock::now();
+    threaded_latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count() / batch_size);
+
+    start = std::chrono::steady_clock::now();
+    PredictionOutput output(batch_size, prediction_length, predictions.data(), nullptr, nullptr, nullptr);
+    predictor.predict_micro_batch(forest, train_data, batch, output, scratch);
+    end = std::chrono::steady_clock::now();
+    micro_batch_latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count() / batch_size);
+  }
+
+  std::printf("%-12s %5zu %14.1f %14.1f %14.1f %14.1f\n", name.c_str(), batch_size,
+              percentile(threaded_latencies, 0.5), percentile(threaded_latencies, 0.99),
+              percentile(micro_batch_latencies, 0.5), percentile(micro_batch_latencies, 0.99));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  uint num_trees = argc > 1 ? static_cast<uint>(std::atoi(argv[1])) : 2000;
+  size_t num_requests = argc > 2 ? static_cast<size_t>(std::atoi(argv[2])) : 1000;
+  uint num_threads = 0;
+  size_t num_test_rows = 1000;
+
+  std::mt19937_64 random(42);
+  std::vector<double> train_values = simulate_data(NUM_TRAIN_ROWS, random);
+  std::vector<double> test_values = simulate_data(num_test_rows, random);
+
+  Data train_data(train_values, NUM_TRAIN_ROWS, NUM_FEATURES + 2);
+  train_data.set_outcome_index(OUTCOME_INDEX);
+  train_data.set_treatment_index(TREATMENT_INDEX);
+  train_data.set_instrument_index(TREATMENT_INDEX);
+
+  ForestOptions options(num_trees, 2, 0.5, 4, 5, true, 0.5, true, 0.05, 0.0,
+                        num_threads, 42, std::vector<size_t>(), 0);
+  Forest regression_forest = regression_trainer().train(train_data, options);
+  Forest causal_forest = instrumental_trainer(0.0, true).train(train_data, options);
+
+  ForestPredictor regression = regression_predictor(num_threads);
+  ForestPredictor causal = instrumental_predictor(num_threads);
+
+  std::printf("%zu training rows, %u trees, %zu requests per batch size\n",
+              NUM_TRAIN_ROWS, num_trees, num_requests);
+  std::printf("latency per row in microseconds\n");
+  std::printf("%-12s %5s %14s %14s %14s %14s\n", "forest", "rows",
+              "predict p50", "predict p99", "micro p50", "micro p99");
+  for (size_t batch_size : {1, 10, 50}) {
+    run("regression", regression, regression_forest, train_data, test_values, num_test_rows, batch_size, num_requests);
+    run("causal", causal, causal_forest, train_data, test_values, num_test_rows, batch_size, num_requests);
+  }
+
+  return 0;
+}
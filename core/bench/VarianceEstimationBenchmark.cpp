@@ -0,0 +1,167 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+/**
+ * Measures the time to estimate prediction variances for forests with many prediction
+ * value types: probability forests with many classes, and multi-arm causal forests.
+ * Run as
+ *
+ *   grf_variance_benchmark [num_trees] [num_repetitions]
+ *
+ * Each forest predicts the test rows with variance estimates through both
+ * ForestPredictor::predict and ForestPredictor::predict_micro_batch, and the median
+ * time over the repetitions is reported in milliseconds.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "forest/ForestPredictor.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainer.h"
+#include "forest/ForestTrainers.h"
+
+using namespace grf;
+
+namespace {
+
+const size_t NUM_FEATURES = 10;
+const size_t NUM_TRAIN_ROWS = 5000;
+const size_t NUM_TEST_ROWS = 1000;
+const size_t NUM_CLASSES = 20;
+const size_t NUM_TREATMENTS = 5;
+const size_t OUTCOME_INDEX = NUM_FEATURES;
+const size_t CLASS_INDEX = NUM_FEATURES + 1;
+const size_t TREATMENT_INDEX = NUM_FEATURES + 2;
+const size_t NUM_COLS = NUM_FEATURES + 2 + NUM_TREATMENTS;
+
+/**
+ * Simulates column-major data [X, Y, class, W] where W one-hot encodes one of
+ * NUM_TREATMENTS + 1 arms, the first of which is the control arm.
+ */
+std::vector<double> simulate_data(size_t num_rows, std::mt19937_64& random) {
+  std::normal_distribution<double> normal;
+  std::uniform_int_distribution<size_t> arm(0, NUM_TREATMENTS);
+  std::vector<double> values(NUM_COLS * num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    for (size_t col = 0; col < NUM_FEATURES; col++) {
+      values[row + col * num_rows] = normal(random);
+    }
+    double x0 = values[row];
+    double x1 = values[row + num_rows];
+    size_t treatment = arm(random);
+    double effect = treatment > 0 ? std::max(x1, 0.0) * treatment : 0.0;
+    values[row + OUTCOME_INDEX * num_rows] = x0 + effect + normal(random);
+
+    double score = x0 + 0.5 * normal(random);
+    double quantile = std::min(std::max((score + 2.5) / 5.0, 0.0), 0.999);
+    values[row + CLASS_INDEX * num_rows] = std::floor(quantile * NUM_CLASSES);
+    if (treatment > 0) {
+      values[row + (TREATMENT_INDEX + treatment - 1) * num_rows] = 1.0;
+    }
+  }
+  return values;
+}
+
+double median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+void run(const std::string& name,
+         const ForestPredictor& predictor,
+         const Forest& forest,
+         const Data& train_data,
+         const std::vector<double>& test_values,
+         size_t num_repetitions) {
+  size_t prediction_length = predictor.get_prediction_length();
+  size_t batch_size = 50;
+  std::vector<double> predictions(batch_size * prediction_length);
+  std::vector<double> variance_estimates(batch_size * prediction_length);
+  PredictionScratch scratch;
+
+  Data test_data(test_values, NUM_TEST_ROWS, NUM_COLS);
+  std::vector<Data> batches;
+  for (size_t first_row = 0; first_row + batch_size <= NUM_TEST_ROWS; first_row += batch_size) {
+    batches.emplace_back(test_values.data() + first_row, batch_size, NUM_COLS, NUM_TEST_ROWS);
+  }
+
+  std::vector<double> predict_times;
+  std::vector<double> micro_batch_times;
+  for (size_t repetition = 0; repetition < num_repetitions; repetition++) {
+    auto start = std::chrono::steady_clock::now();
+    predictor.predict(forest, train_data, test_data, true);
+    auto end = std::chrono::steady_clock::now();
+    predict_times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+
+    start = std::chrono::steady_clock::now();
+    for (const Data& batch : batches) {
+      PredictionOutput output(batch_size, prediction_length, predictions.data(),
+                              variance_estimates.data(), nullptr, nullptr);
+      predictor.predict_micro_batch(forest, train_data, batch, output, scratch);
+    }
+    end = std::chrono::steady_clock::now();
+    micro_batch_times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  std::printf("%-24s %12.1f %12.1f\n", name.c_str(), median(predict_times), median(micro_batch_times));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  uint num_trees = argc > 1 ? static_cast<uint>(std::atoi(argv[1])) : 1000;
+  size_t num_repetitions = argc > 2 ? static_cast<size_t>(std::atoi(argv[2])) : 5;
+  uint num_threads = 0;
+
+  std::mt19937_64 random(42);
+  std::vector<double> train_values = simulate_data(NUM_TRAIN_ROWS, random);
+  std::vector<double> test_values = simulate_data(NUM_TEST_ROWS, random);
+
+  Data train_data(train_values, NUM_TRAIN_ROWS, NUM_COLS);
+  std::vector<size_t> treatment_index;
+  for (size_t treatment = 0; treatment < NUM_TREATMENTS; treatment++) {
+    treatment_index.push_back(TREATMENT_INDEX + treatment);
+  }
+
+  ForestOptions options(num_trees, 2, 0.5, 4, 5, true, 0.5, true, 0.05, 0.0,
+                        num_threads, 42, std::vector<size_t>(), 0);
+
+  train_data.set_outcome_index(CLASS_INDEX);
+  Forest probability_forest = probability_trainer(NUM_CLASSES).train(train_data, options);
+
+  train_data.set_outcome_index(OUTCOME_INDEX);
+  train_data.set_treatment_index(treatment_index);
+  Forest multi_causal_forest = multi_causal_trainer(NUM_TREATMENTS, 1, true).train(train_data, options);
+
+  std::printf("%zu training rows, %zu test rows, %u trees\n", NUM_TRAIN_ROWS, NUM_TEST_ROWS, num_trees);
+  std::printf("median time in milliseconds to predict with variance estimates\n");
+  std::printf("%-24s %12s %12s\n", "forest", "predict", "micro batch");
+  run("probability (" + std::to_string(NUM_CLASSES) + " classes)",
+      probability_predictor(num_threads, NUM_CLASSES), probability_forest,
+      train_data, test_values, num_repetitions);
+  run("multi causal (" + std::to_string(NUM_TREATMENTS) + " arms)",
+      multi_causal_predictor(num_threads, NUM_TREATMENTS, 1), multi_causal_forest,
+      train_data, test_values, num_repetitions);
+
+  return 0;
+}
@@ -0,0 +1,163 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "grf_c.h"
+#include "commons/Data.h"
+#include "forest/Forest.h"
+#include "forest/ForestOptions.h"
+#include "forest/ForestPredictor.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestSerializer.h"
+
+using namespace grf;
+
+struct grf_forest {
+  explicit grf_forest(Forest&& forest): forest(std::move(forest)) {}
+  Forest forest;
+};
+
+struct grf_predictor {
+  explicit grf_predictor(ForestPredictor&& predictor): predictor(std::move(predictor)) {}
+  ForestPredictor predictor;
+};
+
+namespace {
+
+thread_local std::string last_error;
+
+grf_status fail(const std::string& message) {
+  last_error = message;
+  return GRF_ERROR;
+}
+
+ForestPredictor create_predictor(grf_forest_type type,
+                                 uint num_threads,
+                                 size_t num_outcomes,
+                                 size_t num_treatments) {
+  switch (type) {
+    case GRF_REGRESSION:
+      return regression_predictor(num_threads);
+    case GRF_INSTRUMENTAL:
+      return instrumental_predictor(num_threads);
+    case GRF_MULTI_CAUSAL:
+      return multi_causal_predictor(num_threads, num_treatments, num_outcomes);
+    case GRF_MULTI_REGRESSION:
+      return multi_regression_predictor(num_threads, num_outcomes);
+    case GRF_PROBABILITY:
+      return probability_predictor(num_threads, num_outcomes);
+    case GRF_CAUSAL_SURVIVAL:
+      return causal_survival_predictor(num_threads);
+  }
+  throw std::runtime_error("Unknown forest type " + std::to_string(type) + ".");
+}
+
+} // namespace
+
+uint32_t grf_api_version(void) {
+  return GRF_C_API_VERSION;
+}
+
+const char* grf_last_error(void) {
+  return last_error.c_str();
+}
+
+grf_status grf_forest_load(const char* file_name, grf_forest** forest) {
+  if (file_name == nullptr || forest == nullptr) {
+    return fail("grf_forest_load: file_name and forest must not be NULL.");
+  }
+  try {
+    ForestSerializer serializer;
+    *forest = new grf_forest(serializer.load(file_name));
+    return GRF_OK;
+  } catch (const std::exception& e) {
+    return fail(e.what());
+  }
+}
+
+void grf_forest_free(grf_forest* forest) {
+  delete forest;
+}
+
+size_t grf_forest_num_trees(const grf_forest* forest) {
+  return forest->forest.get_trees().size();
+}
+
+size_t grf_forest_num_variables(const grf_forest* forest) {
+  return forest->forest.get_num_variables();
+}
+
+size_t grf_forest_ci_group_size(const grf_forest* forest) {
+  return forest->forest.get_ci_group_size();
+}
+
+grf_status grf_predictor_create(grf_forest_type type,
+                                uint32_t num_threads,
+                                size_t num_outcomes,
+                                size_t num_treatments,
+                                grf_predictor** predictor) {
+  if (predictor == nullptr) {
+    return fail("grf_predictor_create: predictor must not be NULL.");
+  }
+  try {
+    uint threads = ForestOptions::validate_num_threads(num_threads);
+    *predictor = new grf_predictor(create_predictor(type, threads, num_outcomes, num_treatments));
+    return GRF_OK;
+  } catch (const std::exception& e) {
+    return fail(e.what());
+  }
+}
+
+void grf_predictor_free(grf_predictor* predictor) {
+  delete predictor;
+}
+
+size_t grf_predictor_prediction_length(const grf_predictor* predictor) {
+  return predictor->predictor.get_prediction_length();
+}
+
+grf_status grf_predict(const grf_predictor* predictor,
+                       const grf_forest* forest,
+                       const double* data,
+                       size_t num_rows,
+                       size_t num_cols,
+                       double* predictions,
+                       double* variance_estimates) {
+  if (predictor == nullptr || forest == nullptr || data == nullptr || predictions == nullptr) {
+    return fail("grf_predict: predictor, forest, data and predictions must not be NULL.");
+  }
+  if (num_cols < forest->forest.get_num_variables()) {
+    return fail("grf_predict: the data has " + std::to_string(num_cols) + " columns, but the forest"
+                " was trained on " + std::to_string(forest->forest.get_num_variables()) + " variables.");
+  }
+  try {
+    // Each thread keeps its own scratch, so that scoring a few rows at a time reuses
+    // the same buffers across calls.
+    thread_local PredictionScratch scratch;
+
+    Data test_data(data, num_rows, num_cols);
+    PredictionOutput output(num_rows, predictor->predictor.get_prediction_length(),
+                            predictions, variance_estimates, nullptr, nullptr);
+    predictor->predictor.predict_micro_batch(forest->forest, test_data, test_data, output, scratch);
+    return GRF_OK;
+  } catch (const std::exception& e) {
+    return fail(e.what());
+  }
+}
@@ -0,0 +1,140 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_C_H
+#define GRF_C_H
+
+/**
+ * A small C interface for embedding grf prediction, e.g. through the FFI of another
+ * language. It loads forests saved by ForestSerializer and predicts into buffers owned
+ * by the caller.
+ *
+ * Matrices are dense, column-major arrays of doubles, the layout used throughout grf:
+ * entry (i, j) of a matrix with num_rows rows is at index i + j * num_rows. The test
+ * data passed to grf_predict holds the forest's covariates in its first
+ * grf_forest_num_variables() columns.
+ *
+ * All functions returning grf_status report failures through GRF_ERROR, and the
+ * message of the last failure on the calling thread is available from
+ * grf_last_error(). Forests and predictors are immutable once created, so a single
+ * handle can be shared by threads predicting concurrently.
+ *
+ * Only forests with precomputed leaf summaries are supported, as the others need
+ * their training data at prediction time (quantile, local linear and survival forests).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(GRF_C_API_EXPORTS)
+#    define GRF_C_API __declspec(dllexport)
+#  else
+#    define GRF_C_API
+#  endif
+#else
+#  define GRF_C_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Incremented whenever a function of this interface changes incompatibly. */
+#define GRF_C_API_VERSION 1
+
+typedef enum {
+  GRF_OK = 0,
+  GRF_ERROR = 1
+} grf_status;
+
+typedef enum {
+  GRF_REGRESSION = 0,
+  GRF_INSTRUMENTAL = 1,
+  GRF_MULTI_CAUSAL = 2,
+  GRF_MULTI_REGRESSION = 3,
+  GRF_PROBABILITY = 4,
+  GRF_CAUSAL_SURVIVAL = 5
+} grf_forest_type;
+
+typedef struct grf_forest grf_forest;
+typedef struct grf_predictor grf_predictor;
+
+/** The GRF_C_API_VERSION the library was built with. */
+GRF_C_API uint32_t grf_api_version(void);
+
+/**
+ * The message of the last failed call on this thread. The returned string is valid
+ * until the next failing call on the same thread.
+ */
+GRF_C_API const char* grf_last_error(void);
+
+/** Loads a forest file written by ForestSerializer. */
+GRF_C_API grf_status grf_forest_load(const char* file_name, grf_forest** forest);
+
+GRF_C_API void grf_forest_free(grf_forest* forest);
+
+GRF_C_API size_t grf_forest_num_trees(const grf_forest* forest);
+
+GRF_C_API size_t grf_forest_num_variables(const grf_forest* forest);
+
+GRF_C_API size_t grf_forest_ci_group_size(const grf_forest* forest);
+
+/**
+ * Creates a predictor for forests of the given type.
+ *
+ * @param num_threads: the number of threads used for large batches, or 0 to use all
+ * available cores. Batches of a few rows are always predicted on the calling thread.
+ * @param num_outcomes: the number of outcomes of multi-outcome forests, or classes of
+ * probability forests. Ignored by the other types.
+ * @param num_treatments: the number of treatments of multi-causal forests. Ignored by
+ * the other types.
+ */
+GRF_C_API grf_status grf_predictor_create(grf_forest_type type,
+                                          uint32_t num_threads,
+                                          size_t num_outcomes,
+                                          size_t num_treatments,
+                                          grf_predictor** predictor);
+
+GRF_C_API void grf_predictor_free(grf_predictor* predictor);
+
+/** The number of prediction columns written for each row. */
+GRF_C_API size_t grf_predictor_prediction_length(const grf_predictor* predictor);
+
+/**
+ * Predicts for every row of the column-major test matrix. Fails if the predictor does
+ * not match the forest, for example a probability predictor created with a different
+ * number of classes than the forest was trained with.
+ *
+ * @param predictions: a num_rows x prediction_length column-major output buffer.
+ * @param variance_estimates: a buffer of the same shape for variance estimates, or NULL
+ * if they are not needed. Variance estimates require a forest trained with
+ * ci_group_size greater than 1.
+ */
+GRF_C_API grf_status grf_predict(const grf_predictor* predictor,
+                                 const grf_forest* forest,
+                                 const double* data,
+                                 size_t num_rows,
+                                 size_t num_cols,
+                                 double* predictions,
+                                 double* variance_estimates);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //GRF_C_H
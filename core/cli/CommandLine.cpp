@@ -0,0 +1,171 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "CommandLine.h"
+
+namespace grf {
+
+namespace {
+
+std::vector<std::string> split(const std::string& text) {
+  std::vector<std::string> parts;
+  size_t start = 0;
+  while (true) {
+    size_t end = text.find(',', start);
+    parts.push_back(text.substr(start, end == std::string::npos ? std::string::npos : end - start));
+    if (end == std::string::npos) {
+      return parts;
+    }
+    start = end + 1;
+  }
+}
+
+double parse_double(const std::string& name, const std::string& text) {
+  char* end;
+  errno = 0;
+  double value = std::strtod(text.c_str(), &end);
+  if (text.empty() || *end != '\0' || errno != 0) {
+    throw std::runtime_error("Option --" + name + " expects a number, but got '" + text + "'.");
+  }
+  return value;
+}
+
+bool is_bool(const std::string& text) {
+  return text == "true" || text == "1" || text == "false" || text == "0";
+}
+
+size_t parse_size(const std::string& name, const std::string& text) {
+  char* end;
+  errno = 0;
+  unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+  if (text.empty() || text[0] == '-' || *end != '\0' || errno != 0) {
+    throw std::runtime_error("Option --" + name + " expects a non-negative integer, but got '" + text + "'.");
+  }
+  return static_cast<size_t>(value);
+}
+
+} // namespace
+
+CommandLine::CommandLine(const std::vector<std::string>& arguments,
+                         const std::set<std::string>& flag_names) {
+  for (size_t i = 0; i < arguments.size(); i++) {
+    const std::string& argument = arguments[i];
+    if (argument.size() <= 2 || argument.compare(0, 2, "--") != 0) {
+      positional.push_back(argument);
+      continue;
+    }
+
+    std::string name = argument.substr(2);
+    std::string value;
+    size_t separator = name.find('=');
+    if (separator != std::string::npos) {
+      value = name.substr(separator + 1);
+      name = name.substr(0, separator);
+    } else if (flag_names.count(name) > 0) {
+      // A flag takes the following argument as its value only if it is a boolean.
+      bool has_value = i + 1 < arguments.size() && is_bool(arguments[i + 1]);
+      value = has_value ? arguments[++i] : "true";
+    } else if (i + 1 < arguments.size()) {
+      value = arguments[++i];
+    } else {
+      throw std::runtime_error("Option --" + name + " is missing a value.");
+    }
+
+    if (options.count(name) > 0) {
+      throw std::runtime_error("Option --" + name + " was given more than once.");
+    }
+    options[name] = value;
+  }
+}
+
+bool CommandLine::has(const std::string& name) const {
+  return options.count(name) > 0;
+}
+
+std::string CommandLine::get_string(const std::string& name) const {
+  return get_value(name);
+}
+
+std::string CommandLine::get_string(const std::string& name, const std::string& default_value) const {
+  return has(name) ? get_value(name) : default_value;
+}
+
+size_t CommandLine::get_size(const std::string& name) const {
+  return parse_size(name, get_value(name));
+}
+
+size_t CommandLine::get_size(const std::string& name, size_t default_value) const {
+  return has(name) ? get_size(name) : default_value;
+}
+
+double CommandLine::get_double(const std::string& name, double default_value) const {
+  return has(name) ? parse_double(name, get_value(name)) : default_value;
+}
+
+bool CommandLine::get_bool(const std::string& name, bool default_value) const {
+  if (!has(name)) {
+    return default_value;
+  }
+  const std::string& value = get_value(name);
+  if (is_bool(value)) {
+    return value == "true" || value == "1";
+  }
+  throw std::runtime_error("Option --" + name + " expects true or false, but got '" + value + "'.");
+}
+
+std::vector<double> CommandLine::get_doubles(const std::string& name) const {
+  std::vector<double> values;
+  for (const std::string& part : split(get_value(name))) {
+    values.push_back(parse_double(name, part));
+  }
+  return values;
+}
+
+std::vector<size_t> CommandLine::get_sizes(const std::string& name) const {
+  std::vector<size_t> values;
+  for (const std::string& part : split(get_value(name))) {
+    values.push_back(parse_size(name, part));
+  }
+  return values;
+}
+
+const std::vector<std::string>& CommandLine::get_positional() const {
+  return positional;
+}
+
+void CommandLine::check_all_used() const {
+  for (const auto& option : options) {
+    if (used.count(option.first) == 0) {
+      throw std::runtime_error("Unknown option --" + option.first + ".");
+    }
+  }
+}
+
+const std::string& CommandLine::get_value(const std::string& name) const {
+  auto option = options.find(name);
+  if (option == options.end()) {
+    throw std::runtime_error("Missing required option --" + name + ".");
+  }
+  used.insert(name);
+  return option->second;
+}
+
+} // namespace grf
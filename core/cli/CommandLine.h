@@ -0,0 +1,79 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_COMMANDLINE_H
+#define GRF_COMMANDLINE_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "commons/globals.h"
+
+namespace grf {
+
+/**
+ * Options of a command line tool command, given as "--name value" or "--name=value".
+ * Flags are options without a value, such as "--variance", which may still be given
+ * an explicit boolean value like "--variance=false" or "--variance false". All other
+ * arguments are positional.
+ *
+ * Every option must be read by the command, so that misspelled options are reported
+ * by check_all_used instead of being silently ignored.
+ */
+class CommandLine {
+public:
+  CommandLine(const std::vector<std::string>& arguments,
+              const std::set<std::string>& flag_names);
+
+  bool has(const std::string& name) const;
+
+  std::string get_string(const std::string& name) const;
+  std::string get_string(const std::string& name, const std::string& default_value) const;
+
+  size_t get_size(const std::string& name) const;
+  size_t get_size(const std::string& name, size_t default_value) const;
+
+  double get_double(const std::string& name, double default_value) const;
+
+  bool get_bool(const std::string& name, bool default_value) const;
+
+  /**
+   * Reads a comma separated list, e.g. "--quantiles 0.1,0.5,0.9".
+   */
+  std::vector<double> get_doubles(const std::string& name) const;
+  std::vector<size_t> get_sizes(const std::string& name) const;
+
+  const std::vector<std::string>& get_positional() const;
+
+  /**
+   * Throws if any option was not read by the command.
+   */
+  void check_all_used() const;
+
+private:
+  const std::string& get_value(const std::string& name) const;
+
+  std::map<std::string, std::string> options;
+  std::vector<std::string> positional;
+  mutable std::set<std::string> used;
+};
+
+} // namespace grf
+
+#endif //GRF_COMMANDLINE_H
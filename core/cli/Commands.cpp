@@ -0,0 +1,521 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Commands.h"
+#include "commons/ByteOrder.h"
+#include "commons/Data.h"
+#include "commons/MatrixFile.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestSerializer.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/PredictionOutput.h"
+#include "prediction/collector/SampleWeightComputer.h"
+#include "prediction/collector/TreeTraverser.h"
+
+namespace grf {
+
+const std::set<std::string> COMMAND_FLAGS = {
+    "variance", "errors", "oob", "equalize-cluster-weights", "honesty",
+    "honesty-prune-leaves", "stabilize-splits", "store-leaf-samples"};
+
+namespace {
+
+const std::string TYPE = "type";
+const std::string OUTCOME = "outcome";
+const std::string TREATMENT = "treatment";
+const std::string INSTRUMENT = "instrument";
+const std::string WEIGHT = "weight";
+const std::string QUANTILES = "quantiles";
+const std::string NUM_CLASSES = "num_classes";
+const std::string NUM_COLUMNS = "num_columns";
+
+typedef std::pair<std::vector<double>, std::vector<size_t>> Matrix;
+
+std::string join(const std::vector<size_t>& values) {
+  std::string text;
+  for (size_t i = 0; i < values.size(); i++) {
+    text += (i > 0 ? "," : "") + std::to_string(values[i]);
+  }
+  return text;
+}
+
+std::string join(const std::vector<double>& values) {
+  std::string text;
+  for (size_t i = 0; i < values.size(); i++) {
+    // Quantiles are written with full precision so that they are read back exactly.
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.17g", values[i]);
+    text += (i > 0 ? "," : "") + std::string(buffer);
+  }
+  return text;
+}
+
+std::vector<std::string> split(const std::string& text) {
+  std::vector<std::string> parts;
+  size_t start = 0;
+  while (start <= text.size()) {
+    size_t end = text.find(',', start);
+    if (end == std::string::npos) {
+      end = text.size();
+    }
+    parts.push_back(text.substr(start, end - start));
+    start = end + 1;
+  }
+  return parts;
+}
+
+std::vector<size_t> get_metadata_indices(const ForestMetadata& metadata, const std::string& key) {
+  std::vector<size_t> indices;
+  for (const std::string& part : split(metadata.at(key))) {
+    indices.push_back(std::stoul(part));
+  }
+  return indices;
+}
+
+std::vector<double> get_metadata_values(const ForestMetadata& metadata, const std::string& key) {
+  std::vector<double> values;
+  for (const std::string& part : split(metadata.at(key))) {
+    values.push_back(std::stod(part));
+  }
+  return values;
+}
+
+/**
+ * A data file given on the command line. Binary matrix files are memory mapped, so
+ * that their values are read in place, and text files are loaded into memory.
+ */
+class DataFile {
+public:
+  DataFile(const std::string& file_name) {
+    if (is_little_endian() && is_binary_matrix(file_name)) {
+      mapping.reset(new MappedMatrix(file_name));
+    } else {
+      matrix = load_matrix(file_name);
+    }
+  }
+
+  Data get_data() const {
+    return mapping ? mapping->get_data() : Data(matrix);
+  }
+
+  void advise_sequential() const {
+    if (mapping) {
+      mapping->advise_sequential();
+    }
+  }
+
+  void advise_random() const {
+    if (mapping) {
+      mapping->advise_random();
+    }
+  }
+
+private:
+  std::unique_ptr<MappedMatrix> mapping;
+  Matrix matrix;
+
+  DISALLOW_COPY_AND_ASSIGN(DataFile);
+};
+
+void check_columns(const std::vector<size_t>& columns, const Data& data, const std::string& option) {
+  for (size_t column : columns) {
+    if (column >= data.get_num_cols()) {
+      throw std::runtime_error("Column " + std::to_string(column) + " given by --" + option +
+                               " is out of range, the data has " + std::to_string(data.get_num_cols()) +
+                               " columns (numbered from 0).");
+    }
+  }
+}
+
+std::vector<size_t> get_columns(const CommandLine& command_line, const std::string& option, const Data& data) {
+  std::vector<size_t> columns = command_line.get_sizes(option);
+  check_columns(columns, data, option);
+  return columns;
+}
+
+/**
+ * Sets the outcome, treatment, instrument and weight columns recorded in the forest metadata.
+ */
+void set_data_columns(const ForestMetadata& metadata, Data& data) {
+  for (const auto& entry : metadata) {
+    if (entry.first == OUTCOME || entry.first == TREATMENT ||
+        entry.first == INSTRUMENT || entry.first == WEIGHT) {
+      check_columns(get_metadata_indices(metadata, entry.first), data, entry.first);
+    }
+  }
+  data.set_outcome_index(get_metadata_indices(metadata, OUTCOME));
+  if (metadata.count(TREATMENT) > 0) {
+    data.set_treatment_index(get_metadata_indices(metadata, TREATMENT));
+  }
+  if (metadata.count(INSTRUMENT) > 0) {
+    data.set_instrument_index(get_metadata_indices(metadata, INSTRUMENT)[0]);
+  }
+  if (metadata.count(WEIGHT) > 0) {
+    data.set_weight_index(get_metadata_indices(metadata, WEIGHT)[0]);
+  }
+}
+
+Forest load_forest(const std::string& file_name, ForestMetadata& metadata) {
+  Forest forest = ForestSerializer().load(file_name, metadata);
+  if (metadata.count(TYPE) == 0 || metadata.count(OUTCOME) == 0 || metadata.count(NUM_COLUMNS) == 0) {
+    throw std::runtime_error("The forest in " + file_name + " was not saved by the grf command line tool,"
+                             " so its type and training columns are unknown.");
+  }
+  return forest;
+}
+
+/**
+ * The trees split on column indices of the training data, so data to predict on must
+ * have its columns in the same positions.
+ */
+void check_num_columns(const ForestMetadata& metadata, const Data& data) {
+  size_t num_columns = std::stoul(metadata.at(NUM_COLUMNS));
+  if (data.get_num_cols() != num_columns) {
+    throw std::runtime_error("The data has " + std::to_string(data.get_num_cols()) + " columns, but the forest"
+                             " was trained on data with " + std::to_string(num_columns) + " columns.");
+  }
+}
+
+ForestPredictor create_predictor(const ForestMetadata& metadata, uint num_threads) {
+  const std::string& type = metadata.at(TYPE);
+  if (type == "regression") {
+    return regression_predictor(num_threads);
+  } else if (type == "multi_regression") {
+    return multi_regression_predictor(num_threads, get_metadata_indices(metadata, OUTCOME).size());
+  } else if (type == "quantile") {
+    return quantile_predictor(num_threads, get_metadata_values(metadata, QUANTILES));
+  } else if (type == "probability") {
+    return probability_predictor(num_threads, std::stoul(metadata.at(NUM_CLASSES)));
+  } else if (type == "causal" || type == "instrumental") {
+    return instrumental_predictor(num_threads);
+  } else if (type == "multi_causal") {
+    return multi_causal_predictor(num_threads,
+                                  get_metadata_indices(metadata, TREATMENT).size(),
+                                  get_metadata_indices(metadata, OUTCOME).size());
+  }
+  throw std::runtime_error("Unknown forest type '" + type + "'.");
+}
+
+std::string get_output_format(const CommandLine& command_line) {
+  std::string format = command_line.get_string("format", "csv");
+  if (format != "csv" && format != "binary") {
+    throw std::runtime_error("Option --format must be csv or binary, but got '" + format + "'.");
+  }
+  return format;
+}
+
+void save_output(const std::vector<double>& values,
+                 size_t num_rows,
+                 size_t num_cols,
+                 const std::string& file_name,
+                 const std::string& format) {
+  if (format == "csv") {
+    save_text_matrix(values, num_rows, num_cols, file_name);
+  } else {
+    save_binary_matrix(values, num_rows, num_cols, file_name);
+  }
+}
+
+} // namespace
+
+void train_command(const CommandLine& command_line) {
+  std::string type = command_line.get_string("type", "regression");
+  std::string data_file = command_line.get_string("data");
+  std::string forest_file = command_line.get_string("forest");
+
+  DataFile file(data_file);
+  file.advise_sequential();
+  Data data = file.get_data();
+
+  ForestMetadata metadata;
+  metadata[TYPE] = type;
+  metadata[NUM_COLUMNS] = std::to_string(data.get_num_cols());
+
+  std::vector<size_t> outcome = get_columns(command_line, OUTCOME, data);
+  data.set_outcome_index(outcome);
+  metadata[OUTCOME] = join(outcome);
+
+  bool has_treatment = type == "causal" || type == "instrumental" || type == "multi_causal";
+  std::vector<size_t> treatment;
+  if (has_treatment) {
+    treatment = get_columns(command_line, TREATMENT, data);
+    data.set_treatment_index(treatment);
+    metadata[TREATMENT] = join(treatment);
+  }
+  if (type == "causal") {
+    // A causal forest is an instrumental forest whose instrument is the treatment.
+    data.set_instrument_index(treatment[0]);
+    metadata[INSTRUMENT] = join(treatment);
+  } else if (type == "instrumental") {
+    std::vector<size_t> instrument = get_columns(command_line, INSTRUMENT, data);
+    data.set_instrument_index(instrument[0]);
+    metadata[INSTRUMENT] = join(instrument);
+  }
+
+  if (command_line.has(WEIGHT)) {
+    std::vector<size_t> weight = get_columns(command_line, WEIGHT, data);
+    data.set_weight_index(weight[0]);
+    metadata[WEIGHT] = join(weight);
+  }
+
+  bool stabilize_splits = command_line.get_bool("stabilize-splits", true);
+  size_t default_ci_group_size = 2;
+  ForestTrainer trainer = regression_trainer();
+  if (type == "regression") {
+    // regression_trainer() is the default above.
+  } else if (type == "multi_regression") {
+    trainer = multi_regression_trainer(outcome.size());
+    default_ci_group_size = 1;
+  } else if (type == "quantile") {
+    std::vector<double> quantiles = command_line.has(QUANTILES)
+        ? command_line.get_doubles(QUANTILES)
+        : std::vector<double>({0.1, 0.5, 0.9});
+    trainer = quantile_trainer(quantiles);
+    metadata[QUANTILES] = join(quantiles);
+    default_ci_group_size = 1;
+  } else if (type == "probability") {
+    // The outcome must hold the class labels 0, ..., num_classes - 1.
+    size_t max_class = 0;
+    for (size_t row = 0; row < data.get_num_rows(); row++) {
+      double label = data.get_outcome(row);
+      if (label < 0 || std::floor(label) != label) {
+        throw std::runtime_error("The outcome of a probability forest must be class labels 0, 1, 2, ...");
+      }
+      max_class = std::max(max_class, static_cast<size_t>(label));
+    }
+    size_t num_classes = command_line.get_size("num-classes", max_class + 1);
+    if (num_classes <= max_class) {
+      throw std::runtime_error("The outcome has class labels greater than --num-classes - 1.");
+    }
+    trainer = probability_trainer(num_classes);
+    metadata[NUM_CLASSES] = std::to_string(num_classes);
+  } else if (type == "causal" || type == "instrumental") {
+    if (outcome.size() != 1 || treatment.size() != 1) {
+      throw std::runtime_error("A " + type + " forest takes exactly one outcome and one treatment column.");
+    }
+    trainer = instrumental_trainer(command_line.get_double("reduced-form-weight", 0.0), stabilize_splits);
+  } else if (type == "multi_causal") {
+    trainer = multi_causal_trainer(treatment.size(), outcome.size(), stabilize_splits);
+  } else {
+    throw std::runtime_error("Unknown forest type '" + type + "'. Supported types are regression,"
+                             " multi_regression, quantile, probability, causal, instrumental and multi_causal.");
+  }
+
+  std::vector<size_t> clusters;
+  uint samples_per_cluster = 0;
+  if (command_line.has("clusters")) {
+    Matrix cluster_matrix = load_matrix(command_line.get_string("clusters"));
+    if (cluster_matrix.first.size() != data.get_num_rows()) {
+      throw std::runtime_error("The clusters file must have one value for each row of the data.");
+    }
+    std::unordered_map<size_t, size_t> cluster_sizes;
+    for (double cluster : cluster_matrix.first) {
+      if (cluster < 0 || std::floor(cluster) != cluster) {
+        throw std::runtime_error("Cluster ids must be non-negative integers.");
+      }
+      clusters.push_back(static_cast<size_t>(cluster));
+      cluster_sizes[clusters.back()]++;
+    }
+
+    // As in the R package, draw as many samples from each cluster as the largest cluster
+    // has, or as the smallest one has if clusters should be weighted equally.
+    bool equalize_cluster_weights = command_line.get_bool("equalize-cluster-weights", false);
+    size_t default_samples_per_cluster = equalize_cluster_weights ? data.get_num_rows() : 0;
+    for (const auto& cluster_size : cluster_sizes) {
+      default_samples_per_cluster = equalize_cluster_weights
+          ? std::min(default_samples_per_cluster, cluster_size.second)
+          : std::max(default_samples_per_cluster, cluster_size.second);
+    }
+    samples_per_cluster = command_line.get_size("samples-per-cluster", default_samples_per_cluster);
+  }
+
+  size_t num_covariates = data.get_num_cols() - data.get_disallowed_split_variables().size();
+  size_t default_mtry = std::min(static_cast<size_t>(std::ceil(std::sqrt(num_covariates) + 20)), num_covariates);
+
+  uint num_threads = command_line.get_size("num-threads", 0);
+  ForestOptions options(command_line.get_size("num-trees", 2000),
+                        command_line.get_size("ci-group-size", default_ci_group_size),
+                        command_line.get_double("sample-fraction", 0.5),
+                        command_line.get_size("mtry", default_mtry),
+                        command_line.get_size("min-node-size", 5),
+                        command_line.get_bool("honesty", true),
+                        command_line.get_double("honesty-fraction", 0.5),
+                        command_line.get_bool("honesty-prune-leaves", true),
+                        command_line.get_double("alpha", 0.05),
+                        command_line.get_double("imbalance-penalty", 0.0),
+                        num_threads,
+                        command_line.get_size("seed", 0),
+                        clusters,
+                        samples_per_cluster,
+                        command_line.get_bool("store-leaf-samples", true));
+  command_line.check_all_used();
+
+  // Growing the trees reads the values of subsamples in no particular order.
+  file.advise_random();
+  Forest forest = trainer.train(data, options);
+  ForestSerializer().save(forest, metadata, forest_file);
+}
+
+void predict_command(const CommandLine& command_line, bool oob_prediction) {
+  ForestMetadata metadata;
+  Forest forest = load_forest(command_line.get_string("forest"), metadata);
+
+  DataFile file(command_line.get_string("data"));
+  file.advise_random();
+  Data data = file.get_data();
+  check_num_columns(metadata, data);
+
+  // Quantile forests predict from the training outcomes, while the other forest types
+  // only need their precomputed leaf values. Out-of-bag predictions are for the training data.
+  std::unique_ptr<DataFile> train_file;
+  bool has_train_data = !oob_prediction && command_line.has("train-data");
+  if (has_train_data) {
+    train_file.reset(new DataFile(command_line.get_string("train-data")));
+    train_file->advise_random();
+  } else if (!oob_prediction && metadata.at(TYPE) == "quantile") {
+    throw std::runtime_error("Quantile forests need the training data, given by --train-data.");
+  }
+  Data train_data = has_train_data ? train_file->get_data() : data;
+  if (has_train_data || oob_prediction) {
+    set_data_columns(metadata, train_data);
+  }
+  if (oob_prediction) {
+    set_data_columns(metadata, data);
+  }
+
+  ForestPredictor predictor = create_predictor(metadata, command_line.get_size("num-threads", 0));
+  bool estimate_variance = command_line.get_bool("variance", false);
+  bool estimate_error = oob_prediction && command_line.get_bool("errors", false);
+  if (estimate_error && !predictor.supports_error_estimates()) {
+    throw std::runtime_error("Error estimates are not available for " + metadata.at(TYPE) + " forests.");
+  }
+
+  // The output holds the predictions, followed by the variance estimates and then the
+  // error and excess error estimates, if requested.
+  size_t num_rows = data.get_num_rows();
+  size_t prediction_length = predictor.get_prediction_length();
+  size_t num_cols = prediction_length * (estimate_variance ? 2 : 1) + (estimate_error ? 2 : 0);
+  std::vector<double> values(num_rows * num_cols);
+  double* variance = estimate_variance ? values.data() + num_rows * prediction_length : nullptr;
+  double* error = estimate_error ? values.data() + num_rows * (num_cols - 2) : nullptr;
+  double* excess_error = estimate_error ? values.data() + num_rows * (num_cols - 1) : nullptr;
+  PredictionOutput output(num_rows, prediction_length, values.data(), variance, error, excess_error);
+  std::string output_file = command_line.get_string("output");
+  std::string format = get_output_format(command_line);
+  command_line.check_all_used();
+
+  if (oob_prediction) {
+    predictor.predict_oob(forest, data, output);
+  } else {
+    predictor.predict(forest, train_data, data, output);
+  }
+  save_output(values, num_rows, num_cols, output_file, format);
+}
+
+void weights_command(const CommandLine& command_line) {
+  ForestMetadata metadata;
+  Forest forest = load_forest(command_line.get_string("forest"), metadata);
+  if (!forest.has_leaf_samples()) {
+    throw std::runtime_error("The forest does not store its leaf samples, so weights cannot be computed.");
+  }
+
+  DataFile file(command_line.get_string("data"));
+  file.advise_random();
+  Data data = file.get_data();
+  check_num_columns(metadata, data);
+  bool oob_prediction = command_line.get_bool("oob", false);
+  TreeTraverser tree_traverser(ForestOptions::validate_num_threads(command_line.get_size("num-threads", 0)));
+  std::string output_file = command_line.get_string("output");
+  std::string format = get_output_format(command_line);
+  command_line.check_all_used();
+
+  std::vector<std::vector<size_t>> leaf_nodes_by_tree = tree_traverser.get_leaf_nodes(forest, data, oob_prediction);
+  std::vector<std::vector<bool>> valid_trees_by_sample =
+      tree_traverser.get_valid_trees_by_sample(forest, data, oob_prediction);
+
+  // The weights are sparse, so they are written as (row, training row, weight) triplets.
+  SampleWeightComputer weight_computer;
+  std::vector<double> rows;
+  std::vector<double> train_rows;
+  std::vector<double> weights;
+  for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+    std::unordered_map<size_t, double> weights_by_sample = weight_computer.compute_weights(
+        sample, forest, leaf_nodes_by_tree, valid_trees_by_sample);
+    std::vector<std::pair<size_t, double>> sorted_weights(weights_by_sample.begin(), weights_by_sample.end());
+    std::sort(sorted_weights.begin(), sorted_weights.end());
+    for (const auto& weight : sorted_weights) {
+      rows.push_back(sample);
+      train_rows.push_back(weight.first);
+      weights.push_back(weight.second);
+    }
+  }
+
+  std::vector<double> values;
+  values.reserve(3 * weights.size());
+  values.insert(values.end(), rows.begin(), rows.end());
+  values.insert(values.end(), train_rows.begin(), train_rows.end());
+  values.insert(values.end(), weights.begin(), weights.end());
+  save_output(values, weights.size(), 3, output_file, format);
+}
+
+void convert_command(const CommandLine& command_line) {
+  std::string data_file = command_line.get_string("data");
+  std::string output_file = command_line.get_string("output");
+  size_t num_float_cols = command_line.get_size("float-columns", 0);
+  command_line.check_all_used();
+
+  Matrix matrix = load_matrix(data_file);
+  save_binary_matrix(matrix.first, matrix.second[0], matrix.second[1], load_column_names(data_file),
+                     num_float_cols, output_file);
+}
+
+void merge_command(const CommandLine& command_line) {
+  const std::vector<std::string>& forest_files = command_line.get_positional();
+  if (forest_files.empty()) {
+    throw std::runtime_error("No forest files to merge were given.");
+  }
+  std::string output_file = command_line.get_string("output");
+  command_line.check_all_used();
+
+  std::vector<Forest> forests;
+  ForestMetadata metadata;
+  for (const std::string& forest_file : forest_files) {
+    ForestMetadata forest_metadata;
+    Forest forest = load_forest(forest_file, forest_metadata);
+    if (forests.empty()) {
+      metadata = forest_metadata;
+    } else if (forest_metadata != metadata) {
+      throw std::runtime_error("The forest in " + forest_file + " was trained with a different type or"
+                               " different columns than the forest in " + forest_files[0] + ".");
+    }
+    forests.push_back(std::move(forest));
+  }
+
+  Forest merged = Forest::merge(forests);
+  ForestSerializer().save(merged, metadata, output_file);
+}
+
+} // namespace grf
@@ -0,0 +1,58 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_COMMANDS_H
+#define GRF_COMMANDS_H
+
+#include <set>
+#include <string>
+
+#include "CommandLine.h"
+
+namespace grf {
+
+/**
+ * The boolean options of the commands, which may be given as flags without a value.
+ */
+extern const std::set<std::string> COMMAND_FLAGS;
+
+/**
+ * The commands of the grf command line tool. Each command reads its options from the
+ * command line, and throws a std::runtime_error if they are invalid.
+ *
+ * Forests are saved by ForestSerializer together with metadata describing the forest
+ * type and the columns used in training, so that predict and merge only need the
+ * forest file. Data files may be CSV or binary matrix files (see MatrixFile.h), and
+ * binary matrix files are memory mapped rather than loaded.
+ */
+void train_command(const CommandLine& command_line);
+
+void predict_command(const CommandLine& command_line, bool oob_prediction);
+
+void weights_command(const CommandLine& command_line);
+
+void merge_command(const CommandLine& command_line);
+
+/**
+ * Converts a data file to a binary matrix file, which the other commands memory map.
+ * The leading columns given by --float-columns, e.g. the covariates, are stored as floats.
+ */
+void convert_command(const CommandLine& command_line);
+
+} // namespace grf
+
+#endif //GRF_COMMANDS_H
@@ -0,0 +1,103 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "CommandLine.h"
+#include "Commands.h"
+
+namespace {
+
+const char* const USAGE =
+    "Usage: grf <command> [options]\n"
+    "\n"
+    "Commands:\n"
+    "  train        Train a forest and save it to a file.\n"
+    "                 --data FILE --forest FILE --outcome COLUMNS [--type TYPE]\n"
+    "                 [--treatment COLUMNS] [--instrument COLUMN] [--weight COLUMN]\n"
+    "                 [--quantiles Q1,Q2,...] [--num-classes N] [--clusters FILE]\n"
+    "                 [--samples-per-cluster N] [--equalize-cluster-weights]\n"
+    "                 [--num-trees N] [--ci-group-size N] [--sample-fraction F]\n"
+    "                 [--mtry N] [--min-node-size N] [--honesty=BOOL]\n"
+    "                 [--honesty-fraction F] [--honesty-prune-leaves=BOOL]\n"
+    "                 [--alpha F] [--imbalance-penalty F] [--stabilize-splits=BOOL]\n"
+    "                 [--reduced-form-weight F] [--store-leaf-samples=BOOL]\n"
+    "                 [--num-threads N] [--seed N]\n"
+    "  predict      Predict for new data.\n"
+    "                 --forest FILE --data FILE --output FILE [--train-data FILE]\n"
+    "                 [--variance] [--format csv|binary] [--num-threads N]\n"
+    "  predict-oob  Predict out-of-bag for the training data.\n"
+    "                 --forest FILE --data FILE --output FILE [--variance] [--errors]\n"
+    "                 [--format csv|binary] [--num-threads N]\n"
+    "  weights      Write the forest weights of the training samples as\n"
+    "               (row, training row, weight) triplets.\n"
+    "                 --forest FILE --data FILE --output FILE [--oob]\n"
+    "                 [--format csv|binary] [--num-threads N]\n"
+    "  merge        Merge forests trained on the same data into one forest.\n"
+    "                 --output FILE FOREST_FILE...\n"
+    "  convert      Convert a data file to a binary matrix file, which is memory\n"
+    "               mapped instead of loaded by the other commands.\n"
+    "                 --data FILE --output FILE [--float-columns N]\n"
+    "\n"
+    "Forest types: regression (default), multi_regression, quantile, probability,\n"
+    "causal, instrumental and multi_causal. Columns are numbered from 0, and lists\n"
+    "of columns are separated by commas. Data files are CSV files, or binary matrix\n"
+    "files, which are detected automatically. A num-threads or seed of 0 means all\n"
+    "available cores, or a random seed. Boolean options may be given as --name,\n"
+    "--name BOOL or --name=BOOL.\n";
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::vector<std::string> arguments(argv + 1, argv + argc);
+  if (arguments.empty() || arguments[0] == "help" || arguments[0] == "--help") {
+    std::cout << USAGE;
+    return arguments.empty() ? 1 : 0;
+  }
+
+  std::string command = arguments[0];
+  try {
+    grf::CommandLine command_line(std::vector<std::string>(arguments.begin() + 1, arguments.end()), grf::COMMAND_FLAGS);
+    if (command != "merge" && !command_line.get_positional().empty()) {
+      throw std::runtime_error("Unexpected argument '" + command_line.get_positional()[0] + "'.");
+    }
+
+    if (command == "train") {
+      grf::train_command(command_line);
+    } else if (command == "predict") {
+      grf::predict_command(command_line, false);
+    } else if (command == "predict-oob") {
+      grf::predict_command(command_line, true);
+    } else if (command == "weights") {
+      grf::weights_command(command_line);
+    } else if (command == "merge") {
+      grf::merge_command(command_line);
+    } else if (command == "convert") {
+      grf::convert_command(command_line);
+    } else {
+      std::cerr << "grf: unknown command '" << command << "'.\n\n" << USAGE;
+      return 1;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "grf " << command << ": " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,81 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+
+#include "commons/Bitmap.h"
+
+namespace grf {
+
+Bitmap::Bitmap() {}
+
+Bitmap::Bitmap(const std::vector<size_t>& indices) {
+  if (indices.empty()) {
+    return;
+  }
+
+  size_t max_index = *std::max_element(indices.begin(), indices.end());
+  words.resize(max_index / WORD_SIZE + 1, 0);
+  for (size_t index : indices) {
+    words[index / WORD_SIZE] |= uint64_t(1) << (index % WORD_SIZE);
+  }
+}
+
+Bitmap Bitmap::from_words(const std::vector<uint64_t>& words) {
+  Bitmap bitmap;
+  bitmap.words = words;
+  // Trailing empty words are dropped so that equal sets compare equal.
+  while (!bitmap.words.empty() && bitmap.words.back() == 0) {
+    bitmap.words.pop_back();
+  }
+  return bitmap;
+}
+
+size_t Bitmap::count() const {
+  size_t count = 0;
+  for (uint64_t word : words) {
+    while (word != 0) {
+      word &= word - 1;
+      count++;
+    }
+  }
+  return count;
+}
+
+std::vector<size_t> Bitmap::get_indices() const {
+  std::vector<size_t> indices;
+  indices.reserve(count());
+  for (size_t w = 0; w < words.size(); w++) {
+    uint64_t word = words[w];
+    for (size_t bit = 0; word != 0; bit++, word >>= 1) {
+      if (word & 1) {
+        indices.push_back(w * WORD_SIZE + bit);
+      }
+    }
+  }
+  return indices;
+}
+
+const std::vector<uint64_t>& Bitmap::get_words() const {
+  return words;
+}
+
+bool Bitmap::operator==(const Bitmap& other) const {
+  return words == other.words;
+}
+
+} // namespace grf
@@ -0,0 +1,75 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_BITMAP_H
+#define GRF_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace grf {
+
+/**
+ * A set of sample IDs stored as one bit per ID, packed into 64-bit words.
+ *
+ * Compared to a sorted list of IDs, this takes 1 bit per possible sample rather than
+ * 8 bytes per member, and answers membership queries with a single bit test.
+ */
+class Bitmap {
+public:
+  Bitmap();
+
+  /**
+   * Creates a bitmap containing the given sample IDs.
+   */
+  Bitmap(const std::vector<size_t>& indices);
+
+  /**
+   * Creates a bitmap from its packed representation, as returned by get_words.
+   * Bit i of word w represents the ID 64 * w + i.
+   */
+  static Bitmap from_words(const std::vector<uint64_t>& words);
+
+  bool contains(size_t index) const {
+    size_t word = index / WORD_SIZE;
+    return word < words.size() && ((words[word] >> (index % WORD_SIZE)) & 1) != 0;
+  }
+
+  /**
+   * The number of IDs in this set.
+   */
+  size_t count() const;
+
+  /**
+   * The IDs in this set, in increasing order.
+   */
+  std::vector<size_t> get_indices() const;
+
+  const std::vector<uint64_t>& get_words() const;
+
+  bool operator==(const Bitmap& other) const;
+
+private:
+  static const size_t WORD_SIZE = 64;
+
+  std::vector<uint64_t> words;
+};
+
+} // namespace grf
+
+#endif //GRF_BITMAP_H
@@ -0,0 +1,56 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_BYTEORDER_H
+#define GRF_BYTEORDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace grf {
+
+/**
+ * Helpers for the binary file formats, which store all values in little-endian byte
+ * order regardless of the host.
+ */
+inline bool is_little_endian() {
+  const uint16_t one = 1;
+  unsigned char first_byte;
+  std::memcpy(&first_byte, &one, 1);
+  return first_byte == 1;
+}
+
+inline uint64_t byte_swap(uint64_t value) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < 8; i++) {
+    result = (result << 8) | ((value >> (8 * i)) & 0xFF);
+  }
+  return result;
+}
+
+inline uint64_t to_little_endian(uint64_t value) {
+  return is_little_endian() ? value : byte_swap(value);
+}
+
+inline uint64_t from_little_endian(uint64_t value) {
+  return to_little_endian(value);
+}
+
+} // namespace grf
+
+#endif //GRF_BYTEORDER_H
@@ -25,13 +25,89 @@
 
 namespace grf {
 
-Data::Data(const double* data_ptr, size_t num_rows, size_t num_cols) {
-  if (data_ptr == nullptr) {
+Data::Data(const double* data_ptr, size_t num_rows, size_t num_cols) :
+  Data(data_ptr, num_rows, num_cols, num_rows) {}
+
+Data::Data(const double* data_ptr, size_t num_rows, size_t num_cols, size_t column_stride) :
+  Data(nullptr, 0, 0, data_ptr, column_stride, num_rows, num_cols) {}
+
+Data::Data(const float* float_data_ptr,
+           size_t num_float_cols,
+           size_t float_column_stride,
+           const double* data_ptr,
+           size_t column_stride,
+           size_t num_rows,
+           size_t num_cols) {
+  if ((data_ptr == nullptr && (num_float_cols < num_cols || float_data_ptr == nullptr)) ||
+      (float_data_ptr == nullptr && num_float_cols > 0)) {
     throw std::runtime_error("Invalid data storage: nullptr");
   }
-  this->data_ptr = data_ptr;
+  if (num_float_cols > num_cols) {
+    throw std::runtime_error("Invalid data storage: more float columns than columns");
+  }
+  if (column_stride < num_rows || (num_float_cols > 0 && float_column_stride < num_rows)) {
+    throw std::runtime_error("Invalid data storage: column stride less than the number of rows");
+  }
+  for (size_t col = 0; col < num_float_cols; col++) {
+    float_columns.push_back(float_data_ptr + col * float_column_stride);
+  }
+  for (size_t col = num_float_cols; col < num_cols; col++) {
+    columns.push_back(data_ptr + (col - num_float_cols) * column_stride);
+  }
   this->num_rows = num_rows;
   this->num_cols = num_cols;
+  this->num_float_cols = num_float_cols;
+  this->sparse_values = nullptr;
+  this->sparse_row_indices = nullptr;
+  this->sparse_column_offsets = nullptr;
+  this->num_sparse_cols = 0;
+  this->num_leading_cols = num_float_cols;
+}
+
+Data::Data(const std::vector<const double*>& columns, size_t num_rows) :
+  Data(std::vector<const float*>(), columns, num_rows) {}
+
+Data::Data(const std::vector<const float*>& float_columns,
+           const std::vector<const double*>& columns,
+           size_t num_rows) {
+  if (std::find(columns.begin(), columns.end(), nullptr) != columns.end() ||
+      std::find(float_columns.begin(), float_columns.end(), nullptr) != float_columns.end()) {
+    throw std::runtime_error("Invalid data storage: nullptr");
+  }
+  this->columns = columns;
+  this->float_columns = float_columns;
+  this->num_rows = num_rows;
+  this->num_cols = float_columns.size() + columns.size();
+  this->num_float_cols = float_columns.size();
+  this->sparse_values = nullptr;
+  this->sparse_row_indices = nullptr;
+  this->sparse_column_offsets = nullptr;
+  this->num_sparse_cols = 0;
+  this->num_leading_cols = num_float_cols;
+}
+
+Data::Data(const double* sparse_values,
+           const int* sparse_row_indices,
+           const int* sparse_column_offsets,
+           size_t num_sparse_cols,
+           const std::vector<const double*>& columns,
+           size_t num_rows) :
+  Data(std::vector<const float*>(), columns, num_rows) {
+  if (num_sparse_cols > 0 && sparse_column_offsets == nullptr) {
+    throw std::runtime_error("Invalid data storage: nullptr");
+  }
+  // A sparse block without stored entries may come with null value and row index arrays.
+  if (num_sparse_cols > 0 && sparse_column_offsets[num_sparse_cols] > 0 &&
+      (sparse_values == nullptr || sparse_row_indices == nullptr)) {
+    throw std::runtime_error("Invalid data storage: nullptr");
+  }
+  this->sparse_values = sparse_values;
+  this->sparse_row_indices = sparse_row_indices;
+  this->sparse_column_offsets = sparse_column_offsets;
+  this->num_sparse_cols = num_sparse_cols;
+  this->num_leading_cols = num_sparse_cols;
+  this->num_cols += num_sparse_cols;
+  index_sparse_columns();
 }
 
 Data::Data(const std::vector<double>& data, size_t num_rows, size_t num_cols) :
@@ -87,13 +163,20 @@ std::vector<size_t> Data::get_all_values(std::vector<double>& all_values,
                                          std::vector<size_t>& sorted_samples,
                                          const std::vector<size_t>& samples,
                                          size_t var) const {
+  std::vector<double> sorted_values;
+  return get_all_values(all_values, sorted_samples, sorted_values, samples, var);
+}
+
+std::vector<size_t> Data::get_all_values(std::vector<double>& all_values,
+                                         std::vector<size_t>& sorted_samples,
+                                         std::vector<double>& sorted_values,
+                                         const std::vector<size_t>& samples,
+                                         size_t var) const {
   all_values.resize(samples.size());
-  for (size_t i = 0; i < samples.size(); i++) {
-    size_t sample = samples[i];
-    all_values[i] = get(sample, var);
-  }
+  gather_values(samples, var, all_values);
 
   sorted_samples.resize(samples.size());
+  sorted_values.resize(samples.size());
   std::vector<size_t> index(samples.size());
    // fill with [0, 1,..., samples.size() - 1]
   std::iota(index.begin(), index.end(), 0);
@@ -102,14 +185,29 @@ std::vector<size_t> Data::get_all_values(std::vector<double>& all_values,
   // stable sort is needed for consistent element ordering cross platform,
   // otherwise the resulting sums used in the splitting rules may compound rounding error
   // differently and produce different splits.
-  std::stable_sort(index.begin(), index.end(), [&](const size_t& lhs, const size_t& rhs) {
+  auto less = [&](const size_t& lhs, const size_t& rhs) {
     return all_values[lhs] < all_values[rhs] || (std::isnan(all_values[lhs]) && !std::isnan(all_values[rhs]));
-  });
+  };
+  if (var >= num_float_cols && var < num_leading_cols) {
+    // The zeros of a sparse column are equal, so the stable sort keeps them in sample order
+    // between the negative and positive values. Only the nonzero values need to be sorted.
+    auto zeros_begin = std::stable_partition(index.begin(), index.end(), [&](const size_t& i) {
+      return all_values[i] != 0.0;
+    });
+    std::stable_sort(index.begin(), zeros_begin, less);
+    auto positives_begin = std::find_if(index.begin(), zeros_begin, [&](const size_t& i) {
+      return all_values[i] > 0.0;
+    });
+    std::rotate(positives_begin, zeros_begin, index.end());
+  } else {
+    std::stable_sort(index.begin(), index.end(), less);
+  }
 
   for (size_t i = 0; i < samples.size(); i++) {
     sorted_samples[i] = samples[index[i]];
-    all_values[i] = get(sorted_samples[i], var);
+    sorted_values[i] = all_values[index[i]];
   }
+  all_values = sorted_values;
 
   all_values.erase(unique(all_values.begin(), all_values.end(), [&](const double& lhs, const double& rhs) {
     return lhs == rhs || (std::isnan(lhs) && std::isnan(rhs));
@@ -118,6 +216,159 @@ std::vector<size_t> Data::get_all_values(std::vector<double>& all_values,
   return index;
 }
 
+void Data::index_samples(const std::vector<size_t>& samples, std::vector<size_t>& sample_positions) const {
+  if (num_sparse_cols == 0) {
+    return;
+  }
+  sample_positions.resize(num_rows);
+  for (size_t i = 0; i < samples.size(); i++) {
+    sample_positions[samples[i]] = i;
+  }
+}
+
+std::vector<size_t> Data::get_split_values(std::vector<double>& all_values,
+                                           std::vector<double>& sorted_values,
+                                           const std::vector<size_t>& samples,
+                                           const std::vector<size_t>& sample_positions,
+                                           size_t var) const {
+  if (var >= num_float_cols && var < num_leading_cols) {
+    return get_nonzero_values(all_values, sorted_values, samples, sample_positions, var - num_float_cols);
+  }
+  std::vector<size_t> sorted_samples;
+  return get_all_values(all_values, sorted_samples, sorted_values, samples, var);
+}
+
+std::vector<size_t> Data::get_nonzero_values(std::vector<double>& all_values,
+                                             std::vector<double>& sorted_values,
+                                             const std::vector<size_t>& samples,
+                                             const std::vector<size_t>& sample_positions,
+                                             size_t sparse_col) const {
+  // Find the samples with a stored entry, either by going through the entries of the column
+  // or by looking up each sample, whichever is less work.
+  std::vector<size_t> positions;
+  std::vector<double> values;
+  int begin = sparse_column_offsets[sparse_col];
+  int end = sparse_column_offsets[sparse_col + 1];
+  if (static_cast<size_t>(end - begin) < samples.size()) {
+    for (int entry = begin; entry < end; entry++) {
+      size_t row = sparse_row_indices[entry];
+      size_t position = sample_positions[row];
+      if (position < samples.size() && samples[position] == row && sparse_values[entry] != 0.0) {
+        positions.push_back(position);
+        values.push_back(sparse_values[entry]);
+      }
+    }
+  } else {
+    for (size_t i = 0; i < samples.size(); i++) {
+      double value = get_sparse(samples[i], sparse_col);
+      if (value != 0.0) {
+        positions.push_back(i);
+        values.push_back(value);
+      }
+    }
+  }
+
+  // Sort by value with NaNs first, and by position among equal values, so that both ways of
+  // finding the samples give the same order as the stable sort in get_all_values.
+  std::vector<size_t> index(positions.size());
+  std::iota(index.begin(), index.end(), 0);
+  std::sort(index.begin(), index.end(), [&](const size_t& lhs, const size_t& rhs) {
+    double lhs_value = values[lhs];
+    double rhs_value = values[rhs];
+    if (lhs_value < rhs_value || (std::isnan(lhs_value) && !std::isnan(rhs_value))) {
+      return true;
+    }
+    if (rhs_value < lhs_value || (std::isnan(rhs_value) && !std::isnan(lhs_value))) {
+      return false;
+    }
+    return positions[lhs] < positions[rhs];
+  });
+
+  sorted_values.resize(index.size());
+  for (size_t i = 0; i < index.size(); i++) {
+    sorted_values[i] = values[index[i]];
+    index[i] = positions[index[i]];
+  }
+
+  all_values = sorted_values;
+  all_values.erase(unique(all_values.begin(), all_values.end(), [&](const double& lhs, const double& rhs) {
+    return lhs == rhs || (std::isnan(lhs) && std::isnan(rhs));
+  }), all_values.end());
+  if (index.size() < samples.size()) {
+    auto positives_begin = std::find_if(all_values.begin(), all_values.end(), [](const double& value) {
+      return value > 0.0;
+    });
+    all_values.insert(positives_begin, 0.0);
+  }
+
+  return index;
+}
+
+void Data::gather_values(const std::vector<size_t>& samples, size_t var, std::vector<double>& values) const {
+  // Check the storage type once per column, rather than for every value.
+  if (var < num_float_cols) {
+    const float* column = float_columns[var];
+    for (size_t i = 0; i < samples.size(); i++) {
+      values[i] = column[samples[i]];
+    }
+  } else if (var < num_leading_cols) {
+    for (size_t i = 0; i < samples.size(); i++) {
+      values[i] = get_sparse(samples[i], var - num_float_cols);
+    }
+  } else {
+    const double* column = columns[var - num_leading_cols];
+    for (size_t i = 0; i < samples.size(); i++) {
+      values[i] = column[samples[i]];
+    }
+  }
+}
+
+void Data::index_sparse_columns() {
+  if (num_sparse_cols > 0 && sparse_column_offsets[0] < 0) {
+    throw std::runtime_error("Invalid sparse data: negative column offset.");
+  }
+  sparse_block_starts.resize(num_sparse_cols);
+  sparse_block_shifts.resize(num_sparse_cols);
+  for (size_t col = 0; col < num_sparse_cols; col++) {
+    int begin = sparse_column_offsets[col];
+    int end = sparse_column_offsets[col + 1];
+    if (end < begin) {
+      throw std::runtime_error("Invalid sparse data: the offsets of column " + std::to_string(col) +
+                               " are decreasing.");
+    }
+    // The index and get_sparse rely on the rows of each column being in range and increasing.
+    for (int entry = begin; entry < end; entry++) {
+      int row = sparse_row_indices[entry];
+      if (row < 0 || static_cast<size_t>(row) >= num_rows) {
+        throw std::runtime_error("Invalid sparse data: row index " + std::to_string(row) +
+                                 " in column " + std::to_string(col) + " is out of range.");
+      }
+      if (entry > begin && row <= sparse_row_indices[entry - 1]) {
+        throw std::runtime_error("Invalid sparse data: the row indices of column " + std::to_string(col) +
+                                 " are not strictly increasing.");
+      }
+    }
+    size_t num_entries = end - begin;
+
+    size_t shift = 0;
+    while ((num_rows >> shift) * SPARSE_ENTRIES_PER_BLOCK > num_entries) {
+      shift++;
+    }
+    size_t num_blocks = (num_rows >> shift) + 1;
+
+    sparse_block_starts[col] = sparse_block_offsets.size();
+    sparse_block_shifts[col] = shift;
+    int entry = begin;
+    for (size_t block = 0; block < num_blocks; block++) {
+      while (entry < end && static_cast<size_t>(sparse_row_indices[entry]) < (block << shift)) {
+        entry++;
+      }
+      sparse_block_offsets.push_back(entry);
+    }
+    sparse_block_offsets.push_back(end);
+  }
+}
+
 size_t Data::get_num_cols() const {
   return num_cols;
 }
@@ -142,6 +393,14 @@ size_t Data::get_num_treatments() const {
   }
 }
 
+size_t Data::get_num_float_cols() const {
+  return num_float_cols;
+}
+
+size_t Data::get_num_sparse_cols() const {
+  return num_sparse_cols;
+}
+
 const std::set<size_t>& Data::get_disallowed_split_variables() const {
   return disallowed_split_variables;
 }
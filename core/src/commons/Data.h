@@ -18,6 +18,7 @@
 #ifndef GRF_DATA_H_
 #define GRF_DATA_H_
 
+#include <algorithm>
 #include <set>
 #include <vector>
 
@@ -34,13 +35,77 @@ namespace grf {
  * data.
  *
  * The GRF data model is a contiguous array [X, Y, z, ...] of covariates X,
- * outcomes Y, and other optional variables z.
+ * outcomes Y, and other optional variables z. The columns may also be given as
+ * a list of pointers to separately owned arrays, so that e.g. a large covariate
+ * matrix X can be used as-is with the outcomes and weights attached, instead of
+ * being copied into one array with them.
  *
+ * To halve the memory of large covariate matrices, the leading columns (typically
+ * the covariates X) may instead be stored as single-precision floats in a separate
+ * array. Their values are widened to double when read, which is exact, so split
+ * values compare the same way whether a forest is trained or predicts on float or
+ * double storage of the same values. Outcomes, weights and all sums stay in double.
+ *
+ * High-dimensional covariates with mostly zero entries may instead be stored in
+ * compressed sparse column (CSC) format, as e.g. by Eigen::SparseMatrix or R's
+ * dgCMatrix, so that their memory scales with the number of nonzero entries. Entries
+ * that are not stored are zeros (not missing values), both when training and when
+ * predicting.
  */
 class Data {
 public:
   Data(const double* data_ptr, size_t num_rows, size_t num_cols);
 
+  /**
+   * Wraps a column major array whose columns start column_stride values apart, which
+   * may be more than num_rows if the columns are padded, e.g. to page boundaries.
+   */
+  Data(const double* data_ptr, size_t num_rows, size_t num_cols, size_t column_stride);
+
+  /**
+   * Wraps data whose first num_float_cols columns are stored as floats in float_data_ptr,
+   * and whose remaining num_cols - num_float_cols columns are stored as doubles in
+   * data_ptr (which may be null if all columns are floats). Both arrays are column
+   * major, with columns starting float_column_stride and column_stride values apart.
+   */
+  Data(const float* float_data_ptr,
+       size_t num_float_cols,
+       size_t float_column_stride,
+       const double* data_ptr,
+       size_t column_stride,
+       size_t num_rows,
+       size_t num_cols);
+
+  /**
+   * Wraps columns stored in separate arrays: column j holds num_rows values starting
+   * at columns[j]. The pointers may point into one or more column major blocks.
+   */
+  Data(const std::vector<const double*>& columns, size_t num_rows);
+
+  /**
+   * Wraps columns stored in separate arrays, where the first float_columns.size()
+   * columns are stored as floats, followed by the columns stored as doubles.
+   */
+  Data(const std::vector<const float*>& float_columns,
+       const std::vector<const double*>& columns,
+       size_t num_rows);
+
+  /**
+   * Wraps data whose first num_sparse_cols columns are stored in compressed sparse column
+   * format, followed by the dense columns. The stored entries of sparse column j are
+   * sparse_values[k] in rows sparse_row_indices[k] for k from sparse_column_offsets[j] to
+   * sparse_column_offsets[j + 1] - 1, with the rows of each column in increasing order.
+   * A small index into the entries of each column is built, see SPARSE_ENTRIES_PER_BLOCK.
+   * Throws std::runtime_error if the offsets decrease, or if a row index is out of range or
+   * not greater than the previous row index of its column.
+   */
+  Data(const double* sparse_values,
+       const int* sparse_row_indices,
+       const int* sparse_column_offsets,
+       size_t num_sparse_cols,
+       const std::vector<const double*>& columns,
+       size_t num_rows);
+
   /**
    * Convenience constructors for unit test.
    * The intended use case is with storage (data vector) mananaged
@@ -88,6 +153,45 @@ public:
                                      std::vector<size_t>& sorted_samples,
                                      const std::vector<size_t>& samples, size_t var) const;
 
+  /**
+   * As above, and also fills `sorted_values` with the value of each sample in `sorted_samples`,
+   * so that the splitting rules can scan the sorted values without looking them up again.
+   */
+  std::vector<size_t> get_all_values(std::vector<double>& all_values,
+                                     std::vector<size_t>& sorted_samples,
+                                     std::vector<double>& sorted_values,
+                                     const std::vector<size_t>& samples, size_t var) const;
+
+  /**
+   * Records the position of each of `samples` in `sample_positions`, for get_split_values to look
+   * up the samples that have stored entries in a sparse variable. Does nothing if no variables
+   * are sparse. The positions of rows not in `samples` are left as they are, and are told apart
+   * by checking them against `samples`.
+   */
+  void index_samples(const std::vector<size_t>& samples, std::vector<size_t>& sample_positions) const;
+
+  /**
+   * Gets the values of `samples` at `var` in sorted order, for the splitting rules to scan.
+   *
+   * For a dense variable, this is the same as get_all_values. For a sparse variable, only the
+   * samples with a stored nonzero entry are returned, so that the cost scales with the number
+   * of stored entries of the column rather than with the number of samples. Zero is still one
+   * of `all_values` if any sample is zero, and the caller derives the statistics of those
+   * samples from the totals over all samples.
+   *
+   * @param all_values: the unique values in sorted order (filled in place).
+   * @param sorted_values: the values of the returned samples in sorted order (filled in place).
+   * @param samples: the samples to sort, which must be distinct rows.
+   * @param sample_positions: the positions filled by index_samples for `samples`.
+   * @param var: the feature variable.
+   * @return: the positions in `samples` of the returned samples, in sorted order.
+   */
+  std::vector<size_t> get_split_values(std::vector<double>& all_values,
+                                       std::vector<double>& sorted_values,
+                                       const std::vector<size_t>& samples,
+                                       const std::vector<size_t>& sample_positions,
+                                       size_t var) const;
+
   size_t get_num_cols() const;
 
   size_t get_num_rows() const;
@@ -118,10 +222,47 @@ public:
 
   double get(size_t row, size_t col) const;
 
+  size_t get_num_float_cols() const;
+
+  size_t get_num_sparse_cols() const;
+
 private:
-  const double* data_ptr;
+  void gather_values(const std::vector<size_t>& samples, size_t var, std::vector<double>& values) const;
+
+  std::vector<size_t> get_nonzero_values(std::vector<double>& all_values,
+                                         std::vector<double>& sorted_values,
+                                         const std::vector<size_t>& samples,
+                                         const std::vector<size_t>& sample_positions,
+                                         size_t sparse_col) const;
+
+  double get_sparse(size_t row, size_t sparse_col) const;
+
+  void index_sparse_columns();
+
+  /**
+   * The rows of each sparse column are divided into blocks of a power of two rows, chosen
+   * so that a block holds about this many entries on average. The entries of a row are then
+   * searched for only within its block, and the index takes memory proportional to the
+   * number of entries rather than the number of rows.
+   */
+  static const size_t SPARSE_ENTRIES_PER_BLOCK = 2;
+
+  std::vector<const double*> columns;
+  std::vector<const float*> float_columns;
   size_t num_rows;
   size_t num_cols;
+  size_t num_float_cols;
+  const double* sparse_values;
+  const int* sparse_row_indices;
+  const int* sparse_column_offsets;
+  size_t num_sparse_cols;
+  // The entries of sparse column j in block b (rows b << shift to (b + 1) << shift, where
+  // shift = sparse_block_shifts[j]) start at sparse_block_offsets[sparse_block_starts[j] + b].
+  std::vector<int> sparse_block_offsets;
+  std::vector<size_t> sparse_block_starts;
+  std::vector<size_t> sparse_block_shifts;
+  // The float columns come first, then the sparse columns, then the double columns.
+  size_t num_leading_cols;
 
   std::set<size_t> disallowed_split_variables;
   nonstd::optional<std::vector<size_t>> outcome_index;
@@ -183,7 +324,25 @@ inline bool Data::is_failure(size_t row) const {
 }
 
 inline double Data::get(size_t row, size_t col) const {
-  return data_ptr[col * num_rows + row];
+  if (col < num_leading_cols) {
+    if (col < num_float_cols) {
+      return float_columns[col][row];
+    }
+    return get_sparse(row, col - num_float_cols);
+  }
+  return columns[col - num_leading_cols][row];
+}
+
+inline double Data::get_sparse(size_t row, size_t sparse_col) const {
+  const int* block = sparse_block_offsets.data() + sparse_block_starts[sparse_col] +
+      (row >> sparse_block_shifts[sparse_col]);
+  const int* begin = sparse_row_indices + block[0];
+  const int* end = sparse_row_indices + block[1];
+  const int* entry = std::lower_bound(begin, end, static_cast<int>(row));
+  if (entry != end && static_cast<size_t>(*entry) == row) {
+    return sparse_values[entry - sparse_row_indices];
+  }
+  return 0.0;
 }
 
 } // namespace grf
@@ -0,0 +1,698 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include "commons/ByteOrder.h"
+#include "commons/MatrixFile.h"
+#include "commons/MemoryMappedFile.h"
+
+namespace grf {
+
+namespace {
+
+const char MAGIC[4] = {'G', 'R', 'F', 'M'};
+const uint32_t FORMAT_VERSION = 1;
+
+// The value types: all columns are IEEE 754 doubles, or the leading
+// columns are IEEE 754 single-precision floats and the rest doubles.
+const uint32_t FLOAT64 = 0;
+const uint32_t FLOAT32_LEADING_COLUMNS = 1;
+
+// Columns start at multiples of the page size, so that each column can be mapped,
+// paged in and advised on its own.
+const size_t PAGE_SIZE = 4096;
+
+// Files smaller than this are parsed on a single thread.
+const size_t MIN_BYTES_PER_THREAD = 1 << 20;
+
+bool is_blank(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+ * Parses the value in [begin, end), ignoring surrounding blanks. Returns false if
+ * the text is not a number.
+ */
+bool parse_value(const char* begin, const char* end, const char* file_end, double& value) {
+  while (begin < end && is_blank(*begin)) {
+    begin++;
+  }
+  while (end > begin && is_blank(*(end - 1))) {
+    end--;
+  }
+  if (begin == end || (end - begin == 2 && begin[0] == 'N' && begin[1] == 'A')) {
+    value = NAN;
+    return true;
+  }
+
+  char* parsed_end;
+  if (end < file_end) {
+    // The value is followed by a delimiter, blank or line break, where strtod stops.
+    value = std::strtod(begin, &parsed_end);
+    return parsed_end == end;
+  }
+  // The mapped file is not null-terminated, so the last value of the file is copied.
+  std::string text(begin, end);
+  value = std::strtod(text.c_str(), &parsed_end);
+  return parsed_end == text.c_str() + text.size();
+}
+
+/**
+ * Passes each field [field, field_end) of the line [begin, end) to visit, stopping early
+ * if visit returns false. Returns false if it stopped early.
+ */
+template<typename Visitor>
+bool visit_fields(const char* begin, const char* end, bool comma_separated, Visitor visit) {
+  if (comma_separated) {
+    const char* field = begin;
+    while (true) {
+      const char* field_end = std::find(field, end, ',');
+      if (!visit(field, field_end)) {
+        return false;
+      }
+      if (field_end == end) {
+        return true;
+      }
+      field = field_end + 1;
+    }
+  }
+
+  const char* field = begin;
+  while (true) {
+    while (field < end && is_blank(*field)) {
+      field++;
+    }
+    if (field == end) {
+      return true;
+    }
+    const char* field_end = field;
+    while (field_end < end && !is_blank(*field_end)) {
+      field_end++;
+    }
+    if (!visit(field, field_end)) {
+      return false;
+    }
+    field = field_end;
+  }
+}
+
+/**
+ * Parses the values of the line [begin, end), passing each to consume. Returns false
+ * if any value is not a number.
+ */
+template<typename Consumer>
+bool parse_line(const char* begin,
+                const char* end,
+                const char* file_end,
+                bool comma_separated,
+                Consumer consume) {
+  return visit_fields(begin, end, comma_separated, [&](const char* field, const char* field_end) {
+    double value;
+    if (!parse_value(field, field_end, file_end, value)) {
+      return false;
+    }
+    consume(value);
+    return true;
+  });
+}
+
+/**
+ * Whether the line [begin, end), which does not parse as numbers, is a header: none of
+ * its fields may be a number, so that a first data line with a typo is not skipped.
+ */
+bool is_header_line(const char* begin, const char* end, const char* file_end, bool comma_separated) {
+  return visit_fields(begin, end, comma_separated, [&](const char* field, const char* field_end) {
+    double value;
+    return !parse_value(field, field_end, file_end, value) || std::isnan(value);
+  });
+}
+
+const char* find_line_end(const char* begin, const char* end) {
+  const char* line_end = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+  return line_end == nullptr ? end : line_end;
+}
+
+bool is_blank_line(const char* begin, const char* end) {
+  return std::all_of(begin, end, is_blank);
+}
+
+/**
+ * A range of whole lines of a text matrix, which is parsed by one thread.
+ */
+struct TextChunk {
+  const char* begin;
+  const char* end;
+  size_t num_lines;
+  size_t num_rows;
+};
+
+void count_rows(TextChunk& chunk) {
+  chunk.num_lines = 0;
+  chunk.num_rows = 0;
+  for (const char* line = chunk.begin; line < chunk.end; ) {
+    const char* line_end = find_line_end(line, chunk.end);
+    chunk.num_lines++;
+    if (!is_blank_line(line, line_end)) {
+      chunk.num_rows++;
+    }
+    line = line_end + 1;
+  }
+}
+
+/**
+ * Parses the rows of a chunk directly into the column-major values, starting at first_row.
+ */
+void parse_chunk(const TextChunk& chunk,
+                 const char* file_end,
+                 bool comma_separated,
+                 size_t first_line_number,
+                 size_t first_row,
+                 size_t num_rows,
+                 size_t num_cols,
+                 const std::string& file_name,
+                 double* values) {
+  size_t line_number = first_line_number;
+  size_t row = first_row;
+  for (const char* line = chunk.begin; line < chunk.end; ) {
+    const char* line_end = find_line_end(line, chunk.end);
+    line_number++;
+    if (is_blank_line(line, line_end)) {
+      line = line_end + 1;
+      continue;
+    }
+
+    size_t col = 0;
+    bool parsed = parse_line(line, line_end, file_end, comma_separated, [&](double value) {
+      if (col < num_cols) {
+        values[col * num_rows + row] = value;
+      }
+      col++;
+    });
+    if (!parsed) {
+      throw std::runtime_error("Could not parse line " + std::to_string(line_number) +
+                               " of " + file_name + " as numbers.");
+    }
+    if (col != num_cols) {
+      throw std::runtime_error("Line " + std::to_string(line_number) + " of " + file_name + " has " +
+                               std::to_string(col) + " values, but expected " +
+                               std::to_string(num_cols) + ".");
+    }
+    row++;
+    line = line_end + 1;
+  }
+}
+
+/**
+ * Splits a header line into column names, trimming the blanks around each name.
+ */
+std::vector<std::string> split_header(const char* begin, const char* end, bool comma_separated) {
+  std::vector<std::string> names;
+  const char* field = begin;
+  while (field < end) {
+    while (field < end && is_blank(*field)) {
+      field++;
+    }
+    const char* field_end = comma_separated ? std::find(field, end, ',') : field;
+    while (!comma_separated && field_end < end && !is_blank(*field_end)) {
+      field_end++;
+    }
+    const char* name_end = field_end;
+    while (name_end > field && is_blank(*(name_end - 1))) {
+      name_end--;
+    }
+    if (comma_separated || name_end > field) {
+      names.push_back(std::string(field, name_end));
+    }
+    if (comma_separated && field_end == end) {
+      break;
+    }
+    field = comma_separated ? field_end + 1 : field_end;
+  }
+  return names;
+}
+
+/**
+ * The header of a binary matrix file.
+ */
+struct BinaryMatrixHeader {
+  size_t num_rows;
+  size_t num_cols;
+  size_t num_float_cols;
+  size_t column_stride;
+  size_t data_offset;
+  std::vector<std::string> column_names;
+
+  const char* get_column(const MemoryMappedFile& file, size_t col) const {
+    size_t float_bytes = std::min(col, num_float_cols) * column_stride * sizeof(float);
+    size_t double_bytes = (col - std::min(col, num_float_cols)) * column_stride * sizeof(double);
+    return file.data() + data_offset + float_bytes + double_bytes;
+  }
+};
+
+uint64_t read_uint(const MemoryMappedFile& file, size_t& offset, size_t num_bytes, const std::string& file_name) {
+  if (file.size() < offset + num_bytes) {
+    throw std::runtime_error("Invalid matrix file " + file_name + ": unexpected end of file.");
+  }
+  uint64_t value = 0;
+  for (size_t i = 0; i < num_bytes; i++) {
+    value |= static_cast<uint64_t>(static_cast<unsigned char>(file.data()[offset + i])) << (8 * i);
+  }
+  offset += num_bytes;
+  return value;
+}
+
+void write_uint(uint64_t value, size_t num_bytes, std::ostream& stream) {
+  char bytes[8];
+  for (size_t i = 0; i < num_bytes; i++) {
+    bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+  }
+  stream.write(bytes, num_bytes);
+}
+
+size_t round_up(size_t value, size_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+bool has_binary_magic(const MemoryMappedFile& file) {
+  return file.size() >= sizeof(MAGIC) && std::memcmp(file.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+BinaryMatrixHeader read_binary_header(const MemoryMappedFile& file, const std::string& file_name) {
+  if (!has_binary_magic(file)) {
+    throw std::runtime_error("Invalid matrix file " + file_name + ": unrecognized header.");
+  }
+  size_t offset = sizeof(MAGIC);
+  uint32_t version = static_cast<uint32_t>(read_uint(file, offset, 4, file_name));
+  if (version != FORMAT_VERSION) {
+    throw std::runtime_error("Unsupported matrix file version " + std::to_string(version) + ".");
+  }
+
+  BinaryMatrixHeader header;
+  header.num_rows = read_uint(file, offset, 8, file_name);
+  header.num_cols = read_uint(file, offset, 8, file_name);
+  header.num_float_cols = 0;
+  uint32_t value_type = static_cast<uint32_t>(read_uint(file, offset, 4, file_name));
+  size_t num_float_cols = read_uint(file, offset, 4, file_name);
+  if (value_type == FLOAT32_LEADING_COLUMNS && num_float_cols <= header.num_cols) {
+    header.num_float_cols = num_float_cols;
+  } else if (value_type != FLOAT64 || num_float_cols != 0) {
+    throw std::runtime_error("Unsupported value type " + std::to_string(value_type) +
+                             " in matrix file " + file_name + ".");
+  }
+  header.column_stride = read_uint(file, offset, 8, file_name);
+  header.data_offset = read_uint(file, offset, 8, file_name);
+  size_t num_name_bytes = read_uint(file, offset, 8, file_name);
+  if (file.size() - offset < num_name_bytes) {
+    throw std::runtime_error("Invalid matrix file " + file_name + ": unexpected end of file.");
+  }
+  if (num_name_bytes > 0) {
+    const char* names = file.data() + offset;
+    header.column_names = split_header(names, names + num_name_bytes, true);
+  }
+  if (!header.column_names.empty() && header.column_names.size() != header.num_cols) {
+    throw std::runtime_error("Invalid matrix file " + file_name + ": wrong number of column names.");
+  }
+  offset += num_name_bytes;
+
+  // Check that every column lies within the file, without overflowing on corrupt headers.
+  size_t num_available = header.data_offset <= file.size() ? file.size() - header.data_offset : 0;
+  bool valid = header.data_offset >= offset && header.column_stride >= header.num_rows;
+  if (valid && header.column_stride > 0) {
+    size_t num_double_cols = header.num_cols - header.num_float_cols;
+    valid = header.num_cols <= num_available / header.column_stride &&
+            (header.num_float_cols * sizeof(float) + num_double_cols * sizeof(double)) *
+                header.column_stride <= num_available;
+  }
+  if (!valid) {
+    throw std::runtime_error("Invalid matrix file " + file_name + ": the values do not fit in the file.");
+  }
+  return header;
+}
+
+} // namespace
+
+std::pair<std::vector<double>, std::vector<size_t>> load_text_matrix(const std::string& file_name) {
+  return load_text_matrix(file_name, 0);
+}
+
+std::pair<std::vector<double>, std::vector<size_t>> load_text_matrix(const std::string& file_name,
+                                                                     uint num_threads) {
+  MemoryMappedFile file(file_name);
+  file.advise_sequential();
+  const char* position = file.data();
+  const char* end = position + file.size();
+
+  // The first line decides whether values are separated by commas, and is skipped
+  // as a header if none of its fields are numbers. The first data line sets the number
+  // of columns.
+  size_t num_header_lines = 0;
+  size_t num_cols = 0;
+  bool comma_separated = false;
+  bool seen_first_line = false;
+  while (position < end) {
+    const char* line_end = find_line_end(position, end);
+    if (is_blank_line(position, line_end)) {
+      num_header_lines++;
+      position = line_end + 1;
+      continue;
+    }
+
+    if (!seen_first_line) {
+      comma_separated = std::find(position, line_end, ',') != line_end;
+    }
+    size_t num_values = 0;
+    bool parsed = parse_line(position, line_end, end, comma_separated, [&](double) { num_values++; });
+    if (parsed) {
+      num_cols = num_values;
+      break;
+    } else if (seen_first_line || !is_header_line(position, line_end, end, comma_separated)) {
+      throw std::runtime_error("Could not parse line " + std::to_string(num_header_lines + 1) +
+                               " of " + file_name + " as numbers.");
+    }
+    seen_first_line = true;
+    num_header_lines++;
+    position = line_end + 1;
+  }
+  position = std::min(position, end);
+
+  // Split the remaining lines into chunks of roughly equal size, and count the rows of
+  // each chunk in parallel, so that every thread knows where to write its rows.
+  if (num_threads == 0) {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  size_t num_bytes = end - position;
+  size_t num_chunks = std::max<size_t>(std::min<size_t>(num_threads, num_bytes / MIN_BYTES_PER_THREAD), 1);
+  std::vector<TextChunk> chunks;
+  const char* chunk_begin = position;
+  for (size_t i = 1; i <= num_chunks; i++) {
+    const char* chunk_end = i == num_chunks ? end : position + num_bytes * i / num_chunks;
+    if (chunk_end > chunk_begin && chunk_end < end) {
+      chunk_end = std::min(find_line_end(chunk_end - 1, end) + 1, end);
+    }
+    chunk_end = std::max(chunk_end, chunk_begin);
+    chunks.push_back({chunk_begin, chunk_end, 0, 0});
+    chunk_begin = chunk_end;
+  }
+
+  std::vector<std::future<void>> futures;
+  for (TextChunk& chunk : chunks) {
+    futures.push_back(std::async(std::launch::async, count_rows, std::ref(chunk)));
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+
+  size_t num_rows = 0;
+  for (const TextChunk& chunk : chunks) {
+    num_rows += chunk.num_rows;
+  }
+  std::vector<double> values(num_rows * num_cols);
+
+  futures.clear();
+  size_t line_number = num_header_lines;
+  size_t row = 0;
+  for (const TextChunk& chunk : chunks) {
+    futures.push_back(std::async(std::launch::async, parse_chunk, std::ref(chunk), end, comma_separated,
+                                 line_number, row, num_rows, num_cols, std::ref(file_name), values.data()));
+    line_number += chunk.num_lines;
+    row += chunk.num_rows;
+  }
+  // Wait for every chunk before rethrowing the first error, which is the one with the
+  // lowest line number.
+  std::exception_ptr error;
+  for (auto& future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  return std::make_pair(std::move(values), std::vector<size_t>({num_rows, num_cols}));
+}
+
+std::pair<std::vector<double>, std::vector<size_t>> load_binary_matrix(const std::string& file_name) {
+  MemoryMappedFile file(file_name);
+  file.advise_sequential();
+  BinaryMatrixHeader header = read_binary_header(file, file_name);
+
+  size_t num_rows = header.num_rows;
+  std::vector<double> values(num_rows * header.num_cols);
+  for (size_t col = 0; col < header.num_cols; col++) {
+    const char* column = header.get_column(file, col);
+    if (col < header.num_float_cols) {
+      for (size_t row = 0; row < num_rows; row++) {
+        uint32_t bits = 0;
+        for (size_t i = 0; i < sizeof(bits); i++) {
+          bits |= static_cast<uint32_t>(static_cast<unsigned char>(column[row * sizeof(float) + i])) << (8 * i);
+        }
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        values[col * num_rows + row] = value;
+      }
+    } else if (is_little_endian()) {
+      std::memcpy(values.data() + col * num_rows, column, num_rows * sizeof(double));
+    } else {
+      for (size_t row = 0; row < num_rows; row++) {
+        uint64_t bits;
+        std::memcpy(&bits, column + row * sizeof(double), sizeof(bits));
+        bits = from_little_endian(bits);
+        std::memcpy(&values[col * num_rows + row], &bits, sizeof(bits));
+      }
+    }
+  }
+  return std::make_pair(std::move(values), std::vector<size_t>({num_rows, header.num_cols}));
+}
+
+std::pair<std::vector<double>, std::vector<size_t>> load_matrix(const std::string& file_name) {
+  return is_binary_matrix(file_name) ? load_binary_matrix(file_name) : load_text_matrix(file_name);
+}
+
+bool is_binary_matrix(const std::string& file_name) {
+  MemoryMappedFile file(file_name);
+  return has_binary_magic(file);
+}
+
+std::vector<std::string> load_column_names(const std::string& file_name) {
+  MemoryMappedFile file(file_name);
+  if (has_binary_magic(file)) {
+    return read_binary_header(file, file_name).column_names;
+  }
+
+  const char* end = file.data() + file.size();
+  for (const char* line = file.data(); line < end; ) {
+    const char* line_end = find_line_end(line, end);
+    if (is_blank_line(line, line_end)) {
+      line = line_end + 1;
+      continue;
+    }
+    bool comma_separated = std::find(line, line_end, ',') != line_end;
+    if (parse_line(line, line_end, end, comma_separated, [](double) {}) ||
+        !is_header_line(line, line_end, end, comma_separated)) {
+      return std::vector<std::string>();
+    }
+    return split_header(line, line_end, comma_separated);
+  }
+  return std::vector<std::string>();
+}
+
+void save_text_matrix(const std::vector<double>& values,
+                      size_t num_rows,
+                      size_t num_cols,
+                      const std::string& file_name) {
+  std::ofstream file(file_name, std::ios::binary);
+  if (!file.good()) {
+    throw std::runtime_error("Could not open output file " + file_name + ".");
+  }
+
+  std::string line;
+  char buffer[32];
+  for (size_t r = 0; r < num_rows; r++) {
+    line.clear();
+    for (size_t c = 0; c < num_cols; c++) {
+      double value = values[c * num_rows + r];
+      if (c > 0) {
+        line += ',';
+      }
+      if (std::isnan(value)) {
+        line += "NA";
+      } else {
+        int length = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+        line.append(buffer, length);
+      }
+    }
+    line += '\n';
+    file.write(line.data(), line.size());
+  }
+
+  if (!file.good()) {
+    throw std::runtime_error("Failed to write output file " + file_name + ".");
+  }
+}
+
+void save_binary_matrix(const std::vector<double>& values,
+                        size_t num_rows,
+                        size_t num_cols,
+                        const std::string& file_name) {
+  save_binary_matrix(values, num_rows, num_cols, std::vector<std::string>(), file_name);
+}
+
+void save_binary_matrix(const std::vector<double>& values,
+                        size_t num_rows,
+                        size_t num_cols,
+                        const std::vector<std::string>& column_names,
+                        const std::string& file_name) {
+  save_binary_matrix(values, num_rows, num_cols, column_names, 0, file_name);
+}
+
+void save_binary_matrix(const std::vector<double>& values,
+                        size_t num_rows,
+                        size_t num_cols,
+                        const std::vector<std::string>& column_names,
+                        size_t num_float_cols,
+                        const std::string& file_name) {
+  if (num_float_cols > num_cols) {
+    throw std::runtime_error("The number of float columns exceeds the number of columns.");
+  }
+  std::string names;
+  if (!column_names.empty()) {
+    if (column_names.size() != num_cols) {
+      throw std::runtime_error("Expected " + std::to_string(num_cols) + " column names, but got " +
+                               std::to_string(column_names.size()) + ".");
+    }
+    for (size_t col = 0; col < num_cols; col++) {
+      if (column_names[col].find_first_of(",\n") != std::string::npos) {
+        throw std::runtime_error("Column names cannot contain commas or line breaks.");
+      }
+      names += (col > 0 ? "," : "") + column_names[col];
+    }
+  }
+
+  std::ofstream file(file_name, std::ios::binary);
+  if (!file.good()) {
+    throw std::runtime_error("Could not open output file " + file_name + ".");
+  }
+
+  size_t header_size = sizeof(MAGIC) + 4 + 8 + 8 + 4 + 4 + 8 + 8 + 8 + names.size();
+  size_t data_offset = round_up(header_size, PAGE_SIZE);
+  size_t column_stride = round_up(num_rows, PAGE_SIZE / (num_float_cols > 0 ? sizeof(float) : sizeof(double)));
+
+  file.write(MAGIC, sizeof(MAGIC));
+  write_uint(FORMAT_VERSION, 4, file);
+  write_uint(num_rows, 8, file);
+  write_uint(num_cols, 8, file);
+  write_uint(num_float_cols > 0 ? FLOAT32_LEADING_COLUMNS : FLOAT64, 4, file);
+  write_uint(num_float_cols, 4, file);
+  write_uint(column_stride, 8, file);
+  write_uint(data_offset, 8, file);
+  write_uint(names.size(), 8, file);
+  file.write(names.data(), names.size());
+  std::vector<char> padding(std::max(data_offset - header_size,
+                                     (column_stride - num_rows) * sizeof(double)), 0);
+  file.write(padding.data(), data_offset - header_size);
+
+  for (size_t col = 0; col < num_cols; col++) {
+    const double* column = values.data() + col * num_rows;
+    if (col < num_float_cols) {
+      for (size_t row = 0; row < num_rows; row++) {
+        float value = static_cast<float>(column[row]);
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        write_uint(bits, 4, file);
+      }
+      file.write(padding.data(), (column_stride - num_rows) * sizeof(float));
+      continue;
+    } else if (is_little_endian()) {
+      file.write(reinterpret_cast<const char*>(column), num_rows * sizeof(double));
+    } else {
+      for (size_t row = 0; row < num_rows; row++) {
+        uint64_t bits;
+        std::memcpy(&bits, &column[row], sizeof(bits));
+        write_uint(bits, 8, file);
+      }
+    }
+    file.write(padding.data(), (column_stride - num_rows) * sizeof(double));
+  }
+
+  if (!file.good()) {
+    throw std::runtime_error("Failed to write output file " + file_name + ".");
+  }
+}
+
+MappedMatrix::MappedMatrix(const std::string& file_name) :
+    file(file_name) {
+  if (!is_little_endian()) {
+    throw std::runtime_error("Binary matrix files can only be memory mapped on little-endian hosts.");
+  }
+  BinaryMatrixHeader header = read_binary_header(file, file_name);
+  num_rows = header.num_rows;
+  num_cols = header.num_cols;
+  column_stride = header.column_stride;
+  num_float_cols = header.num_float_cols;
+  column_names = header.column_names;
+  float_values = reinterpret_cast<const float*>(header.get_column(file, 0));
+  values = reinterpret_cast<const double*>(header.get_column(file, num_float_cols));
+  if (reinterpret_cast<uintptr_t>(values) % alignof(double) != 0) {
+    throw std::runtime_error("Invalid matrix file " + file_name + ": the values are not aligned.");
+  }
+}
+
+Data MappedMatrix::get_data() const {
+  return Data(float_values, num_float_cols, column_stride, values, column_stride, num_rows, num_cols);
+}
+
+size_t MappedMatrix::get_num_rows() const {
+  return num_rows;
+}
+
+size_t MappedMatrix::get_num_cols() const {
+  return num_cols;
+}
+
+size_t MappedMatrix::get_num_float_cols() const {
+  return num_float_cols;
+}
+
+const std::vector<std::string>& MappedMatrix::get_column_names() const {
+  return column_names;
+}
+
+void MappedMatrix::advise_sequential() const {
+  file.advise_sequential();
+}
+
+void MappedMatrix::advise_random() const {
+  file.advise_random();
+}
+
+} // namespace grf
@@ -0,0 +1,163 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_MATRIXFILE_H
+#define GRF_MATRIXFILE_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Data.h"
+#include "MemoryMappedFile.h"
+#include "globals.h"
+
+namespace grf {
+
+/**
+ * Reading and writing dense matrices of doubles, in the column-major layout used by Data.
+ * As with load_data, a matrix is returned as its values together with {num_rows, num_cols},
+ * so it can be passed to the Data constructor directly.
+ *
+ * Two file formats are supported:
+ *
+ * - Text files with one row per line, whose values are separated by commas or by
+ *   whitespace. Spaces around values are ignored, empty values and "NA" are read as
+ *   missing (NaN), and a first line none of whose values are numbers is skipped as a header.
+ *
+ * - Binary matrix files, laid out so that they can be memory mapped as Data (see MappedMatrix):
+ *
+ *     magic "GRFM", uint32 format version (1),
+ *     uint64 num_rows, uint64 num_cols,
+ *     uint32 value type, uint32 num_float_cols,
+ *     uint64 column_stride, uint64 data_offset,
+ *     uint64 num_name_bytes, column names [num_name_bytes],
+ *     zero padding up to data_offset,
+ *     num_cols columns, each of num_rows values followed by zero padding up to column_stride values.
+ *
+ *   With value type 0 all values are IEEE 754 doubles and num_float_cols is 0. With
+ *   value type 1 the first num_float_cols columns, typically the covariates, are stored
+ *   as IEEE 754 single-precision floats to halve their size, and the rest as doubles.
+ *
+ *   The column names are separated by commas, and are omitted if num_name_bytes is 0.
+ *   data_offset and column_stride are chosen so that every column starts on a 4096-byte
+ *   page boundary. All integers and values are little-endian.
+ */
+std::pair<std::vector<double>, std::vector<size_t>> load_text_matrix(const std::string& file_name);
+
+/**
+ * Text files are memory mapped and split into chunks of whole lines, which are parsed
+ * on num_threads threads (0 uses all cores) directly into the column-major values.
+ */
+std::pair<std::vector<double>, std::vector<size_t>> load_text_matrix(const std::string& file_name,
+                                                                     uint num_threads);
+
+std::pair<std::vector<double>, std::vector<size_t>> load_binary_matrix(const std::string& file_name);
+
+/**
+ * Loads a binary matrix file if the file starts with the binary magic, and a text file otherwise.
+ */
+std::pair<std::vector<double>, std::vector<size_t>> load_matrix(const std::string& file_name);
+
+bool is_binary_matrix(const std::string& file_name);
+
+/**
+ * The column names stored in a binary matrix file, or the header of a text file.
+ * Returns an empty vector if the file has no column names.
+ */
+std::vector<std::string> load_column_names(const std::string& file_name);
+
+void save_text_matrix(const std::vector<double>& values,
+                      size_t num_rows,
+                      size_t num_cols,
+                      const std::string& file_name);
+
+void save_binary_matrix(const std::vector<double>& values,
+                        size_t num_rows,
+                        size_t num_cols,
+                        const std::string& file_name);
+
+void save_binary_matrix(const std::vector<double>& values,
+                        size_t num_rows,
+                        size_t num_cols,
+                        const std::vector<std::string>& column_names,
+                        const std::string& file_name);
+
+/**
+ * Saves the first num_float_cols columns as single-precision floats, rounding their values.
+ */
+void save_binary_matrix(const std::vector<double>& values,
+                        size_t num_rows,
+                        size_t num_cols,
+                        const std::vector<std::string>& column_names,
+                        size_t num_float_cols,
+                        const std::string& file_name);
+
+/**
+ * A binary matrix file mapped read-only into memory, whose Data reads the values in
+ * place. Nothing is copied into the process heap, and the file's pages are shared
+ * through the page cache by every process that maps it, e.g. several forest jobs
+ * training on the same data. The mapping must outlive the Data it returns.
+ *
+ * Mapping is only supported on little-endian hosts, elsewhere use load_binary_matrix.
+ */
+class MappedMatrix {
+public:
+  MappedMatrix(const std::string& file_name);
+
+  Data get_data() const;
+
+  size_t get_num_rows() const;
+
+  size_t get_num_cols() const;
+
+  /**
+   * The number of leading columns stored as floats, which Data reads without widening
+   * the file's values in memory.
+   */
+  size_t get_num_float_cols() const;
+
+  const std::vector<std::string>& get_column_names() const;
+
+  /**
+   * Hints that the values will be scanned in order, e.g. while validating the outcome
+   * columns before training, so the operating system reads ahead.
+   */
+  void advise_sequential() const;
+
+  /**
+   * Hints that the values will be read in no particular order, e.g. while growing
+   * trees on subsamples, so pages are read on demand without read-ahead.
+   */
+  void advise_random() const;
+
+private:
+  MemoryMappedFile file;
+  const float* float_values;
+  const double* values;
+  size_t num_rows;
+  size_t num_cols;
+  size_t num_float_cols;
+  size_t column_stride;
+  std::vector<std::string> column_names;
+
+  DISALLOW_COPY_AND_ASSIGN(MappedMatrix);
+};
+
+} // namespace grf
+
+#endif //GRF_MATRIXFILE_H
@@ -0,0 +1,139 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MemoryMappedFile.h"
+
+namespace grf {
+
+#ifdef _WIN32
+
+MemoryMappedFile::MemoryMappedFile(const std::string& file_name) :
+    mapped_data(nullptr), mapped_size(0), file_handle(nullptr), mapping_handle(nullptr) {
+  HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("Could not open file " + file_name + ".");
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    throw std::runtime_error("Could not determine the size of file " + file_name + ".");
+  }
+  file_handle = file;
+  mapped_size = static_cast<size_t>(file_size.QuadPart);
+  if (mapped_size == 0) {
+    return;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    CloseHandle(file);
+    throw std::runtime_error("Could not memory map file " + file_name + ".");
+  }
+  mapping_handle = mapping;
+  mapped_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  if (mapped_data == nullptr) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    throw std::runtime_error("Could not memory map file " + file_name + ".");
+  }
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+  if (mapped_data != nullptr) {
+    UnmapViewOfFile(mapped_data);
+  }
+  if (mapping_handle != nullptr) {
+    CloseHandle(mapping_handle);
+  }
+  if (file_handle != nullptr) {
+    CloseHandle(file_handle);
+  }
+}
+
+void MemoryMappedFile::advise_sequential() const {}
+
+void MemoryMappedFile::advise_random() const {}
+
+#else
+
+MemoryMappedFile::MemoryMappedFile(const std::string& file_name) :
+    mapped_data(nullptr), mapped_size(0) {
+  int file_descriptor = open(file_name.c_str(), O_RDONLY);
+  if (file_descriptor < 0) {
+    throw std::runtime_error("Could not open file " + file_name + ".");
+  }
+  struct stat file_status;
+  if (fstat(file_descriptor, &file_status) != 0) {
+    close(file_descriptor);
+    throw std::runtime_error("Could not determine the size of file " + file_name + ".");
+  }
+  mapped_size = static_cast<size_t>(file_status.st_size);
+  if (mapped_size == 0) {
+    close(file_descriptor);
+    return;
+  }
+
+  void* mapping = mmap(nullptr, mapped_size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+  // The mapping stays valid after the descriptor is closed.
+  close(file_descriptor);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error("Could not memory map file " + file_name + ".");
+  }
+  mapped_data = static_cast<const char*>(mapping);
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+  if (mapped_data != nullptr) {
+    munmap(const_cast<char*>(mapped_data), mapped_size);
+  }
+}
+
+void MemoryMappedFile::advise_sequential() const {
+  if (mapped_data != nullptr) {
+    madvise(const_cast<char*>(mapped_data), mapped_size, MADV_SEQUENTIAL);
+  }
+}
+
+void MemoryMappedFile::advise_random() const {
+  if (mapped_data != nullptr) {
+    madvise(const_cast<char*>(mapped_data), mapped_size, MADV_RANDOM);
+  }
+}
+
+#endif
+
+const char* MemoryMappedFile::data() const {
+  return mapped_data;
+}
+
+size_t MemoryMappedFile::size() const {
+  return mapped_size;
+}
+
+} // namespace grf
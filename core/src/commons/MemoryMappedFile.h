@@ -0,0 +1,68 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_MEMORYMAPPEDFILE_H
+#define GRF_MEMORYMAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+#include "globals.h"
+
+namespace grf {
+
+/**
+ * A read-only memory mapping of a file. The mapping is shared with the operating
+ * system's page cache, so several processes mapping the same file share one physical
+ * copy of its contents. The file is unmapped when this object is destroyed.
+ */
+class MemoryMappedFile {
+public:
+  MemoryMappedFile(const std::string& file_name);
+
+  ~MemoryMappedFile();
+
+  const char* data() const;
+
+  size_t size() const;
+
+  /**
+   * Hints that the mapping will be read front to back (e.g. while loading),
+   * so the operating system can read ahead aggressively.
+   */
+  void advise_sequential() const;
+
+  /**
+   * Hints that the mapping will be read in no particular order (e.g. while
+   * looking up individual rows), so the operating system should not read ahead.
+   */
+  void advise_random() const;
+
+private:
+  const char* mapped_data;
+  size_t mapped_size;
+#ifdef _WIN32
+  void* file_handle;
+  void* mapping_handle;
+#endif
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryMappedFile);
+};
+
+} // namespace grf
+
+#endif //GRF_MEMORYMAPPEDFILE_H
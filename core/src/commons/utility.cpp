@@ -15,11 +15,8 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
-#include <iostream>
-#include <fstream>
-#include <stdexcept>
-
 #include "utility.h"
+#include "MatrixFile.h"
 
 namespace grf {
 
@@ -66,63 +63,7 @@ bool equal_doubles(double first, double second, double epsilon) {
 }
 
 std::pair<std::vector<double>, std::vector<size_t>> load_data(const std::string& file_name) {
-  size_t num_rows = 0;
-  size_t num_cols = 0;
-
-  // Open input file
-  std::ifstream input_file;
-  input_file.open(file_name);
-  if (!input_file.good()) {
-    throw std::runtime_error("Could not open input file.");
-  }
-
-  // Count number of rows
-  size_t line_count = 0;
-  std::string line;
-  std::string first_line;
-  while (getline(input_file, line)) {
-    if (line_count == 0) {
-      first_line = line;
-    }
-    ++line_count;
-  }
-
-  num_rows = line_count;
-  input_file.close();
-  input_file.open(file_name);
-
-  // Read the first line to determine the number of columns.
-  std::string dummy_token;
-  std::stringstream first_line_stream(first_line);
-  while (first_line_stream >> dummy_token) {
-    num_cols++;
-  }
-
-  // Read the entire contents.
-  std::vector<double> storage(num_rows * num_cols);
-  line.clear();
-  size_t row = 0;
-  while (getline(input_file, line)) {
-    std::string token;
-    std::stringstream line_stream(line);
-    size_t column = 0;
-    while (line_stream >> token) {
-      storage.at(column * num_rows + row) = std::stod(token);
-      ++column;
-    }
-    if (column > num_cols) {
-      throw std::runtime_error("Could not open input file. Too many columns in a row.");
-    } else if (column < num_cols) {
-      throw std::runtime_error("Could not open input file. Too few columns in a row. Are all values numeric?");
-    }
-    ++row;
-  }
-  num_rows = row;
-  input_file.close();
-
-  std::vector<size_t> dim {num_rows, num_cols};
-
-  return std::make_pair(storage, dim);
+  return load_text_matrix(file_name);
 }
 
 void set_data(std::pair<std::vector<double>, std::vector<size_t>>& data, size_t row, size_t col, double value) {
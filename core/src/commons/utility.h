@@ -38,7 +38,7 @@ void split_sequence(std::vector<uint>& result, uint start, uint end, uint num_pa
 bool equal_doubles(double first, double second, double epsilon);
 
 /**
- * Load a whitespace delimited file into a std::vector<double>.
+ * Load a whitespace or comma delimited file into a std::vector<double>, see load_text_matrix.
  * The number of rows and columns are the second item in the returned pair.
  */
 std::pair<std::vector<double>, std::vector<size_t>> load_data(const std::string& file_name);
@@ -41,22 +41,52 @@ Forest::Forest(Forest&& forest) {
 }
 
 Forest Forest::merge(std::vector<Forest>& forests) {
-  std::vector<std::unique_ptr<Tree>> all_trees;
   const size_t num_variables = forests.at(0).get_num_variables();
   const size_t ci_group_size = forests.at(0).get_ci_group_size();
 
+  // Validate every forest before moving any trees, so a failed merge leaves the inputs intact.
+  size_t num_trees = 0;
+  for (const auto& forest : forests) {
+    if (forest.get_ci_group_size() != ci_group_size) {
+      throw std::runtime_error("All forests being merged must have the same ci_group_size.");
+    }
+    if (forest.get_num_variables() != num_variables) {
+      throw std::runtime_error("All forests being merged must have the same num_variables.");
+    }
+    num_trees += forest.get_trees().size();
+  }
+
+  std::vector<std::unique_ptr<Tree>> all_trees;
+  all_trees.reserve(num_trees);
   for (auto& forest : forests) {
     auto& trees = forest.get_trees_();
     all_trees.insert(all_trees.end(),
                      std::make_move_iterator(trees.begin()),
                      std::make_move_iterator(trees.end()));
+  }
 
-    if (forest.get_ci_group_size() != ci_group_size) {
-      throw std::runtime_error("All forests being merged must have the same ci_group_size.");
+  return Forest(all_trees, num_variables, ci_group_size);
+}
+
+void Forest::drop_leaf_samples() {
+  for (const auto& tree : trees) {
+    if (tree->get_prediction_values().get_num_nodes() == 0) {
+      throw std::runtime_error("Leaf samples can only be dropped from forests with precomputed prediction values.");
     }
   }
 
-  return Forest(all_trees, num_variables, ci_group_size);
+  for (auto& tree : trees) {
+    tree->drop_leaf_samples();
+  }
+}
+
+bool Forest::has_leaf_samples() const {
+  for (const auto& tree : trees) {
+    if (!tree->has_leaf_samples()) {
+      return false;
+    }
+  }
+  return true;
 }
 
 const std::vector<std::unique_ptr<Tree>>& Forest::get_trees() const {
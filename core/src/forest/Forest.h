@@ -54,6 +54,20 @@ public:
    */
   static Forest merge(std::vector<Forest>& forests);
 
+  /**
+   * Drops the leaf samples of every tree, which make up most of a trained forest's
+   * size. The forest can then only predict through an optimized prediction strategy,
+   * and computing sample weights or using a default prediction strategy will fail.
+   *
+   * The trees must have been trained with precomputed prediction values.
+   */
+  void drop_leaf_samples();
+
+  /**
+   * Whether all trees in this forest still hold their leaf samples.
+   */
+  bool has_leaf_samples() const;
+
 private:
   std::vector<std::unique_ptr<Tree>> trees;
   size_t num_variables;
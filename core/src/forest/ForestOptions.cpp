@@ -37,11 +37,13 @@ ForestOptions::ForestOptions(uint num_trees,
                              uint num_threads,
                              uint random_seed,
                              const std::vector<size_t>& sample_clusters,
-                             uint samples_per_cluster):
+                             uint samples_per_cluster,
+                             bool store_leaf_samples):
     ci_group_size(ci_group_size),
     sample_fraction(sample_fraction),
     tree_options(mtry, min_node_size, honesty, honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty),
-    sampling_options(samples_per_cluster, sample_clusters) {
+    sampling_options(samples_per_cluster, sample_clusters),
+    store_leaf_samples(store_leaf_samples) {
 
   this->num_threads = validate_num_threads(num_threads);
 
@@ -90,6 +92,10 @@ uint ForestOptions::get_random_seed() const {
   return random_seed;
 }
 
+bool ForestOptions::get_store_leaf_samples() const {
+  return store_leaf_samples;
+}
+
 uint ForestOptions::validate_num_threads(uint num_threads) {
   if (num_threads == DEFAULT_NUM_THREADS) {
     return std::thread::hardware_concurrency();
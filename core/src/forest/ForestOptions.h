@@ -40,7 +40,8 @@ public:
                 uint num_threads,
                 uint random_seed,
                 const std::vector<size_t>& sample_clusters,
-                uint samples_per_cluster);
+                uint samples_per_cluster,
+                bool store_leaf_samples = true);
 
   static uint validate_num_threads(uint num_threads);
 
@@ -54,6 +55,14 @@ public:
   uint get_num_threads() const;
   uint get_random_seed() const;
 
+  /**
+   * Whether trained trees keep the samples in each of their leaves. Forests that
+   * precompute prediction values can be trained without them, which makes them much
+   * smaller, but they then cannot compute forest weights or use prediction
+   * strategies that work from the leaf samples.
+   */
+  bool get_store_leaf_samples() const;
+
 private:
   uint num_trees;
   size_t ci_group_size;
@@ -64,6 +73,7 @@ private:
 
   uint num_threads;
   uint random_seed;
+  bool store_leaf_samples;
 };
 
 } // namespace grf
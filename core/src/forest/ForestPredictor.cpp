@@ -24,6 +24,8 @@
 
 namespace grf {
 
+const size_t ForestPredictor::MAX_MICRO_BATCH_SIZE = 64;
+
 ForestPredictor::ForestPredictor(uint num_threads,
                                  std::unique_ptr<DefaultPredictionStrategy> strategy) :
     tree_traverser(num_threads) {
@@ -52,22 +54,94 @@ std::vector<Prediction> ForestPredictor::predict_oob(const Forest& forest,
   return predict(forest, data, data, estimate_variance, true);
 }
 
+void ForestPredictor::predict(const Forest& forest,
+                              const Data& train_data,
+                              const Data& data,
+                              PredictionOutput& output) const {
+  predict(forest, train_data, data, output, false);
+}
+
+void ForestPredictor::predict_oob(const Forest& forest,
+                                  const Data& data,
+                                  PredictionOutput& output) const {
+  predict(forest, data, data, output, true);
+}
+
+void ForestPredictor::predict_micro_batch(const Forest& forest,
+                                          const Data& train_data,
+                                          const Data& data,
+                                          PredictionOutput& output,
+                                          PredictionScratch& scratch) const {
+  if (data.get_num_rows() > MAX_MICRO_BATCH_SIZE) {
+    predict(forest, train_data, data, output, false);
+    return;
+  }
+
+  validate_output(forest, data, output, false);
+  prediction_collector->collect_predictions_direct(forest, train_data, data, output, scratch);
+}
+
+size_t ForestPredictor::get_prediction_length() const {
+  return prediction_collector->get_prediction_length();
+}
+
+bool ForestPredictor::supports_error_estimates() const {
+  return prediction_collector->supports_error_estimates();
+}
+
 std::vector<Prediction> ForestPredictor::predict(const Forest& forest,
                                                  const Data& train_data,
                                                  const Data& data,
                                                  bool estimate_variance,
                                                  bool oob_prediction) const {
-  if (estimate_variance && forest.get_ci_group_size() <= 1) {
-    throw std::runtime_error("To estimate variance during prediction, the forest must"
-       " be trained with ci_group_size greater than 1.");
-  }
+  size_t num_samples = data.get_num_rows();
+  size_t prediction_length = get_prediction_length();
+  bool estimate_error = oob_prediction && supports_error_estimates();
+
+  std::vector<double> predictions(num_samples * prediction_length);
+  std::vector<double> variance_estimates(estimate_variance ? num_samples * prediction_length : 0);
+  std::vector<double> error_estimates(estimate_error ? num_samples : 0);
+  std::vector<double> excess_error_estimates(estimate_error ? num_samples : 0);
+
+  PredictionOutput output(num_samples, prediction_length,
+                          predictions.data(),
+                          estimate_variance ? variance_estimates.data() : nullptr,
+                          estimate_error ? error_estimates.data() : nullptr,
+                          estimate_error ? excess_error_estimates.data() : nullptr);
+  predict(forest, train_data, data, output, oob_prediction);
+  return output.to_predictions();
+}
+
+void ForestPredictor::predict(const Forest& forest,
+                              const Data& train_data,
+                              const Data& data,
+                              PredictionOutput& output,
+                              bool oob_prediction) const {
+  validate_output(forest, data, output, oob_prediction);
 
   std::vector<std::vector<size_t>> leaf_nodes_by_tree = tree_traverser.get_leaf_nodes(forest, data, oob_prediction);
   std::vector<std::vector<bool>> trees_by_sample = tree_traverser.get_valid_trees_by_sample(forest, data, oob_prediction);
 
-  return prediction_collector->collect_predictions(forest, train_data, data,
-      leaf_nodes_by_tree, trees_by_sample,
-      estimate_variance, oob_prediction);
+  prediction_collector->collect_predictions(forest, train_data, data,
+      leaf_nodes_by_tree, trees_by_sample, output);
+}
+
+void ForestPredictor::validate_output(const Forest& forest,
+                                      const Data& data,
+                                      const PredictionOutput& output,
+                                      bool oob_prediction) const {
+  if (output.get_num_samples() != data.get_num_rows() ||
+      output.get_prediction_length() != get_prediction_length()) {
+    throw std::runtime_error("The prediction output buffers do not match the data and prediction length.");
+  }
+  if (output.has_variance_estimates() && forest.get_ci_group_size() <= 1) {
+    throw std::runtime_error("To estimate variance during prediction, the forest must"
+       " be trained with ci_group_size greater than 1.");
+  }
+  if (output.has_error_estimates() && !(oob_prediction && supports_error_estimates())) {
+    throw std::runtime_error("Error estimates are only available for out-of-bag prediction"
+       " with an optimized prediction strategy.");
+  }
 }
 
 } // namespace grf
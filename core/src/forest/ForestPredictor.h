@@ -21,8 +21,10 @@
 #include "relabeling/RelabelingStrategy.h"
 #include "splitting/SplittingRule.h"
 #include "prediction/Prediction.h"
+#include "prediction/PredictionOutput.h"
 #include "prediction/collector/TreeTraverser.h"
 #include "prediction/collector/PredictionCollector.h"
+#include "prediction/collector/PredictionScratch.h"
 #include "prediction/collector/SampleWeightComputer.h"
 #include "prediction/OptimizedPredictionStrategy.h"
 #include "prediction/DefaultPredictionStrategy.h"
@@ -54,7 +56,61 @@ public:
                                       const Data& data,
                                       bool estimate_variance) const;
 
+  /**
+   * Writes predictions for every sample in data directly into the caller's buffers.
+   * Variance estimates are computed if output has a variance buffer. Error estimates
+   * are only available for out-of-bag prediction, so output must not request them.
+   */
+  void predict(const Forest& forest,
+               const Data& train_data,
+               const Data& data,
+               PredictionOutput& output) const;
+
+  /**
+   * Writes out-of-bag predictions into the caller's buffers. Error estimates may be
+   * requested if supports_error_estimates() is true.
+   */
+  void predict_oob(const Forest& forest,
+                   const Data& data,
+                   PredictionOutput& output) const;
+
+  /**
+   * Predicts for a handful of samples with low latency, e.g. when scoring requests
+   * online. Each sample is routed through the trees and aggregated directly on the
+   * calling thread, using buffers from the caller-owned scratch, instead of first
+   * traversing the trees for the whole batch on worker threads. Batches of more than
+   * MAX_MICRO_BATCH_SIZE samples are passed on to the multi-threaded predict.
+   *
+   * As with predict, variance estimates are computed if output has a variance buffer,
+   * and error estimates cannot be requested.
+   */
+  void predict_micro_batch(const Forest& forest,
+                           const Data& train_data,
+                           const Data& data,
+                           PredictionOutput& output,
+                           PredictionScratch& scratch) const;
+
+  static const size_t MAX_MICRO_BATCH_SIZE;
+
+  /**
+   * The number of prediction columns written for each sample.
+   */
+  size_t get_prediction_length() const;
+
+  bool supports_error_estimates() const;
+
 private:
+  void validate_output(const Forest& forest,
+                       const Data& data,
+                       const PredictionOutput& output,
+                       bool oob_prediction) const;
+
+  void predict(const Forest& forest,
+               const Data& train_data,
+               const Data& data,
+               PredictionOutput& output,
+               bool oob_prediction) const;
+
   std::vector<Prediction> predict(const Forest& forest,
                                   const Data& train_data,
                                   const Data& data,
@@ -0,0 +1,453 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include "commons/ByteOrder.h"
+#include "forest/ForestSerializer.h"
+
+namespace grf {
+
+const uint32_t ForestSerializer::FORMAT_VERSION = 1;
+
+namespace {
+
+const char MAGIC[4] = {'G', 'R', 'F', 'F'};
+
+// Arrays are read in chunks of at most this many values from streams that cannot report
+// their length, so a corrupt size fails at the end of the stream instead of allocating.
+const size_t MAX_CHUNK_SIZE = 1 << 20;
+
+// The remaining length of streams that cannot seek.
+const size_t UNKNOWN_LENGTH = std::numeric_limits<size_t>::max();
+
+/**
+ * The number of bytes left to read in the stream, or UNKNOWN_LENGTH if the stream
+ * cannot seek. This is only called once per read, since seeking can be slow.
+ */
+size_t remaining_bytes(std::istream& stream) {
+  std::streampos position = stream.tellg();
+  if (position == std::streampos(-1)) {
+    stream.clear();
+    return UNKNOWN_LENGTH;
+  }
+  stream.seekg(0, std::ios::end);
+  std::streampos end = stream.tellg();
+  stream.seekg(position);
+  if (end == std::streampos(-1) || !stream.good()) {
+    stream.clear();
+    stream.seekg(position);
+    return UNKNOWN_LENGTH;
+  }
+  return static_cast<size_t>(end - position);
+}
+
+// Raw block copies are only valid when the in-memory representation matches the file.
+bool can_copy_size_t() {
+  return is_little_endian() && sizeof(size_t) == sizeof(uint64_t);
+}
+
+bool can_copy_double() {
+  return is_little_endian() && sizeof(double) == sizeof(uint64_t);
+}
+
+} // namespace
+
+void ForestSerializer::write(const Forest& forest, std::ostream& stream) const {
+  write(forest, ForestMetadata(), stream);
+}
+
+void ForestSerializer::write(const Forest& forest,
+                             const ForestMetadata& metadata,
+                             std::ostream& stream) const {
+  stream.write(MAGIC, sizeof(MAGIC));
+  uint32_t version = FORMAT_VERSION;
+  unsigned char version_bytes[4];
+  for (size_t i = 0; i < 4; i++) {
+    version_bytes[i] = static_cast<unsigned char>((version >> (8 * i)) & 0xFF);
+  }
+  stream.write(reinterpret_cast<const char*>(version_bytes), 4);
+
+  write_value(forest.get_num_variables(), stream);
+  write_value(forest.get_ci_group_size(), stream);
+  write_value(forest.get_trees().size(), stream);
+  write_metadata(metadata, stream);
+
+  for (const auto& tree : forest.get_trees()) {
+    write_tree(*tree, stream);
+  }
+
+  if (!stream.good()) {
+    throw std::runtime_error("Failed to write forest to stream.");
+  }
+}
+
+Forest ForestSerializer::read(std::istream& stream) const {
+  ForestMetadata metadata;
+  return read(stream, metadata);
+}
+
+Forest ForestSerializer::read(std::istream& stream, ForestMetadata& metadata) const {
+  size_t remaining = remaining_bytes(stream);
+  char magic[4];
+  read_bytes(magic, sizeof(magic), remaining, stream);
+  if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+    throw std::runtime_error("Invalid forest file: unrecognized header.");
+  }
+
+  unsigned char version_bytes[4];
+  read_bytes(reinterpret_cast<char*>(version_bytes), 4, remaining, stream);
+  uint32_t version = 0;
+  for (size_t i = 0; i < 4; i++) {
+    version |= static_cast<uint32_t>(version_bytes[i]) << (8 * i);
+  }
+  if (version != FORMAT_VERSION) {
+    throw std::runtime_error("Unsupported forest file version " + std::to_string(version) +
+                             ", expected version " + std::to_string(FORMAT_VERSION) + ".");
+  }
+
+  size_t num_variables = read_value(remaining, stream);
+  size_t ci_group_size = read_value(remaining, stream);
+  size_t num_trees = read_value(remaining, stream);
+  // Every tree takes at least its root node and num_nodes.
+  check_size(num_trees, 2, remaining);
+  metadata = read_metadata(remaining, stream);
+
+  std::vector<std::unique_ptr<Tree>> trees;
+  trees.reserve(num_trees);
+  for (size_t t = 0; t < num_trees; t++) {
+    trees.push_back(read_tree(num_variables, remaining, stream));
+  }
+
+  return Forest(trees, num_variables, ci_group_size);
+}
+
+void ForestSerializer::save(const Forest& forest, const std::string& file_name) const {
+  save(forest, ForestMetadata(), file_name);
+}
+
+void ForestSerializer::save(const Forest& forest,
+                            const ForestMetadata& metadata,
+                            const std::string& file_name) const {
+  std::ofstream file(file_name, std::ios::binary);
+  if (!file.good()) {
+    throw std::runtime_error("Could not open output file " + file_name + ".");
+  }
+  write(forest, metadata, file);
+}
+
+Forest ForestSerializer::load(const std::string& file_name) const {
+  ForestMetadata metadata;
+  return load(file_name, metadata);
+}
+
+Forest ForestSerializer::load(const std::string& file_name, ForestMetadata& metadata) const {
+  std::ifstream file(file_name, std::ios::binary);
+  if (!file.good()) {
+    throw std::runtime_error("Could not open input file " + file_name + ".");
+  }
+  return read(file, metadata);
+}
+
+void ForestSerializer::write_tree(const Tree& tree, std::ostream& stream) const {
+  const std::vector<std::vector<size_t>>& child_nodes = tree.get_child_nodes();
+  size_t num_nodes = child_nodes[0].size();
+
+  write_value(tree.get_root_node(), stream);
+  write_value(num_nodes, stream);
+  write_values(child_nodes[0], stream);
+  write_values(child_nodes[1], stream);
+  write_values(tree.get_split_vars(), stream);
+  write_values(tree.get_split_values(), stream);
+
+  const std::vector<bool>& send_missing_left = tree.get_send_missing_left();
+  std::vector<char> send_missing_left_bytes(send_missing_left.begin(), send_missing_left.end());
+  send_missing_left_bytes.resize(num_nodes, 0);
+  stream.write(send_missing_left_bytes.data(), send_missing_left_bytes.size());
+
+  write_value(tree.get_leaf_samples().size(), stream);
+  write_nested_values(tree.get_leaf_samples(), stream);
+
+  const std::vector<uint64_t>& drawn_words = tree.get_drawn_sample_bitmap().get_words();
+  write_value(drawn_words.size(), stream);
+  write_values(std::vector<size_t>(drawn_words.begin(), drawn_words.end()), stream);
+
+  const PredictionValues& prediction_values = tree.get_prediction_values();
+  write_value(prediction_values.get_num_nodes(), stream);
+  write_value(prediction_values.get_num_types(), stream);
+  write_values(prediction_values.get_slots(), stream);
+  write_value(prediction_values.get_flat_values().size(), stream);
+  write_values(prediction_values.get_flat_values(), stream);
+}
+
+std::unique_ptr<Tree> ForestSerializer::read_tree(size_t num_variables,
+                                                  size_t& remaining, std::istream& stream) const {
+  size_t root_node = read_value(remaining, stream);
+  size_t num_nodes = read_value(remaining, stream);
+  if (root_node >= num_nodes && num_nodes > 0) {
+    throw std::runtime_error("Invalid forest file: root node out of range.");
+  }
+
+  std::vector<std::vector<size_t>> child_nodes(2);
+  read_values(num_nodes, child_nodes[0], remaining, stream);
+  read_values(num_nodes, child_nodes[1], remaining, stream);
+  // Children always come after their parent, which guarantees that every path
+  // from the root reaches a leaf.
+  for (size_t node = 0; node < num_nodes; node++) {
+    size_t left_child = child_nodes[0][node];
+    size_t right_child = child_nodes[1][node];
+    bool is_leaf = left_child == 0 && right_child == 0;
+    if (!is_leaf && (left_child <= node || right_child <= node ||
+                     left_child >= num_nodes || right_child >= num_nodes)) {
+      throw std::runtime_error("Invalid forest file: child node out of range.");
+    }
+  }
+
+  std::vector<size_t> split_vars;
+  read_values(num_nodes, split_vars, remaining, stream);
+  for (size_t node = 0; node < num_nodes; node++) {
+    bool is_leaf = child_nodes[0][node] == 0 && child_nodes[1][node] == 0;
+    if (!is_leaf && split_vars[node] >= num_variables) {
+      throw std::runtime_error("Invalid forest file: split variable out of range.");
+    }
+  }
+  std::vector<double> split_values;
+  read_values(num_nodes, split_values, remaining, stream);
+
+  std::vector<char> send_missing_left_bytes(num_nodes);
+  read_bytes(send_missing_left_bytes.data(), num_nodes, remaining, stream);
+  std::vector<bool> send_missing_left(send_missing_left_bytes.begin(), send_missing_left_bytes.end());
+
+  size_t num_leaf_sample_nodes = read_value(remaining, stream);
+  if (num_leaf_sample_nodes != num_nodes && num_leaf_sample_nodes != 0) {
+    throw std::runtime_error("Invalid forest file: inconsistent number of leaf sample lists.");
+  }
+  std::vector<std::vector<size_t>> leaf_samples;
+  read_nested_values(num_leaf_sample_nodes, leaf_samples, remaining, stream);
+
+  size_t num_drawn_words = read_value(remaining, stream);
+  std::vector<size_t> drawn_words;
+  read_values(num_drawn_words, drawn_words, remaining, stream);
+  Bitmap drawn_samples = Bitmap::from_words(std::vector<uint64_t>(drawn_words.begin(), drawn_words.end()));
+
+  // Leaf samples are a subset of the drawn samples, when those were recorded.
+  if (!drawn_samples.get_words().empty()) {
+    for (const auto& samples : leaf_samples) {
+      for (size_t sample : samples) {
+        if (!drawn_samples.contains(sample)) {
+          throw std::runtime_error("Invalid forest file: leaf sample out of range.");
+        }
+      }
+    }
+  }
+
+  size_t num_prediction_nodes = read_value(remaining, stream);
+  size_t num_types = read_value(remaining, stream);
+  if (num_prediction_nodes != num_nodes && num_prediction_nodes != 0) {
+    throw std::runtime_error("Invalid forest file: inconsistent number of prediction value nodes.");
+  }
+  std::vector<size_t> slots;
+  read_values(num_prediction_nodes, slots, remaining, stream);
+  std::vector<double> flat_values;
+  read_values(read_value(remaining, stream), flat_values, remaining, stream);
+  size_t num_slots = num_types > 0 ? flat_values.size() / num_types : 0;
+  for (size_t slot : slots) {
+    if (slot != PredictionValues::EMPTY_SLOT && slot >= num_slots) {
+      throw std::runtime_error("Invalid forest file: prediction value slot out of range.");
+    }
+  }
+  PredictionValues prediction_values(std::move(slots), std::move(flat_values), num_types);
+
+  std::unique_ptr<Tree> tree(new Tree(root_node, std::move(child_nodes), std::move(leaf_samples),
+                                      std::move(split_vars), std::move(split_values), std::vector<size_t>(),
+                                      std::move(send_missing_left), std::move(prediction_values)));
+  tree->set_drawn_samples(std::move(drawn_samples));
+  return tree;
+}
+
+void ForestSerializer::write_metadata(const ForestMetadata& metadata, std::ostream& stream) const {
+  std::string text;
+  for (const auto& entry : metadata) {
+    if (entry.first.empty() || entry.first.find_first_of("=\n") != std::string::npos ||
+        entry.second.find('\n') != std::string::npos) {
+      throw std::runtime_error("Invalid forest metadata entry " + entry.first + ".");
+    }
+    text += entry.first + "=" + entry.second + "\n";
+  }
+
+  write_value(text.size(), stream);
+  stream.write(text.data(), text.size());
+}
+
+ForestMetadata ForestSerializer::read_metadata(size_t& remaining, std::istream& stream) const {
+  size_t num_bytes = read_value(remaining, stream);
+  check_size(num_bytes, 1, remaining);
+  std::vector<char> text(num_bytes);
+  read_bytes(text.data(), num_bytes, remaining, stream);
+
+  ForestMetadata metadata;
+  size_t start = 0;
+  while (start < num_bytes) {
+    size_t end = start;
+    while (end < num_bytes && text[end] != '\n') {
+      end++;
+    }
+    std::string line(text.data() + start, end - start);
+    size_t separator = line.find('=');
+    if (separator == std::string::npos) {
+      throw std::runtime_error("Invalid forest file: malformed metadata.");
+    }
+    metadata[line.substr(0, separator)] = line.substr(separator + 1);
+    start = end + 1;
+  }
+  return metadata;
+}
+
+void ForestSerializer::write_value(uint64_t value, std::ostream& stream) const {
+  uint64_t encoded = to_little_endian(value);
+  stream.write(reinterpret_cast<const char*>(&encoded), sizeof(encoded));
+}
+
+void ForestSerializer::write_values(const std::vector<size_t>& values, std::ostream& stream) const {
+  if (can_copy_size_t()) {
+    stream.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(uint64_t));
+  } else {
+    for (size_t value : values) {
+      write_value(value, stream);
+    }
+  }
+}
+
+void ForestSerializer::write_values(const std::vector<double>& values, std::ostream& stream) const {
+  if (can_copy_double()) {
+    stream.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(uint64_t));
+  } else {
+    for (double value : values) {
+      uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      write_value(bits, stream);
+    }
+  }
+}
+
+template<typename T>
+void ForestSerializer::write_nested_values(const std::vector<std::vector<T>>& values,
+                                           std::ostream& stream) const {
+  std::vector<size_t> offsets(values.size() + 1, 0);
+  std::vector<T> flat_values;
+  for (size_t i = 0; i < values.size(); i++) {
+    offsets[i + 1] = offsets[i] + values[i].size();
+  }
+  flat_values.reserve(offsets.back());
+  for (const auto& value : values) {
+    flat_values.insert(flat_values.end(), value.begin(), value.end());
+  }
+  write_values(offsets, stream);
+  write_values(flat_values, stream);
+}
+
+uint64_t ForestSerializer::read_value(size_t& remaining, std::istream& stream) const {
+  uint64_t encoded;
+  read_bytes(reinterpret_cast<char*>(&encoded), sizeof(encoded), remaining, stream);
+  return from_little_endian(encoded);
+}
+
+void ForestSerializer::read_values(size_t size,
+                                   std::vector<size_t>& values,
+                                   size_t& remaining,
+                                   std::istream& stream) const {
+  size_t chunk_size = check_size(size, sizeof(uint64_t), remaining);
+  values.clear();
+  for (size_t start = 0; start < size; start += chunk_size) {
+    size_t end = std::min(size, start + chunk_size);
+    values.resize(end);
+    if (can_copy_size_t()) {
+      read_bytes(reinterpret_cast<char*>(values.data() + start), (end - start) * sizeof(uint64_t), remaining, stream);
+    } else {
+      for (size_t i = start; i < end; i++) {
+        values[i] = read_value(remaining, stream);
+      }
+    }
+  }
+}
+
+void ForestSerializer::read_values(size_t size,
+                                   std::vector<double>& values,
+                                   size_t& remaining,
+                                   std::istream& stream) const {
+  size_t chunk_size = check_size(size, sizeof(uint64_t), remaining);
+  values.clear();
+  for (size_t start = 0; start < size; start += chunk_size) {
+    size_t end = std::min(size, start + chunk_size);
+    values.resize(end);
+    if (can_copy_double()) {
+      read_bytes(reinterpret_cast<char*>(values.data() + start), (end - start) * sizeof(uint64_t), remaining, stream);
+    } else {
+      for (size_t i = start; i < end; i++) {
+        uint64_t bits = read_value(remaining, stream);
+        std::memcpy(&values[i], &bits, sizeof(bits));
+      }
+    }
+  }
+}
+
+template<typename T>
+void ForestSerializer::read_nested_values(size_t size,
+                                          std::vector<std::vector<T>>& values,
+                                          size_t& remaining, std::istream& stream) const {
+  if (size == std::numeric_limits<size_t>::max()) {
+    throw std::runtime_error("Invalid forest file: array size exceeds the remaining stream length.");
+  }
+  std::vector<size_t> offsets;
+  read_values(size + 1, offsets, remaining, stream);
+  std::vector<T> flat_values;
+  read_values(offsets.back(), flat_values, remaining, stream);
+
+  values.resize(size);
+  for (size_t i = 0; i < size; i++) {
+    if (offsets[i] > offsets[i + 1] || offsets[i + 1] > flat_values.size()) {
+      throw std::runtime_error("Invalid forest file: inconsistent offsets.");
+    }
+    values[i].assign(flat_values.begin() + offsets[i], flat_values.begin() + offsets[i + 1]);
+  }
+}
+
+size_t ForestSerializer::check_size(size_t size, size_t element_size, size_t remaining) const {
+  if (size > remaining / element_size) {
+    throw std::runtime_error("Invalid forest file: array size exceeds the remaining stream length.");
+  }
+  return remaining == UNKNOWN_LENGTH ? MAX_CHUNK_SIZE : std::max<size_t>(size, 1);
+}
+
+void ForestSerializer::read_bytes(char* buffer,
+                                  size_t num_bytes,
+                                  size_t& remaining,
+                                  std::istream& stream) const {
+  stream.read(buffer, num_bytes);
+  if (static_cast<size_t>(stream.gcount()) != num_bytes) {
+    throw std::runtime_error("Invalid forest file: unexpected end of stream.");
+  }
+  if (remaining != UNKNOWN_LENGTH) {
+    remaining -= num_bytes;
+  }
+}
+
+} // namespace grf
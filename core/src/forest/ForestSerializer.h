@@ -0,0 +1,129 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_FORESTSERIALIZER_H
+#define GRF_FORESTSERIALIZER_H
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "forest/Forest.h"
+
+namespace grf {
+
+/**
+ * Reads and writes forests in a versioned binary format.
+ *
+ * All integers are stored as unsigned 64-bit values and all floating point numbers
+ * as IEEE 754 doubles, both in little-endian byte order regardless of the host.
+ * The layout is:
+ *
+ *   header: magic "GRFF", uint32 format version,
+ *           num_variables, ci_group_size, num_trees,
+ *           num_metadata_bytes, metadata
+ *   for each tree:
+ *     root_node, num_nodes,
+ *     left children [num_nodes], right children [num_nodes],
+ *     split_vars [num_nodes], split_values [num_nodes] (double),
+ *     send_missing_left [num_nodes] (one byte each),
+ *     num_leaf_sample_nodes (either num_nodes, or 0 for trees without leaf samples),
+ *     leaf sample offsets [num_leaf_sample_nodes + 1], leaf samples [offsets[num_leaf_sample_nodes]],
+ *     num_drawn_words, drawn sample bitmap [num_drawn_words],
+ *     prediction value num_nodes and num_types, prediction value slots [num_nodes],
+ *     num_flat_values, flat prediction values [num_flat_values] (double)
+ *
+ * Each per-node list is stored as one flat array together with its offsets, so a tree
+ * is read with a handful of bulk reads.
+ *
+ * In the drawn sample bitmap, bit i of word w is set if sample 64 * w + i was drawn.
+ *
+ * Prediction values are stored in the flat layout of PredictionValues, so they can be
+ * read as one block. Empty nodes have slot 2^64 - 1.
+ *
+ * The metadata holds key-value pairs describing the forest for tools reading the file,
+ * such as the type of forest, stored as "key=value" lines. Keys may not contain '=' or
+ * line breaks, and values may not contain line breaks.
+
+ */
+typedef std::map<std::string, std::string> ForestMetadata;
+
+class ForestSerializer {
+public:
+  void write(const Forest& forest, std::ostream& stream) const;
+
+  void write(const Forest& forest, const ForestMetadata& metadata, std::ostream& stream) const;
+
+  Forest read(std::istream& stream) const;
+
+  /**
+   * Reads a forest, filling metadata with the key-value pairs stored alongside it.
+   */
+  Forest read(std::istream& stream, ForestMetadata& metadata) const;
+
+  void save(const Forest& forest, const std::string& file_name) const;
+
+  void save(const Forest& forest, const ForestMetadata& metadata, const std::string& file_name) const;
+
+  Forest load(const std::string& file_name) const;
+
+  Forest load(const std::string& file_name, ForestMetadata& metadata) const;
+
+  static const uint32_t FORMAT_VERSION;
+
+private:
+  void write_tree(const Tree& tree, std::ostream& stream) const;
+
+  void write_metadata(const ForestMetadata& metadata, std::ostream& stream) const;
+
+  ForestMetadata read_metadata(size_t& remaining, std::istream& stream) const;
+
+  std::unique_ptr<Tree> read_tree(size_t num_variables, size_t& remaining, std::istream& stream) const;
+
+  void write_value(uint64_t value, std::ostream& stream) const;
+  void write_values(const std::vector<size_t>& values, std::ostream& stream) const;
+  void write_values(const std::vector<double>& values, std::ostream& stream) const;
+  template<typename T>
+  void write_nested_values(const std::vector<std::vector<T>>& values, std::ostream& stream) const;
+
+  // The read functions take the number of bytes left in the stream, as computed once
+  // when reading starts, and subtract the bytes they consume.
+  uint64_t read_value(size_t& remaining, std::istream& stream) const;
+  void read_values(size_t size, std::vector<size_t>& values, size_t& remaining, std::istream& stream) const;
+  void read_values(size_t size, std::vector<double>& values, size_t& remaining, std::istream& stream) const;
+  template<typename T>
+  void read_nested_values(size_t size,
+                          std::vector<std::vector<T>>& values,
+                          size_t& remaining,
+                          std::istream& stream) const;
+
+  /**
+   * Checks that the remaining bytes hold at least size elements of element_size bytes, so that
+   * a corrupt count fails before allocating. Returns the number of elements to read at a
+   * time, which is bounded when the stream cannot report its length.
+   */
+  size_t check_size(size_t size, size_t element_size, size_t remaining) const;
+
+  void read_bytes(char* buffer, size_t num_bytes, size_t& remaining, std::istream& stream) const;
+};
+
+} // namespace grf
+
+#endif //GRF_FORESTSERIALIZER_H
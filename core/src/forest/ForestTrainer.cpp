@@ -16,8 +16,10 @@
  #-------------------------------------------------------------------------------*/
 
 #include <algorithm>
+#include <cmath>
 #include <ctime>
 #include <future>
+#include <random>
 #include <stdexcept>
 
 #include "commons/utility.h"
@@ -35,17 +37,217 @@ ForestTrainer::ForestTrainer(std::unique_ptr<RelabelingStrategy> relabeling_stra
                  std::move(prediction_strategy)) {}
 
 Forest ForestTrainer::train(const Data& data, const ForestOptions& options) const {
-  std::vector<std::unique_ptr<Tree>> trees = train_trees(data, options);
+  return train_range(data, options, 0, get_num_trees(options), nullptr);
+}
 
-  size_t num_variables = data.get_num_cols() - data.get_disallowed_split_variables().size();
+Forest ForestTrainer::train(const Data& data,
+                            const ForestOptions& options,
+                            OOBPredictionAccumulator& oob_accumulator) const {
+  if (oob_accumulator.get_num_samples() != data.get_num_rows()) {
+    throw std::runtime_error("The OOB accumulator must cover every sample in the training data.");
+  }
+  return train_range(data, options, 0, get_num_trees(options), &oob_accumulator);
+}
+
+Forest ForestTrainer::train(const Data& data,
+                            const ForestOptions& options,
+                            size_t start_tree,
+                            size_t end_tree) const {
+  return train_range(data, options, start_tree, end_tree, nullptr);
+}
+
+Forest ForestTrainer::train_range(const Data& data,
+                                  const ForestOptions& options,
+                                  size_t start_tree,
+                                  size_t end_tree,
+                                  OOBPredictionAccumulator* oob_accumulator) const {
   size_t ci_group_size = options.get_ci_group_size();
+  if (start_tree > end_tree) {
+    throw std::runtime_error("The start of the tree range must not exceed its end.");
+  } else if (start_tree % ci_group_size != 0 || end_tree % ci_group_size != 0) {
+    throw std::runtime_error("The tree range must start and end at a multiple of ci_group_size.");
+  }
+
+  std::vector<std::unique_ptr<Tree>> trees = train_trees(data, options,
+      start_tree / ci_group_size, (end_tree - start_tree) / ci_group_size, oob_accumulator);
+
+  size_t num_variables = data.get_num_cols() - data.get_disallowed_split_variables().size();
   return Forest(trees, num_variables, ci_group_size);
 }
 
+void ForestTrainer::grow(Forest& forest,
+                         const Data& data,
+                         const ForestOptions& options) const {
+  validate_grown_forest(forest, data, options);
+  grow_to(forest, data, options, get_num_trees(options), nullptr);
+}
+
+void ForestTrainer::grow(Forest& forest,
+                         const Data& data,
+                         const ForestOptions& options,
+                         OOBPredictionAccumulator& oob_accumulator) const {
+  if (oob_accumulator.get_num_samples() != data.get_num_rows()) {
+    throw std::runtime_error("The OOB accumulator must cover every sample in the training data.");
+  }
+  validate_grown_forest(forest, data, options);
+  grow_to(forest, data, options, get_num_trees(options), &oob_accumulator);
+}
+
+void ForestTrainer::validate_grown_forest(const Forest& forest,
+                                          const Data& data,
+                                          const ForestOptions& options) const {
+  size_t num_variables = data.get_num_cols() - data.get_disallowed_split_variables().size();
+  if (forest.get_ci_group_size() != options.get_ci_group_size()) {
+    throw std::runtime_error("The forest being grown must have the same ci_group_size as the options.");
+  } else if (forest.get_num_variables() != num_variables) {
+    throw std::runtime_error("The forest being grown must have been trained on the same variables.");
+  }
+}
+
+Forest ForestTrainer::train_until_converged(const Data& data,
+                                           const ForestOptions& options,
+                                           size_t wave_size,
+                                           double tolerance) const {
+  const OptimizedPredictionStrategy* strategy = tree_trainer.get_prediction_strategy();
+  if (strategy == nullptr) {
+    throw std::runtime_error("Training until convergence requires a forest with precomputed prediction values.");
+  } else if (wave_size == 0) {
+    throw std::runtime_error("The number of trees per wave must be positive.");
+  }
+
+  // Each wave consists of whole ci groups.
+  size_t ci_group_size = options.get_ci_group_size();
+  wave_size = (wave_size + ci_group_size - 1) / ci_group_size * ci_group_size;
+  size_t max_trees = get_num_trees(options);
+
+  size_t num_samples = data.get_num_rows();
+  OOBPredictionAccumulator oob_accumulator(num_samples, strategy->prediction_value_length(),
+                                           strategy->has_streamed_error_estimates());
+  Forest forest = train_range(data, options, 0, std::min(wave_size, max_trees), &oob_accumulator);
+
+  std::vector<double> predictions(num_samples * strategy->prediction_length());
+  std::vector<double> errors(num_samples);
+  std::vector<double> excess_errors(num_samples);
+  PredictionOutput oob_output(num_samples, strategy->prediction_length(),
+                              predictions.data(), nullptr, errors.data(), excess_errors.data());
+  std::vector<Prediction> oob_predictions;
+
+  while (forest.get_trees().size() < max_trees) {
+    oob_accumulator.predict(*strategy, data, oob_output);
+    double excess_error_ratio = get_excess_error_ratio(errors, excess_errors);
+    if (!std::isnan(excess_error_ratio)) {
+      if (excess_error_ratio <= tolerance) {
+        break;
+      }
+    } else {
+      // The strategy does not estimate OOB errors, so fall back to the prediction drift.
+      std::vector<Prediction> previous_predictions = std::move(oob_predictions);
+      oob_predictions = oob_output.to_predictions();
+      if (!previous_predictions.empty()
+          && get_relative_change(previous_predictions, oob_predictions) < tolerance) {
+        break;
+      }
+    }
+
+    size_t num_trees = forest.get_trees().size();
+    grow_to(forest, data, options, std::min(num_trees + wave_size, max_trees), &oob_accumulator);
+  }
+
+  return forest;
+}
+
+const OptimizedPredictionStrategy* ForestTrainer::get_prediction_strategy() const {
+  return tree_trainer.get_prediction_strategy();
+}
+
+void ForestTrainer::grow_to(Forest& forest,
+                            const Data& data,
+                            const ForestOptions& options,
+                            size_t num_trees,
+                            OOBPredictionAccumulator* oob_accumulator) const {
+  size_t start_tree = forest.get_trees().size();
+  if (start_tree >= num_trees) {
+    return;
+  }
+
+  Forest new_trees = train_range(data, options, start_tree, num_trees, oob_accumulator);
+  std::vector<std::unique_ptr<Tree>>& trees = forest.get_trees_();
+  trees.insert(trees.end(),
+               std::make_move_iterator(new_trees.get_trees_().begin()),
+               std::make_move_iterator(new_trees.get_trees_().end()));
+}
+
+double ForestTrainer::get_relative_change(const std::vector<Prediction>& previous_predictions,
+                                          const std::vector<Prediction>& predictions) const {
+  // Samples without OOB predictions in either wave are skipped.
+  size_t num_values = 0;
+  double sum = 0.0;
+  double sum_of_squares = 0.0;
+  double squared_change = 0.0;
+
+  for (size_t sample = 0; sample < predictions.size(); sample++) {
+    const std::vector<double>& previous = previous_predictions[sample].get_predictions();
+    const std::vector<double>& current = predictions[sample].get_predictions();
+    for (size_t i = 0; i < current.size(); i++) {
+      if (std::isnan(previous[i]) || std::isnan(current[i])) {
+        continue;
+      }
+      double change = current[i] - previous[i];
+      squared_change += change * change;
+      sum += current[i];
+      sum_of_squares += current[i] * current[i];
+      num_values++;
+    }
+  }
+
+  if (num_values < 2) {
+    return INFINITY;
+  }
+
+  double mean = sum / num_values;
+  double variance = sum_of_squares / num_values - mean * mean;
+  if (variance <= 0.0) {
+    return squared_change > 0.0 ? INFINITY : 0.0;
+  }
+  return squared_change / num_values / variance;
+}
+
+double ForestTrainer::get_excess_error_ratio(const std::vector<double>& errors,
+                                             const std::vector<double>& excess_errors) const {
+  // Samples without an error estimate, for example because they are not yet OOB for
+  // enough trees, are skipped.
+  size_t num_errors = 0;
+  double error_sum = 0.0;
+  double excess_error_sum = 0.0;
+  for (size_t sample = 0; sample < errors.size(); sample++) {
+    if (std::isnan(errors[sample]) || std::isnan(excess_errors[sample])) {
+      continue;
+    }
+    error_sum += errors[sample];
+    excess_error_sum += excess_errors[sample];
+    num_errors++;
+  }
+
+  if (num_errors == 0) {
+    return NAN;
+  } else if (error_sum <= 0.0) {
+    return INFINITY;
+  }
+  return excess_error_sum / error_sum;
+}
+
+size_t ForestTrainer::get_num_trees(const ForestOptions& options) const {
+  // Only whole ci groups are trained.
+  size_t ci_group_size = options.get_ci_group_size();
+  return options.get_num_trees() / ci_group_size * ci_group_size;
+}
+
 std::vector<std::unique_ptr<Tree>> ForestTrainer::train_trees(const Data& data,
-                                                              const ForestOptions& options) const {
+                                                              const ForestOptions& options,
+                                                              size_t start_group,
+                                                              size_t num_groups,
+                                                              OOBPredictionAccumulator* oob_accumulator) const {
   size_t num_samples = data.get_num_rows();
-  uint num_trees = options.get_num_trees();
 
   // Ensure that the sample fraction is not too small and honesty fraction is not too extreme.
   const TreeOptions& tree_options = options.get_tree_options();
@@ -56,28 +258,32 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_trees(const Data& data,
   } else if (honesty && ((size_t) num_samples * options.get_sample_fraction() * honesty_fraction < 1
              || (size_t) num_samples * options.get_sample_fraction() * (1-honesty_fraction) < 1)) {
     throw std::runtime_error("The honesty fraction is too close to 1 or 0, as no observations will be sampled.");
+  } else if (!options.get_store_leaf_samples() && tree_trainer.get_prediction_strategy() == nullptr) {
+    throw std::runtime_error("Leaf samples can only be dropped from forests with precomputed prediction values.");
   }
 
-  uint num_groups = static_cast<uint>(num_trees / options.get_ci_group_size());
+  std::vector<std::unique_ptr<Tree>> trees;
+  if (num_groups == 0) {
+    return trees;
+  }
+  trees.reserve(num_groups * options.get_ci_group_size());
 
   std::vector<uint> thread_ranges;
-  split_sequence(thread_ranges, 0, num_groups - 1, options.get_num_threads());
+  split_sequence(thread_ranges, static_cast<uint>(start_group),
+                 static_cast<uint>(start_group + num_groups - 1), options.get_num_threads());
 
   std::vector<std::future<std::vector<std::unique_ptr<Tree>>>> futures;
   futures.reserve(thread_ranges.size());
 
-  std::vector<std::unique_ptr<Tree>> trees;
-  trees.reserve(num_trees);
-
   for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
     size_t start_index = thread_ranges[i];
-    size_t num_trees_batch = thread_ranges[i + 1] - start_index;
+    size_t num_groups_batch = thread_ranges[i + 1] - start_index;
 
     futures.push_back(std::async(std::launch::async,
                                  &ForestTrainer::train_batch,
                                  this,
                                  start_index,
-                                 num_trees_batch,
+                                 num_groups_batch,
                                  std::ref(data),
                                  options));
   }
@@ -89,37 +295,52 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_trees(const Data& data,
                  std::make_move_iterator(thread_trees.end()));
   }
 
+  if (oob_accumulator != nullptr) {
+    oob_accumulator->add_trees(trees, 0, data, options.get_num_threads());
+  }
+
   return trees;
 }
 
 std::vector<std::unique_ptr<Tree>> ForestTrainer::train_batch(
-    size_t start,
-    size_t num_trees,
+    size_t start_group,
+    size_t num_groups,
     const Data& data,
     const ForestOptions& options) const {
   size_t ci_group_size = options.get_ci_group_size();
 
-  std::mt19937_64 random_number_generator(options.get_random_seed() + start);
   nonstd::uniform_int_distribution<uint> udist;
   std::vector<std::unique_ptr<Tree>> trees;
-  trees.reserve(num_trees * ci_group_size);
+  trees.reserve(num_groups * ci_group_size);
 
-  for (size_t i = 0; i < num_trees; i++) {
+  for (size_t group = start_group; group < start_group + num_groups; group++) {
+    // Derive each group's seed from its global index only, so that the trees do not
+    // depend on how the groups are divided among threads or training calls.
+    std::seed_seq seed_sequence{options.get_random_seed(), static_cast<uint>(group)};
+    std::mt19937_64 random_number_generator(seed_sequence);
     uint tree_seed = udist(random_number_generator);
     RandomSampler sampler(tree_seed, options.get_sampling_options());
 
+    size_t num_trees = trees.size();
     if (ci_group_size == 1) {
       std::unique_ptr<Tree> tree = train_tree(data, sampler, options);
       trees.push_back(std::move(tree));
     } else {
-      std::vector<std::unique_ptr<Tree>> group = train_ci_group(data, sampler, options);
+      std::vector<std::unique_ptr<Tree>> group_trees = train_ci_group(data, sampler, options);
       trees.insert(trees.end(),
-          std::make_move_iterator(group.begin()),
-          std::make_move_iterator(group.end()));
+          std::make_move_iterator(group_trees.begin()),
+          std::make_move_iterator(group_trees.end()));
+    }
+
+    for (size_t i = num_trees; i < trees.size(); i++) {
+      if (!options.get_store_leaf_samples()) {
+        trees[i]->drop_leaf_samples();
+      }
     }
   }
   return trees;
 }
+
 std::unique_ptr<Tree> ForestTrainer::train_tree(const Data& data,
                                                 RandomSampler& sampler,
                                                 const ForestOptions& options) const {
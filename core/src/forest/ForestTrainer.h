@@ -21,6 +21,7 @@
 #include <memory>
 
 #include "prediction/OptimizedPredictionStrategy.h"
+#include "prediction/collector/OOBPredictionAccumulator.h"
 #include "relabeling/RelabelingStrategy.h"
 #include "splitting/factory/SplittingRuleFactory.h"
 
@@ -39,14 +40,111 @@ public:
 
   Forest train(const Data& data, const ForestOptions& options) const;
 
+  /**
+   * Trains a forest as above, and adds the out-of-bag prediction values of its trees
+   * to oob_accumulator. The trees are added with the training threads splitting the
+   * samples between them, so that the accumulator is never copied per thread.
+   */
+  Forest train(const Data& data,
+               const ForestOptions& options,
+               OOBPredictionAccumulator& oob_accumulator) const;
+
+  /**
+   * Trains only the trees with indices start_tree, ..., end_tree - 1 of the forest
+   * that train(data, options) would produce. Each tree is seeded from the random seed
+   * and its index alone, so shards trained separately (for example on different
+   * machines) can be combined in order with Forest::merge into the same forest as a
+   * single run, regardless of the number of threads used for each shard.
+   *
+   * Both bounds must be multiples of the forest's ci_group_size.
+   */
+  Forest train(const Data& data,
+               const ForestOptions& options,
+               size_t start_tree,
+               size_t end_tree) const;
+
+  /**
+   * Appends newly trained trees to an existing forest until it holds
+   * options.get_num_trees() trees. The new trees continue the tree indices of the
+   * forest, so growing a forest trained with the same data and options gives the
+   * same result as training the larger forest directly.
+   */
+  void grow(Forest& forest,
+            const Data& data,
+            const ForestOptions& options) const;
+
+  /**
+   * As above, additionally adding the out-of-bag values of the new trees to
+   * oob_accumulator, so that the OOB predictions of the grown forest can be
+   * obtained without traversing the trees it already contained.
+   */
+  void grow(Forest& forest,
+            const Data& data,
+            const ForestOptions& options,
+            OOBPredictionAccumulator& oob_accumulator) const;
+
+  /**
+   * Trains a forest in waves of wave_size trees, stopping once its out-of-bag
+   * error has stabilized or options.get_num_trees() trees have been trained.
+   *
+   * After each wave, the OOB predictions and error estimates are updated from running
+   * sums of the new trees' leaf prediction values and their products, without
+   * traversing earlier trees. Training stops when the mean excess error, that is the
+   * part of the OOB error due to using finitely many trees, falls below tolerance times
+   * the mean debiased OOB error. Strategies that do not estimate OOB errors instead stop
+   * when the mean squared change in the OOB predictions over a wave, relative to their
+   * variance across samples, falls below tolerance. The trees are identical to the
+   * first trees of a forest trained with train(data, options), so the result can later
+   * be grown further.
+   *
+   * This requires a trainer that precomputes prediction values, such as regression_trainer().
+   */
+  Forest train_until_converged(const Data& data,
+                               const ForestOptions& options,
+                               size_t wave_size,
+                               double tolerance) const;
+
+  /**
+   * The strategy used to precompute the prediction values of each leaf, or
+   * nullptr if trees are trained without precomputed prediction values.
+   */
+  const OptimizedPredictionStrategy* get_prediction_strategy() const;
+
 private:
 
+  size_t get_num_trees(const ForestOptions& options) const;
+
+  Forest train_range(const Data& data,
+                     const ForestOptions& options,
+                     size_t start_tree,
+                     size_t end_tree,
+                     OOBPredictionAccumulator* oob_accumulator) const;
+
+  void validate_grown_forest(const Forest& forest,
+                             const Data& data,
+                             const ForestOptions& options) const;
+
+  void grow_to(Forest& forest,
+               const Data& data,
+               const ForestOptions& options,
+               size_t num_trees,
+               OOBPredictionAccumulator* oob_accumulator) const;
+
+  double get_relative_change(const std::vector<Prediction>& previous_predictions,
+                             const std::vector<Prediction>& predictions) const;
+
+  double get_excess_error_ratio(const std::vector<double>& errors,
+                                const std::vector<double>& excess_errors) const;
+
   std::vector<std::unique_ptr<Tree>> train_trees(const Data& data,
-                                                 const ForestOptions& options) const;
+                                                 const ForestOptions& options,
+                                                 size_t start_group,
+                                                 size_t num_groups,
+                                                 OOBPredictionAccumulator* oob_accumulator) const;
 
   std::vector<std::unique_ptr<Tree>> train_batch(
-      size_t start,
-      size_t num_trees,
+      size_t start_group,
+      size_t num_groups,
       const Data& data,
       const ForestOptions& options) const;
 
@@ -38,44 +38,20 @@ std::vector<double> CausalSurvivalPredictionStrategy::predict(const std::vector<
 
 std::vector<double> CausalSurvivalPredictionStrategy::compute_variance(
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
-    size_t ci_group_size) const {
+    const LeafValueMoments& leaf_value_moments) const {
 
   double v_est = average.at(DENOMINATOR);
   double average_eta = average.at(NUMERATOR) / average.at(DENOMINATOR);
 
+  // psi = leaf numerator - leaf denominator * average_eta
+  std::vector<double> psi_coefficients(leaf_value_moments.get_num_types(), 0.0);
+  psi_coefficients[NUMERATOR] = 1;
+  psi_coefficients[DENOMINATOR] = -average_eta;
 
-  double num_good_groups = 0;
-  double psi_squared = 0;
-  double psi_grouped_squared = 0;
-
-  for (size_t group = 0; group < leaf_values.get_num_nodes() / ci_group_size; ++group) {
-    bool good_group = true;
-    for (size_t j = 0; j < ci_group_size; ++j) {
-      if (leaf_values.empty(group * ci_group_size + j)) {
-        good_group = false;
-      }
-    }
-    if (!good_group) continue;
-
-    num_good_groups++;
-
-    double group_psi = 0;
-
-    for (size_t j = 0; j < ci_group_size; ++j) {
-
-      size_t i = group * ci_group_size + j;
-      const std::vector<double>& leaf_value = leaf_values.get_values(i);
-
-      double psi_1 = leaf_value.at(NUMERATOR) - leaf_value.at(DENOMINATOR) * average_eta;
-
-      psi_squared += psi_1 * psi_1;
-      group_psi += psi_1;
-    }
-
-    group_psi /= ci_group_size;
-		psi_grouped_squared += group_psi * group_psi;
-  }
+  size_t ci_group_size = leaf_value_moments.get_ci_group_size();
+  double num_good_groups = leaf_value_moments.get_num_good_groups();
+  double psi_squared = leaf_value_moments.get_sum_of_squares(psi_coefficients);
+  double psi_grouped_squared = leaf_value_moments.get_sum_of_group_squares(psi_coefficients);
 
   // Using notation from the GRF paper, ...
 
@@ -145,4 +121,17 @@ std::vector<std::pair<double, double>> CausalSurvivalPredictionStrategy::compute
   return { std::make_pair<double, double>(NAN, NAN) };
 }
 
+std::vector<std::pair<double, double>> CausalSurvivalPredictionStrategy::compute_error(
+    size_t sample,
+    const std::vector<double>& average,
+    const std::vector<double>& centered_products,
+    size_t num_trees,
+    const Data& data) const {
+  return { std::make_pair<double, double>(NAN, NAN) };
+}
+
+bool CausalSurvivalPredictionStrategy::has_streamed_error_estimates() const {
+  return false;
+}
+
 } // namespace grf
@@ -45,8 +45,7 @@ public:
   std::vector<double> predict(const std::vector<double>& average) const;
 
   std::vector<double> compute_variance(const std::vector<double>& average,
-                          const PredictionValues& leaf_values,
-                          size_t ci_group_size) const;
+                                       const LeafValueMoments& leaf_value_moments) const;
 
   std::vector<std::pair<double, double>> compute_error(
       size_t sample,
@@ -54,6 +53,15 @@ public:
       const PredictionValues& leaf_values,
       const Data& data) const;
 
+  std::vector<std::pair<double, double>> compute_error(
+      size_t sample,
+      const std::vector<double>& average,
+      const std::vector<double>& centered_products,
+      size_t num_trees,
+      const Data& data) const;
+
+  bool has_streamed_error_estimates() const;
+
 private:
   ObjectiveBayesDebiaser bayes_debiaser;
 };
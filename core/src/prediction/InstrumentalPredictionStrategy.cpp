@@ -80,8 +80,7 @@ std::vector<double> InstrumentalPredictionStrategy::predict(const std::vector<do
  */
 std::vector<double> InstrumentalPredictionStrategy::compute_variance(
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
-    size_t ci_group_size) const {
+    const LeafValueMoments& leaf_value_moments) const {
 
   double instrument_effect_numerator = average.at(OUTCOME_INSTRUMENT) * average.at(WEIGHT)
      - average.at(OUTCOME) * average.at(INSTRUMENT);
@@ -91,45 +90,23 @@ std::vector<double> InstrumentalPredictionStrategy::compute_variance(
   double main_effect_estimate = (average.at(OUTCOME) - average.at(TREATMENT) * treatment_effect_estimate)
      / average.at(WEIGHT);
 
-  double num_good_groups = 0;
-  double rho_squared = 0;
-  double rho_grouped_squared = 0;
-
-  for (size_t group = 0; group < leaf_values.get_num_nodes() / ci_group_size; ++group) {
-    bool good_group = true;
-    for (size_t j = 0; j < ci_group_size; ++j) {
-      if (leaf_values.empty(group * ci_group_size + j)) {
-        good_group = false;
-      }
-    }
-    if (!good_group) continue;
-
-    num_good_groups++;
-
-    double group_rho = 0;
-
-    for (size_t j = 0; j < ci_group_size; ++j) {
-
-      size_t i = group * ci_group_size + j;
-      const std::vector<double>& leaf_value = leaf_values.get_values(i);
-
-      double psi_1 = leaf_value.at(OUTCOME_INSTRUMENT)
-                     - leaf_value.at(TREATMENT_INSTRUMENT) * treatment_effect_estimate
-                     - leaf_value.at(INSTRUMENT) * main_effect_estimate;
-      double psi_2 = leaf_value.at(OUTCOME)
-                     - leaf_value.at(TREATMENT) * treatment_effect_estimate
-                     - leaf_value.at(WEIGHT) * main_effect_estimate;
-
-      double rho = (average.at(WEIGHT) * psi_1 - average.at(INSTRUMENT) * psi_2)
-          / first_stage_numerator;
-
-      rho_squared += rho * rho;
-      group_rho += rho;
-    }
-
-    group_rho /= ci_group_size;
-    rho_grouped_squared += group_rho * group_rho;
-  }
+  // rho = (average weight * psi_1 - average instrument * psi_2) / first_stage_numerator, where
+  // psi_1 = leaf outcome_instrument - leaf treatment_instrument * tau - leaf instrument * mu and
+  // psi_2 = leaf outcome - leaf treatment * tau - leaf weight * mu.
+  double psi_1_scale = average.at(WEIGHT) / first_stage_numerator;
+  double psi_2_scale = -average.at(INSTRUMENT) / first_stage_numerator;
+  std::vector<double> rho_coefficients(leaf_value_moments.get_num_types(), 0.0);
+  rho_coefficients[OUTCOME_INSTRUMENT] = psi_1_scale;
+  rho_coefficients[TREATMENT_INSTRUMENT] = -psi_1_scale * treatment_effect_estimate;
+  rho_coefficients[INSTRUMENT] = -psi_1_scale * main_effect_estimate;
+  rho_coefficients[OUTCOME] = psi_2_scale;
+  rho_coefficients[TREATMENT] = -psi_2_scale * treatment_effect_estimate;
+  rho_coefficients[WEIGHT] = -psi_2_scale * main_effect_estimate;
+
+  size_t ci_group_size = leaf_value_moments.get_ci_group_size();
+  double num_good_groups = leaf_value_moments.get_num_good_groups();
+  double rho_squared = leaf_value_moments.get_sum_of_squares(rho_coefficients);
+  double rho_grouped_squared = leaf_value_moments.get_sum_of_group_squares(rho_coefficients);
 
   double var_between = rho_grouped_squared / num_good_groups;
   double var_total = rho_squared / (num_good_groups * ci_group_size);
@@ -244,12 +221,12 @@ std::vector<std::pair<double, double>> InstrumentalPredictionStrategy::compute_e
     if (leaf_values.empty(n)) {
       continue;
     }
-    const std::vector<double>& leaf_value = leaf_values.get_values(n);
-    double weight_loto = (num_trees * average.at(WEIGHT) - leaf_value.at(WEIGHT)) / (num_trees - 1);
-    double outcome_loto = (num_trees * average.at(OUTCOME) - leaf_value.at(OUTCOME)) / (num_trees - 1);
-    double instrument_loto = (num_trees * average.at(INSTRUMENT) - leaf_value.at(INSTRUMENT)) / (num_trees - 1);
-    double outcome_instrument_loto = (num_trees * average.at(OUTCOME_INSTRUMENT) - leaf_value.at(OUTCOME_INSTRUMENT)) / (num_trees - 1);
-    double instrument_instrument_loto = (num_trees * average.at(INSTRUMENT_INSTRUMENT) - leaf_value.at(INSTRUMENT_INSTRUMENT)) / (num_trees - 1);
+    const double* leaf_value = leaf_values.get_data(n);
+    double weight_loto = (num_trees * average.at(WEIGHT) - leaf_value[WEIGHT]) / (num_trees - 1);
+    double outcome_loto = (num_trees * average.at(OUTCOME) - leaf_value[OUTCOME]) / (num_trees - 1);
+    double instrument_loto = (num_trees * average.at(INSTRUMENT) - leaf_value[INSTRUMENT]) / (num_trees - 1);
+    double outcome_instrument_loto = (num_trees * average.at(OUTCOME_INSTRUMENT) - leaf_value[OUTCOME_INSTRUMENT]) / (num_trees - 1);
+    double instrument_instrument_loto = (num_trees * average.at(INSTRUMENT_INSTRUMENT) - leaf_value[INSTRUMENT_INSTRUMENT]) / (num_trees - 1);
 
     double reduced_form_numerator_loto = outcome_instrument_loto * weight_loto - outcome_loto * instrument_loto;
     double reduced_form_denominator_loto = instrument_instrument_loto * weight_loto - instrument_loto * instrument_loto;
@@ -268,4 +245,70 @@ std::vector<std::pair<double, double>> InstrumentalPredictionStrategy::compute_e
 
 }
 
+/**
+ * The leave-one-tree-out estimates above are not linear in the leaf values, so the
+ * jackknife cannot be computed exactly from sums over the trees. Instead, each leave-one-tree-out
+ * residual is expanded to first order around the full average: leaving out tree t moves the
+ * averages by (average - x_t) / (num_trees - 1), so that
+ *
+ * residual_loto - residual ~= g . (average - x_t) / (num_trees - 1),
+ *
+ * where g is the gradient of the residual with respect to the averages. The excess error is
+ * then sum (g . (x_t - average))^2 / (num_trees * (num_trees - 1)) = g' M g / (num_trees * (num_trees - 1)),
+ * with M = sum (x_t - average)(x_t - average)'. This is the infinitesimal jackknife,
+ * which agrees with the jackknife above up to terms of higher order in 1 / num_trees.
+ */
+std::vector<std::pair<double, double>> InstrumentalPredictionStrategy::compute_error(
+    size_t sample,
+    const std::vector<double>& average,
+    const std::vector<double>& centered_products,
+    size_t num_trees,
+    const Data& data) const {
+  // As above, do not estimate the error from 5 trees or less.
+  if (num_trees <= 5) {
+    return { std::make_pair<double, double>(NAN, NAN) };
+  }
+
+  double weight = average.at(WEIGHT);
+  double outcome_average = average.at(OUTCOME);
+  double instrument_average = average.at(INSTRUMENT);
+  double numerator = average.at(OUTCOME_INSTRUMENT) * weight - outcome_average * instrument_average;
+  double denominator = average.at(INSTRUMENT_INSTRUMENT) * weight - instrument_average * instrument_average;
+  double reduced_form_estimate = numerator / denominator;
+
+  double outcome = data.get_outcome(sample);
+  double instrument = data.get_instrument(sample);
+  double residual = outcome - (instrument - instrument_average / weight) * reduced_form_estimate
+      - outcome_average / weight;
+  double error_raw = residual * residual;
+
+  // The gradient of the residual, through the reduced form estimate tau = numerator / denominator.
+  double instrument_offset = instrument_average / weight - instrument;
+  std::vector<double> gradient(NUM_TYPES, 0.0);
+  gradient[WEIGHT] = instrument_offset
+      * (average.at(OUTCOME_INSTRUMENT) - reduced_form_estimate * average.at(INSTRUMENT_INSTRUMENT)) / denominator
+      + (outcome_average - instrument_average * reduced_form_estimate) / (weight * weight);
+  gradient[OUTCOME] = -instrument_offset * instrument_average / denominator - 1 / weight;
+  gradient[INSTRUMENT] = instrument_offset
+      * (2 * reduced_form_estimate * instrument_average - outcome_average) / denominator
+      + reduced_form_estimate / weight;
+  gradient[OUTCOME_INSTRUMENT] = instrument_offset * weight / denominator;
+  gradient[INSTRUMENT_INSTRUMENT] = -instrument_offset * reduced_form_estimate * weight / denominator;
+
+  double quadratic_form = 0.0;
+  for (size_t i = 0; i < NUM_TYPES; i++) {
+    for (size_t j = 0; j < NUM_TYPES; j++) {
+      quadratic_form += gradient[i] * centered_products[i * NUM_TYPES + j] * gradient[j];
+    }
+  }
+  double error_bias = quadratic_form / (num_trees * (num_trees - 1.0));
+
+  double debiased_error = error_raw - error_bias;
+  return { std::make_pair(debiased_error, error_bias) };
+}
+
+bool InstrumentalPredictionStrategy::has_streamed_error_estimates() const {
+  return true;
+}
+
 } // namespace grf
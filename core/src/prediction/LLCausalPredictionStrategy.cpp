@@ -20,6 +20,7 @@
 #include "commons/utility.h"
 #include "commons/Data.h"
 #include "prediction/LLCausalPredictionStrategy.h"
+#include "prediction/RidgePathSolver.h"
 
 namespace grf {
 
@@ -43,97 +44,21 @@ std::vector<double> LLCausalPredictionStrategy::predict(
 
   // Number of predictor variables to use in local linear regression step
   size_t num_variables = linear_correction_variables.size();
-
-  size_t num_nonzero_weights = weights_by_sampleID.size();
   size_t num_lambdas = lambdas.size();
 
-  // Creating a vector of neighbor weights weights
-  // Weights by sample ID contains pairs [sample ID, weight for test point]
-  // Weights vec is a vector of weights indexed by their corresponding sample ID
-  // For example:
-  // weights_by_sampleID = [(0, 0.04), (1, 0.20), (3, 0.01), (4, 0.05), ...]
-  // weights_vec = [0.04, 0.20, 0.0, 0.01, 0.05, ....]
-
-  std::vector<size_t> indices(num_nonzero_weights);
-  Eigen::MatrixXd weights_vec = Eigen::VectorXd::Zero(num_nonzero_weights);
-  {
-    size_t i = 0;
-    for (const auto& it : weights_by_sampleID) {
-      size_t index = it.first;
-      double weight = it.second;
-      indices[i] = index;
-      weights_vec(i) = weight;
-      i++;
-    }
-  }
-
-  // The matrix X consists of differences of linear correction variables from their target.
-  // Only observations with nonzero weights need to be filled.
-  // For example, if there are K+1 linear correction variables, and m nonzero weights,
-  //  then X will be:
-  //    1.   (X[0,0] - x[0])   ...   (X[0,K] - x[K]) W[1]
-  //    1.   (X[1,0] - x[0])   ...   (X[1,K] - x[K]) W[2]
-  //    1.   (X[3,0] - x[0])   ...   (X[3,K] - x[K]) W[3]   # Observation 2 is skipped due to zero weights
-
   size_t dim_X = 2 * num_variables + 2;
-  Eigen::MatrixXd X (num_nonzero_weights, dim_X);
-  Eigen::MatrixXd Y (num_nonzero_weights, 1);
   size_t treatment_index = num_variables + 1;
-
-  for (size_t i = 0; i < num_nonzero_weights; ++i) {
-    // Index of next neighbor with nonzero weights
-    size_t index = indices[i];
-    double treatment = train_data.get_treatment(index);
-
-    // Intercept
-    X(i, 0) = 1;
-
-    // Regressors
-    for (size_t j = 0; j < num_variables; ++j){
-      size_t current_predictor = linear_correction_variables[j];
-      // X - x0 column
-      X(i,j+1) = train_data.get(index, current_predictor) -
-                    test_data.get(sampleID, current_predictor);
-      // (X - x0)*W column
-      X(i, treatment_index + j + 1) = X(i, j+1) * treatment;
-    }
-
-    // Treatment (just copied)
-    X(i, treatment_index) = treatment;
-
-    // Outcome (just copied)
-    Y(i) = train_data.get_outcome(index);
-  }
-
-  // find ridge regression predictions
   Eigen::MatrixXd M_unpenalized (dim_X, dim_X);
-  M_unpenalized.noalias() = X.transpose() * weights_vec.asDiagonal() * X;
+  Eigen::VectorXd XWY (dim_X);
+  compute_gram(sampleID, weights_by_sampleID, train_data, test_data, M_unpenalized, XWY);
 
+  // find ridge regression predictions, sharing one factorization across the lambda path.
+  // The intercept and the treatment coefficient are not penalized.
+  RidgePathSolver solver(M_unpenalized, {0, treatment_index}, weight_penalty);
   std::vector<double> predictions(num_lambdas);
-  Eigen::MatrixXd M;
 
   for (size_t i = 0; i < num_lambdas; ++i){
-    double lambda = lambdas[i];
-    M = M_unpenalized;
-    if (!weight_penalty) {
-      double normalization = M_unpenalized.trace() / dim_X;
-
-      // standard ridge penalty
-      for (size_t j = 1; j < dim_X; ++j){
-        if (j != treatment_index){
-          M(j, j) += lambda * normalization;
-        }
-      }
-    } else {
-      // covariance ridge penalty
-      for (size_t j = 1; j < dim_X; ++j){
-        if (j != treatment_index){
-          M(j, j) += lambda * M(j, j);
-        }
-      }
-    }
-
-    Eigen::MatrixXd local_coefficients = M.ldlt().solve(X.transpose()*weights_vec.asDiagonal()*Y);
+    Eigen::VectorXd local_coefficients = solver.solve(XWY, lambdas[i]);
 
     // We're only interested in the coefficient associated with the treatment variable
     predictions[i] = local_coefficients(treatment_index);
@@ -151,94 +76,29 @@ std::vector<double> LLCausalPredictionStrategy::compute_variance(
         size_t ci_group_size) const {
 
   double lambda = lambdas[0];
-
   size_t num_variables = linear_correction_variables.size();
-  size_t num_nonzero_weights = weights_by_sampleID.size();
-
-  std::vector<size_t> sample_index_map(train_data.get_num_rows());
-  std::vector<size_t> indices(num_nonzero_weights);
-
-  Eigen::MatrixXd weights_vec = Eigen::VectorXd::Zero(num_nonzero_weights);
-  {
-    size_t i = 0;
-    for (auto& it : weights_by_sampleID) {
-      size_t index = it.first;
-      double weight = it.second;
-      indices[i] = index;
-      sample_index_map[index] = i;
-      weights_vec(i) = weight;
-      i++;
-    }
-  }
 
   size_t dim_X = 2 * num_variables + 2;
-  Eigen::MatrixXd X (num_nonzero_weights, dim_X);
-  Eigen::MatrixXd Y (num_nonzero_weights, 1);
   size_t treatment_index = num_variables + 1;
-
-  for (size_t i = 0; i < num_nonzero_weights; ++i) {
-    // Index of next neighbor with nonzero weights
-
-    size_t index = indices[i];
-    double treatment = train_data.get_treatment(index);
-
-    // Intercept
-    X(i, 0) = 1;
-
-    // Regressors
-    for (size_t j = 0; j < num_variables; ++j){
-      size_t current_predictor = linear_correction_variables[j];
-      // X - x0 column
-      X(i,j+1) = train_data.get(index, current_predictor) -
-                 test_data.get(sampleID, current_predictor);
-
-      // (X - x0)*W column
-      X(i, treatment_index + j + 1) = X(i, j+1) * treatment;
-    }
-
-    // Treatment (just copied)
-    X(i, treatment_index) = treatment;
-
-    // Outcome (just copied)
-    Y(i) = train_data.get_outcome(index);
-  }
+  Eigen::MatrixXd M (dim_X, dim_X);
+  Eigen::VectorXd XWY (dim_X);
+  compute_gram(sampleID, weights_by_sampleID, train_data, test_data, M, XWY);
 
   // find ridge regression predictions
-  Eigen::MatrixXd M_unpenalized (dim_X, dim_X);
-  M_unpenalized.noalias() = X.transpose() * weights_vec.asDiagonal() * X;
-
-  Eigen::MatrixXd M;
-  M = M_unpenalized;
-  if (!weight_penalty) {
-    double normalization = M_unpenalized.trace() / dim_X;
-
-    // standard ridge penalty
-    for(size_t j = 1; j < dim_X; ++j){
-      if (j != treatment_index){
-        M(j, j) += lambda * normalization;
-      }
-    }
-  } else {
-    // covariance ridge penalty
-    for(size_t j = 1; j < dim_X; ++j){
-      if (j != treatment_index){
-        M(j, j) += lambda * M(j, j);
-      }
-    }
-  }
-
-  Eigen::VectorXd theta = M.ldlt().solve(X.transpose()*weights_vec.asDiagonal()*Y);
+  RidgePathSolver solver(M, {0, treatment_index}, weight_penalty);
+  Eigen::VectorXd theta = solver.solve(XWY, lambda);
 
   Eigen::VectorXd e_trt = Eigen::VectorXd::Zero(dim_X);
   e_trt(treatment_index) = 1.0;
-  Eigen::VectorXd zeta = M.ldlt().solve(e_trt);
-
-  Eigen::VectorXd X_times_zeta = X * zeta;
-  Eigen::VectorXd local_prediction = X * theta;
-  Eigen::VectorXd pseudo_residual = Eigen::VectorXd::Zero(num_nonzero_weights);
-
-  for (size_t i = 0; i < num_nonzero_weights; i++) {
-    pseudo_residual(i) = X_times_zeta(i) * (Y(i) - local_prediction(i));
+  Eigen::VectorXd zeta = solver.solve(e_trt, lambda);
+
+  std::vector<double> pseudo_residual(train_data.get_num_rows());
+  Eigen::VectorXd x (dim_X);
+  for (const auto& it : weights_by_sampleID) {
+    size_t index = it.first;
+    fill_regressors(index, sampleID, train_data, test_data, x);
+    double local_prediction = x.dot(theta);
+    pseudo_residual[index] = x.dot(zeta) * (train_data.get_outcome(index) - local_prediction);
   }
 
   double num_good_groups = 0;
@@ -264,7 +124,7 @@ std::vector<double> LLCausalPredictionStrategy::compute_variance(
       size_t b = group * ci_group_size + j;
       double psi_1 = 0;
       for (size_t sample : samples_by_tree[b]) {
-        psi_1 += pseudo_residual(sample_index_map[sample]);
+        psi_1 += pseudo_residual[sample];
       }
       psi_1 /= samples_by_tree[b].size();
       psi_squared += psi_1 * psi_1;
@@ -294,4 +154,57 @@ std::vector<double> LLCausalPredictionStrategy::compute_variance(
   return { var_debiased };
 }
 
+void LLCausalPredictionStrategy::compute_gram(
+        size_t sampleID,
+        const std::unordered_map<size_t, double>& weights_by_sampleID,
+        const Data& train_data,
+        const Data& test_data,
+        Eigen::MatrixXd& M,
+        Eigen::VectorXd& XWY) const {
+  // Each neighbor with a nonzero weight contributes weight * x x' to X'WX and
+  // weight * Y_i * x to X'WY. Only the lower triangle of X'WX is accumulated.
+  M.setZero();
+  XWY.setZero();
+  Eigen::VectorXd x (M.rows());
+  for (const auto& it : weights_by_sampleID) {
+    size_t index = it.first;
+    double weight = it.second;
+    fill_regressors(index, sampleID, train_data, test_data, x);
+    M.selfadjointView<Eigen::Lower>().rankUpdate(x, weight);
+    XWY.noalias() += (weight * train_data.get_outcome(index)) * x;
+  }
+  M.triangularView<Eigen::StrictlyUpper>() = M.transpose();
+}
+
+void LLCausalPredictionStrategy::fill_regressors(
+        size_t index,
+        size_t sampleID,
+        const Data& train_data,
+        const Data& test_data,
+        Eigen::VectorXd& x) const {
+  // The regressors consist of differences of linear correction variables from their target,
+  // and their interactions with the treatment. For example, if there are K+1 linear correction
+  // variables, then the row for neighbor i is:
+  //    1.   (X[i,0] - x[0])   ...   (X[i,K] - x[K])   W[i]   (X[i,0] - x[0])*W[i]   ...   (X[i,K] - x[K])*W[i]
+  size_t num_variables = linear_correction_variables.size();
+  size_t treatment_index = num_variables + 1;
+  double treatment = train_data.get_treatment(index);
+
+  // Intercept
+  x(0) = 1;
+
+  // Regressors
+  for (size_t j = 0; j < num_variables; ++j){
+    size_t current_predictor = linear_correction_variables[j];
+    // X - x0 column
+    x(j+1) = train_data.get(index, current_predictor) -
+             test_data.get(sampleID, current_predictor);
+    // (X - x0)*W column
+    x(treatment_index + j + 1) = x(j+1) * treatment;
+  }
+
+  // Treatment (just copied)
+  x(treatment_index) = treatment;
+}
+
 } // namespace grf
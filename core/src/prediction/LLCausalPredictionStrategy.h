@@ -49,6 +49,23 @@ public:
             size_t ci_group_size) const;
 
 private:
+    /**
+    * Accumulates the weighted Gram matrix X'WX and cross product X'WY of the local
+    * regression design directly from the neighbor weights, without materializing X.
+    */
+    void compute_gram(size_t sampleID,
+                      const std::unordered_map<size_t, double>& weights_by_sampleID,
+                      const Data& train_data,
+                      const Data& test_data,
+                      Eigen::MatrixXd& M,
+                      Eigen::VectorXd& XWY) const;
+
+    void fill_regressors(size_t index,
+                         size_t sampleID,
+                         const Data& train_data,
+                         const Data& test_data,
+                         Eigen::VectorXd& x) const;
+
     std::vector<double> lambdas;
     bool weight_penalty;
     std::vector<size_t> linear_correction_variables;
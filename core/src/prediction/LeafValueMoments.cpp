@@ -0,0 +1,230 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+
+#include "prediction/LeafValueMoments.h"
+
+namespace grf {
+
+const size_t LeafValueMoments::MAX_MOMENT_TYPES = 4;
+
+LeafValueMoments::LeafValueMoments(size_t num_types, size_t ci_group_size):
+    num_types(num_types),
+    ci_group_size(ci_group_size),
+    store_values(num_types > MAX_MOMENT_TYPES),
+    shift(num_types),
+    group_sum(num_types),
+    group_tree_moments(store_values ? 0 : num_types * num_types),
+    total_sum(num_types),
+    tree_moments(store_values ? 0 : num_types * num_types),
+    group_moments(store_values ? 0 : num_types * num_types),
+    shifted_values(num_types),
+    nonzero_types(store_values ? num_types : 0) {
+  clear();
+}
+
+LeafValueMoments::LeafValueMoments(const PredictionValues& leaf_values, size_t ci_group_size):
+    LeafValueMoments(leaf_values.get_num_types(), ci_group_size) {
+  for (size_t node = 0; node < leaf_values.get_num_nodes(); node++) {
+    if (leaf_values.empty(node)) {
+      add_empty();
+    } else {
+      add(leaf_values.get_data(node));
+    }
+  }
+}
+
+void LeafValueMoments::clear() {
+  has_shift = false;
+  group_position = 0;
+  good_group = true;
+  num_good_groups = 0;
+  std::fill(group_sum.begin(), group_sum.end(), 0.0);
+  std::fill(group_tree_moments.begin(), group_tree_moments.end(), 0.0);
+  std::fill(total_sum.begin(), total_sum.end(), 0.0);
+  std::fill(tree_moments.begin(), tree_moments.end(), 0.0);
+  std::fill(group_moments.begin(), group_moments.end(), 0.0);
+  tree_values.clear();
+  group_start = 0;
+}
+
+void LeafValueMoments::add(const double* values) {
+  if (!has_shift) {
+    std::copy(values, values + num_types, shift.begin());
+    has_shift = true;
+  }
+
+  if (good_group && store_values) {
+    for (size_t i = 0; i < num_types; i++) {
+      tree_values.push_back(values[i] - shift[i]);
+    }
+  } else if (good_group) {
+    for (size_t i = 0; i < num_types; i++) {
+      shifted_values[i] = values[i] - shift[i];
+      group_sum[i] += shifted_values[i];
+    }
+    for (size_t i = 0; i < num_types; i++) {
+      double* row = &group_tree_moments[i * num_types];
+      for (size_t j = 0; j < num_types; j++) {
+        row[j] += shifted_values[i] * shifted_values[j];
+      }
+    }
+  }
+
+  if (++group_position == ci_group_size) {
+    finish_group();
+  }
+}
+
+void LeafValueMoments::add_empty() {
+  good_group = false;
+  if (++group_position == ci_group_size) {
+    finish_group();
+  }
+}
+
+void LeafValueMoments::finish_group() {
+  if (good_group && store_values) {
+    num_good_groups++;
+  } else if (!good_group && store_values) {
+    tree_values.resize(group_start);
+  } else if (good_group) {
+    num_good_groups++;
+    for (size_t i = 0; i < num_types; i++) {
+      total_sum[i] += group_sum[i];
+      for (size_t j = 0; j < num_types; j++) {
+        tree_moments[i * num_types + j] += group_tree_moments[i * num_types + j];
+        group_moments[i * num_types + j] += group_sum[i] * group_sum[j];
+      }
+    }
+  }
+
+  group_position = 0;
+  good_group = true;
+  group_start = tree_values.size();
+  std::fill(group_sum.begin(), group_sum.end(), 0.0);
+  std::fill(group_tree_moments.begin(), group_tree_moments.end(), 0.0);
+}
+
+double LeafValueMoments::get_sum_of_squares(const std::vector<double>& coefficients) const {
+  double sum_of_scores = 0;
+  double sum_of_squares = 0;
+  if (store_values) {
+    for (double score : get_tree_scores(coefficients)) {
+      sum_of_scores += score;
+      sum_of_squares += score * score;
+    }
+  } else {
+    sum_of_scores = dot(total_sum.data(), coefficients);
+    sum_of_squares = quadratic_form(tree_moments, coefficients);
+  }
+
+  // With x = x' + shift: sum (a . x)^2 = sum (a . x')^2 + 2 (a . shift) (a . sum x') + n (a . shift)^2.
+  double shift_score = dot(shift.data(), coefficients);
+  double num_trees = num_good_groups * ci_group_size;
+  return sum_of_squares
+      + 2 * shift_score * sum_of_scores
+      + num_trees * shift_score * shift_score;
+}
+
+double LeafValueMoments::get_sum_of_group_squares(const std::vector<double>& coefficients) const {
+  double sum_of_scores = 0;
+  double sum_of_squares = 0;
+  if (store_values) {
+    const std::vector<double>& scores = get_tree_scores(coefficients);
+    for (size_t group = 0; group < scores.size(); group += ci_group_size) {
+      double group_score = 0;
+      for (size_t tree = group; tree < group + ci_group_size; tree++) {
+        group_score += scores[tree];
+      }
+      sum_of_scores += group_score;
+      sum_of_squares += group_score * group_score;
+    }
+  } else {
+    sum_of_scores = dot(total_sum.data(), coefficients);
+    sum_of_squares = quadratic_form(group_moments, coefficients);
+  }
+
+  // Each group sum is S = S' + ci_group_size * shift, and the group mean is S / ci_group_size.
+  double shift_score = ci_group_size * dot(shift.data(), coefficients);
+  sum_of_squares += 2 * shift_score * sum_of_scores
+      + num_good_groups * shift_score * shift_score;
+  return sum_of_squares / (ci_group_size * ci_group_size);
+}
+
+double LeafValueMoments::get_num_good_groups() const {
+  return num_good_groups;
+}
+
+size_t LeafValueMoments::get_ci_group_size() const {
+  return ci_group_size;
+}
+
+size_t LeafValueMoments::get_num_types() const {
+  return num_types;
+}
+
+double LeafValueMoments::quadratic_form(const std::vector<double>& matrix,
+                                        const std::vector<double>& coefficients) const {
+  double result = 0;
+  for (size_t i = 0; i < num_types; i++) {
+    if (coefficients[i] == 0) {
+      continue;
+    }
+    double row_sum = 0;
+    for (size_t j = 0; j < num_types; j++) {
+      row_sum += matrix[i * num_types + j] * coefficients[j];
+    }
+    result += coefficients[i] * row_sum;
+  }
+  return result;
+}
+
+const std::vector<double>& LeafValueMoments::get_tree_scores(const std::vector<double>& coefficients) const {
+  // Coefficients are often sparse, e.g. a probability forest's score for one class
+  // only involves that class and the weight.
+  size_t num_nonzero = 0;
+  for (size_t type = 0; type < num_types; type++) {
+    if (coefficients[type] != 0) {
+      nonzero_types[num_nonzero++] = type;
+    }
+  }
+
+  // Values past group_start belong to a group that is not complete yet.
+  tree_scores.resize(group_start / num_types);
+  for (size_t tree = 0; tree < tree_scores.size(); tree++) {
+    const double* values = &tree_values[tree * num_types];
+    double score = 0;
+    for (size_t i = 0; i < num_nonzero; i++) {
+      score += values[nonzero_types[i]] * coefficients[nonzero_types[i]];
+    }
+    tree_scores[tree] = score;
+  }
+  return tree_scores;
+}
+
+double LeafValueMoments::dot(const double* values,
+                             const std::vector<double>& coefficients) const {
+  double result = 0;
+  for (size_t i = 0; i < num_types; i++) {
+    result += values[i] * coefficients[i];
+  }
+  return result;
+}
+
+} // namespace grf
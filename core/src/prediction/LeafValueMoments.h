@@ -0,0 +1,145 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_LEAFVALUEMOMENTS_H
+#define GRF_LEAFVALUEMOMENTS_H
+
+#include <cstddef>
+#include <vector>
+
+#include "prediction/PredictionValues.h"
+
+namespace grf {
+
+/**
+ * Running first and second moments of the leaf prediction values a test sample
+ * falls into, grouped by the forest's ci groups.
+ *
+ * Variance estimates of optimized prediction strategies are built from a per-tree
+ * score rho = a . x that is linear in the tree's leaf values x, where the coefficients
+ * a depend on the averaged prediction values. Those are only known once every tree has
+ * been visited, so instead of keeping each tree's leaf values, this class accumulates
+ * sum x x' over the trees of complete ("good") groups and sum S S' over the group sums S.
+ * The sums of rho^2 and of the squared group means of rho then follow as quadratic
+ * forms in a.
+ *
+ * Accumulating sum x x' takes num_types^2 operations per tree, which only pays off for
+ * a few types. With more than MAX_MOMENT_TYPES types, the leaf values of the good groups
+ * are instead kept as they are added, and rho is evaluated per tree when the sums are
+ * requested, so that both adding a tree and evaluating its score take num_types
+ * operations.
+ *
+ * To avoid cancellation in these quadratic forms, all values are accumulated after
+ * subtracting the first leaf values seen, which are typically close to the average.
+ *
+ * Leaves must be added in tree order, one call per tree. A group only counts if all of
+ * its trees have leaf values, mirroring the original per-tree variance computations.
+ */
+class LeafValueMoments {
+public:
+  LeafValueMoments(size_t num_types, size_t ci_group_size);
+
+  /**
+   * Accumulates the given per-tree leaf values, where empty nodes are trees without
+   * leaf values for the sample.
+   */
+  LeafValueMoments(const PredictionValues& leaf_values, size_t ci_group_size);
+
+  /**
+   * Resets all moments, keeping the allocated storage so it can be reused for the
+   * next test sample.
+   */
+  void clear();
+
+  /**
+   * Adds the num_types leaf values of the next tree.
+   */
+  void add(const double* values);
+
+  /**
+   * Records that the next tree has no leaf values for this sample, so that its
+   * group is excluded.
+   */
+  void add_empty();
+
+  /**
+   * The sum over the trees of all good groups of (coefficients . x)^2.
+   */
+  double get_sum_of_squares(const std::vector<double>& coefficients) const;
+
+  /**
+   * The sum over all good groups of the squared group mean of (coefficients . x).
+   */
+  double get_sum_of_group_squares(const std::vector<double>& coefficients) const;
+
+  double get_num_good_groups() const;
+  size_t get_ci_group_size() const;
+  size_t get_num_types() const;
+
+  /**
+   * The largest number of types for which second moments are accumulated, rather
+   * than keeping the leaf values of each tree.
+   */
+  static const size_t MAX_MOMENT_TYPES;
+
+private:
+  void finish_group();
+  double quadratic_form(const std::vector<double>& matrix,
+                        const std::vector<double>& coefficients) const;
+
+  /**
+   * The scores (coefficients . x') of the stored trees of all good groups, in tree order.
+   * The scores are computed into tree_scores, which is overwritten by the next call.
+   */
+  const std::vector<double>& get_tree_scores(const std::vector<double>& coefficients) const;
+
+  double dot(const double* values,
+             const std::vector<double>& coefficients) const;
+
+  size_t num_types;
+  size_t ci_group_size;
+  bool store_values;
+
+  bool has_shift;
+  std::vector<double> shift;
+
+  size_t group_position;
+  bool good_group;
+  std::vector<double> group_sum;
+  std::vector<double> group_tree_moments;
+
+  double num_good_groups;
+  std::vector<double> total_sum;
+  std::vector<double> tree_moments;
+  std::vector<double> group_moments;
+
+  std::vector<double> shifted_values;
+
+  // The shifted leaf values of the trees in good groups, if store_values is set. The
+  // values of completed groups end at group_start.
+  std::vector<double> tree_values;
+  size_t group_start;
+
+  // Buffers for get_tree_scores, which is called for every sample and coefficient vector.
+  // They keep their storage across calls, so that computing the scores does not allocate.
+  mutable std::vector<size_t> nonzero_types;
+  mutable std::vector<double> tree_scores;
+};
+
+} // namespace grf
+
+#endif //GRF_LEAFVALUEMOMENTS_H
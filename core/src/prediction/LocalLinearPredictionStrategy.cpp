@@ -20,6 +20,7 @@
 #include "commons/utility.h"
 #include "commons/Data.h"
 #include "prediction/LocalLinearPredictionStrategy.h"
+#include "prediction/RidgePathSolver.h"
 
 namespace grf {
 
@@ -41,60 +42,19 @@ std::vector<double> LocalLinearPredictionStrategy::predict(
     const Data& train_data,
     const Data& data) const {
   size_t num_variables = linear_correction_variables.size();
-  size_t num_nonzero_weights = weights_by_sampleID.size();
-
-  std::vector<size_t> indices(num_nonzero_weights);
-  Eigen::MatrixXd weights_vec = Eigen::VectorXd::Zero(num_nonzero_weights);
-  {
-    size_t i = 0;
-    for (auto& it : weights_by_sampleID) {
-      size_t index = it.first;
-      double weight = it.second;
-      indices[i] = index;
-      weights_vec(i) = weight;
-      i++;
-    }
-  }
-
-  Eigen::MatrixXd X (num_nonzero_weights, num_variables+1);
-  Eigen::MatrixXd Y (num_nonzero_weights, 1);
-  for (size_t i = 0; i < num_nonzero_weights; ++i) {
-    for (size_t j = 0; j < num_variables; ++j){
-      size_t current_predictor = linear_correction_variables[j];
-      X(i,j+1) = train_data.get(indices[i],current_predictor)
-                 - data.get(sampleID, current_predictor);
-    }
-    Y(i) = train_data.get_outcome(indices[i]);
-    X(i, 0) = 1;
-  }
 
-  // find ridge regression predictions
-  Eigen::MatrixXd M_unpenalized(num_variables+1, num_variables+1);
-  M_unpenalized.noalias() = X.transpose()*weights_vec.asDiagonal()*X;
+  Eigen::MatrixXd M_unpenalized(num_variables + 1, num_variables + 1);
+  Eigen::VectorXd XWY(num_variables + 1);
+  compute_gram(sampleID, weights_by_sampleID, train_data, data, M_unpenalized, XWY);
 
-  Eigen::MatrixXd M;
+  // find ridge regression predictions, sharing one factorization across the lambda path
+  RidgePathSolver solver(M_unpenalized, {0}, weight_penalty);
   size_t num_lambdas = lambdas.size();
   std::vector<double> predictions(num_lambdas);
 
   for (size_t i = 0; i < num_lambdas; ++i){
-    double lambda = lambdas[i];
-    M = M_unpenalized;
-
-    if (!weight_penalty) {
-      // standard ridge penalty
-      double normalization = M.trace() / (num_variables + 1);
-      for (size_t j = 1; j < num_variables + 1; ++j){
-        M(j,j) += lambda * normalization;
-      }
-    } else {
-      // covariance ridge penalty
-      for (size_t j = 1; j < num_variables+1; ++j){
-        M(j,j) += lambda * M(j,j); // note that the weights are already normalized
-      }
-    }
-
-    Eigen::MatrixXd local_coefficients = M.ldlt().solve(X.transpose()*weights_vec.asDiagonal()*Y);
-    predictions[i] =  local_coefficients(0);
+    Eigen::VectorXd local_coefficients = solver.solve(XWY, lambdas[i]);
+    predictions[i] = local_coefficients(0);
   }
 
   return predictions;
@@ -109,65 +69,31 @@ std::vector<double> LocalLinearPredictionStrategy::compute_variance(
     size_t ci_group_size) const {
 
   double lambda = lambdas[0];
-
   size_t num_variables = linear_correction_variables.size();
-  size_t num_nonzero_weights = weights_by_sampleID.size();
-
-  std::vector<size_t> sample_index_map(train_data.get_num_rows());
-  std::vector<size_t> indices(num_nonzero_weights);
-
-  Eigen::MatrixXd weights_vec = Eigen::VectorXd::Zero(num_nonzero_weights);
-    {
-      size_t i = 0;
-      for (const auto& it : weights_by_sampleID) {
-        size_t index = it.first;
-        double weight = it.second;
-        indices[i] = index;
-        sample_index_map[index] = i;
-        weights_vec(i) = weight;
-        i++;
-      }
-  }
 
-  Eigen::MatrixXd X (num_nonzero_weights, num_variables+1);
-  Eigen::MatrixXd Y (num_nonzero_weights, 1);
-  for (size_t i = 0; i < num_nonzero_weights; ++i) {
-    X(i, 0) = 1;
-    for (size_t j = 0; j < num_variables; ++j){
-      size_t current_predictor = linear_correction_variables[j];
-      X(i,j+1) = train_data.get(indices[i],current_predictor)
-                 - data.get(sampleID, current_predictor);
-    }
-    Y(i) = train_data.get_outcome(indices[i]);
-  }
+  Eigen::MatrixXd M(num_variables + 1, num_variables + 1);
+  Eigen::VectorXd XWY(num_variables + 1);
+  compute_gram(sampleID, weights_by_sampleID, train_data, data, M, XWY);
 
   // find ridge regression predictions
-  Eigen::MatrixXd M (num_variables+1, num_variables+1);
-  M.noalias() = X.transpose()*weights_vec.asDiagonal()*X;
-
-  if (!weight_penalty) {
-    double normalization = M.trace() / (num_variables + 1);
-    for (size_t i = 1; i < num_variables + 1; ++i){
-      M(i,i) += lambda * normalization;
-    }
-  } else {
-    for (size_t i = 1; i < num_variables+1; ++i){
-      M(i,i) += lambda * M(i,i);
-    }
-  }
-
-  Eigen::VectorXd theta = M.ldlt().solve(X.transpose()*weights_vec.asDiagonal()*Y);
+  RidgePathSolver solver(M, {0}, weight_penalty);
+  Eigen::VectorXd theta = solver.solve(XWY, lambda);
 
   Eigen::VectorXd e_one = Eigen::VectorXd::Zero(num_variables+1);
   e_one(0) = 1.0;
-  Eigen::VectorXd zeta = M.ldlt().solve(e_one);
-
-  Eigen::VectorXd X_times_zeta = X * zeta;
-  Eigen::VectorXd local_prediction = X * theta;
-  Eigen::VectorXd pseudo_residual = Eigen::VectorXd::Zero(num_nonzero_weights);
+  Eigen::VectorXd zeta = solver.solve(e_one, lambda);
 
-  for (size_t i = 0; i < num_nonzero_weights; i++) {
-    pseudo_residual(i) = X_times_zeta(i) * (Y(i) - local_prediction(i));
+  std::vector<double> pseudo_residual(train_data.get_num_rows());
+  Eigen::VectorXd x(num_variables + 1);
+  x(0) = 1;
+  for (const auto& it : weights_by_sampleID) {
+    size_t index = it.first;
+    for (size_t j = 0; j < num_variables; ++j){
+      size_t current_predictor = linear_correction_variables[j];
+      x(j+1) = train_data.get(index, current_predictor) - data.get(sampleID, current_predictor);
+    }
+    double local_prediction = x.dot(theta);
+    pseudo_residual[index] = x.dot(zeta) * (train_data.get_outcome(index) - local_prediction);
   }
 
   double num_good_groups = 0;
@@ -193,7 +119,7 @@ std::vector<double> LocalLinearPredictionStrategy::compute_variance(
       size_t b = group * ci_group_size + j;
       double psi_1 = 0;
       for (size_t sample : samples_by_tree[b]){
-        psi_1 += pseudo_residual(sample_index_map[sample]);
+        psi_1 += pseudo_residual[sample];
       }
       psi_1 /= samples_by_tree[b].size();
       psi_squared += psi_1 * psi_1;
@@ -223,4 +149,36 @@ std::vector<double> LocalLinearPredictionStrategy::compute_variance(
   return { var_debiased };
 }
 
+void LocalLinearPredictionStrategy::compute_gram(
+    size_t sampleID,
+    const std::unordered_map<size_t, double>& weights_by_sampleID,
+    const Data& train_data,
+    const Data& data,
+    Eigen::MatrixXd& M,
+    Eigen::VectorXd& XWY) const {
+  size_t num_variables = linear_correction_variables.size();
+
+  std::vector<double> test_point(num_variables);
+  for (size_t j = 0; j < num_variables; ++j) {
+    test_point[j] = data.get(sampleID, linear_correction_variables[j]);
+  }
+
+  // Each neighbor contributes weight * x x' to X'WX, where x = (1, X_i - x0), and
+  // weight * Y_i * x to X'WY. Only the lower triangle is accumulated.
+  M.setZero();
+  XWY.setZero();
+  Eigen::VectorXd x(num_variables + 1);
+  x(0) = 1;
+  for (const auto& it : weights_by_sampleID) {
+    size_t index = it.first;
+    double weight = it.second;
+    for (size_t j = 0; j < num_variables; ++j) {
+      x(j+1) = train_data.get(index, linear_correction_variables[j]) - test_point[j];
+    }
+    M.selfadjointView<Eigen::Lower>().rankUpdate(x, weight);
+    XWY.noalias() += (weight * train_data.get_outcome(index)) * x;
+  }
+  M.triangularView<Eigen::StrictlyUpper>() = M.transpose();
+}
+
 } // namespace grf
@@ -59,6 +59,17 @@ public:
         size_t ci_group_size) const;
 
 private:
+    /**
+    * Accumulates the weighted Gram matrix X'WX and cross product X'WY of the local
+    * regression design x = (1, X_i - x0) directly from the neighbor weights.
+    */
+    void compute_gram(size_t sampleID,
+                      const std::unordered_map<size_t, double>& weights_by_sampleID,
+                      const Data& train_data,
+                      const Data& data,
+                      Eigen::MatrixXd& M,
+                      Eigen::VectorXd& XWY) const;
+
     std::vector<double> lambdas;
     bool weight_penalty;
     std::vector<size_t> linear_correction_variables;
@@ -15,6 +15,7 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -81,8 +82,7 @@ std::vector<double> MultiCausalPredictionStrategy::predict(const std::vector<dou
  */
 std::vector<double> MultiCausalPredictionStrategy::compute_variance(
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
-    size_t ci_group_size) const {
+    const LeafValueMoments& leaf_value_moments) const {
   if (num_outcomes > 1) {
     throw std::runtime_error("Pointwise variance estimates are only implemented for one outcome.");
   }
@@ -102,44 +102,31 @@ std::vector<double> MultiCausalPredictionStrategy::compute_variance(
   Eigen::MatrixXd term1 = WW_bar.inverse() + 1 / k * WW_bar.inverse() * W_bar * W_bar.transpose() * WW_bar.inverse();
   Eigen::VectorXd term2 = 1 / k * WW_bar.inverse() * W_bar;
 
-  double num_good_groups = 0;
+  size_t ci_group_size = leaf_value_moments.get_ci_group_size();
+  double num_good_groups = leaf_value_moments.get_num_good_groups();
   Eigen::VectorXd rho_squared = Eigen::VectorXd::Zero(num_treatments);
   Eigen::VectorXd rho_grouped_squared = Eigen::VectorXd::Zero(num_treatments);
 
-  Eigen::VectorXd group_rho = Eigen::VectorXd(num_treatments);
-  Eigen::VectorXd psi_1 = Eigen::VectorXd(num_treatments);
-  Eigen::VectorXd rho = Eigen::VectorXd(num_treatments);
-  for (size_t group = 0; group < leaf_values.get_num_nodes() / ci_group_size; ++group) {
-    bool good_group = true;
-    for (size_t j = 0; j < ci_group_size; ++j) {
-      if (leaf_values.empty(group * ci_group_size + j)) {
-        good_group = false;
+  // Each component of rho = term1 * psi_1 - term2 * psi_2 is linear in the leaf values, where
+  // psi_1 = leaf_YW - leaf_WW * theta - leaf_W * main_effect and
+  // psi_2 = leaf_Y - leaf_W' * theta - leaf_weight * main_effect.
+  // leaf_WW is stored in column-major order, so entry (l, m) is at WW_index + l + m * num_treatments.
+  std::vector<double> rho_coefficients(leaf_value_moments.get_num_types());
+  for (size_t k = 0; k < num_treatments; k++) {
+    std::fill(rho_coefficients.begin(), rho_coefficients.end(), 0.0);
+    for (size_t l = 0; l < num_treatments; l++) {
+      rho_coefficients[YW_index + l] += term1(k, l);
+      rho_coefficients[W_index + l] -= term1(k, l) * main_effect;
+      for (size_t m = 0; m < num_treatments; m++) {
+        rho_coefficients[WW_index + l + m * num_treatments] -= term1(k, l) * theta(m);
       }
+      rho_coefficients[W_index + l] += term2(k) * theta(l);
     }
-    if (!good_group) continue;
-
-    num_good_groups++;
-    group_rho.setZero();
-    for (size_t j = 0; j < ci_group_size; ++j) {
-
-      size_t i = group * ci_group_size + j;
-      const std::vector<double>& leaf_value = leaf_values.get_values(i);
-      double leaf_weight = leaf_value[weight_index];
-      double leaf_Y = leaf_value[Y_index];
-      Eigen::Map<const Eigen::VectorXd> leaf_W(leaf_value.data() + W_index, num_treatments);
-      Eigen::Map<const Eigen::VectorXd> leaf_YW(leaf_value.data() + YW_index, num_treatments);
-      Eigen::Map<const Eigen::MatrixXd> leaf_WW(leaf_value.data() + WW_index, num_treatments, num_treatments);
-
-      psi_1 = leaf_YW - leaf_WW * theta - leaf_W * main_effect;
-      double psi_2 = leaf_Y - leaf_W.transpose() * theta - leaf_weight * main_effect;
-
-      rho = term1 * psi_1 - term2 * psi_2;
-      rho_squared += rho.array().square().matrix();
-      group_rho += rho;
-    }
+    rho_coefficients[Y_index] -= term2(k);
+    rho_coefficients[weight_index] += term2(k) * main_effect;
 
-    group_rho /= static_cast<double>(ci_group_size);
-    rho_grouped_squared += group_rho.array().square().matrix();
+    rho_squared(k) = leaf_value_moments.get_sum_of_squares(rho_coefficients);
+    rho_grouped_squared(k) = leaf_value_moments.get_sum_of_group_squares(rho_coefficients);
   }
 
   Eigen::VectorXd var_between = rho_grouped_squared / num_good_groups;
@@ -227,4 +214,17 @@ std::vector<std::pair<double, double>> MultiCausalPredictionStrategy::compute_er
   return { std::make_pair<double, double>(NAN, NAN) };
 }
 
+std::vector<std::pair<double, double>> MultiCausalPredictionStrategy::compute_error(
+    size_t sample,
+    const std::vector<double>& average,
+    const std::vector<double>& centered_products,
+    size_t num_trees,
+    const Data& data) const {
+  return { std::make_pair<double, double>(NAN, NAN) };
+}
+
+bool MultiCausalPredictionStrategy::has_streamed_error_estimates() const {
+  return false;
+}
+
 } // namespace grf
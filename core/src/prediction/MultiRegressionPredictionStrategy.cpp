@@ -44,8 +44,7 @@ std::vector<double> MultiRegressionPredictionStrategy::predict(const std::vector
 
 std::vector<double> MultiRegressionPredictionStrategy::compute_variance(
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
-    size_t ci_group_size) const {
+    const LeafValueMoments& leaf_value_moments) const {
   return { 0.0 };
 }
 
@@ -99,4 +98,17 @@ std::vector<std::pair<double, double>> MultiRegressionPredictionStrategy::comput
   return { std::make_pair<double, double>(NAN, NAN) };
 }
 
+std::vector<std::pair<double, double>> MultiRegressionPredictionStrategy::compute_error(
+    size_t sample,
+    const std::vector<double>& average,
+    const std::vector<double>& centered_products,
+    size_t num_trees,
+    const Data& data) const {
+  return { std::make_pair<double, double>(NAN, NAN) };
+}
+
+bool MultiRegressionPredictionStrategy::has_streamed_error_estimates() const {
+  return false;
+}
+
 } // namespace grf
@@ -22,6 +22,7 @@
 
 #include "commons/globals.h"
 #include "commons/Data.h"
+#include "prediction/LeafValueMoments.h"
 #include "prediction/Prediction.h"
 #include "prediction/PredictionValues.h"
 
@@ -60,16 +61,13 @@ public:
   *
   * average_prediction_values: the 'prediction values' computed during training,
   *     averaged across all leaves this test sample landed in.
-  * leaf_prediction_values: the individual 'prediction values' for each leaf this test
-  *     sample landed in. There will be one entry per tree, even if that tree was OOB or
-  *     the leaf was empty.
-  * ci_group_size: the size of the tree groups used to train the forest. This
-  *     parameter is used when computing within vs. across group variance.
+  * leaf_value_moments: the moments of the individual 'prediction values' of each leaf
+  *     this test sample landed in, accumulated per ci group while the trees were visited.
+  *     Please see LeafValueMoments for how a variance estimate is obtained from them.
   */
   virtual std::vector<double> compute_variance(
       const std::vector<double>& average_prediction_values,
-      const PredictionValues& leaf_prediction_values,
-      size_t ci_group_size) const = 0;
+      const LeafValueMoments& leaf_value_moments) const = 0;
 
  /**
   * The number of types of precomputed prediction values. For regression
@@ -106,6 +104,32 @@ public:
       const std::vector<double>& average,
       const PredictionValues& leaf_values,
       const Data& data) const = 0;
+
+ /**
+  * Computes the same pair of error estimates from running sums over the trees instead of
+  * their individual leaf values, so that they can be kept up to date while trees are added
+  * to a forest, see OOBPredictionAccumulator.
+  *
+  * centered_products: the sum of (x - average)(x - average)' over the leaf values x of the
+  *     num_trees trees, as a row-major prediction_value_length() x prediction_value_length()
+  *     matrix. Centering keeps the estimates precise when the leaf values are large relative
+  *     to their spread across trees.
+  *
+  * Strategies whose error estimates cannot be obtained from these sums return NaN, see
+  * has_streamed_error_estimates.
+  */
+  virtual std::vector<std::pair<double, double>> compute_error(
+      size_t sample,
+      const std::vector<double>& average,
+      const std::vector<double>& centered_products,
+      size_t num_trees,
+      const Data& data) const = 0;
+
+ /**
+  * Whether compute_error above gives error estimates. If not, callers can skip summing the
+  * value products, which take prediction_value_length()^2 / 2 values per sample.
+  */
+  virtual bool has_streamed_error_estimates() const = 0;
 };
 
 } // namespace grf
@@ -15,24 +15,26 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <utility>
+
 #include "prediction/Prediction.h"
 
 namespace grf {
 
-Prediction::Prediction(const std::vector<double>& predictions):
-  predictions(predictions),
+Prediction::Prediction(std::vector<double> predictions):
+  predictions(std::move(predictions)),
   variance_estimates(0),
   error_estimates(0),
   excess_error_estimates(0) {}
 
-Prediction::Prediction(const std::vector<double>& predictions,
-                       const std::vector<double>& variance_estimates,
-                       const std::vector<double>& error_estimates,
-                       const std::vector<double>& excess_error_estimates):
-  predictions(predictions),
-  variance_estimates(variance_estimates),
-  error_estimates(error_estimates),
-  excess_error_estimates(excess_error_estimates) {}
+Prediction::Prediction(std::vector<double> predictions,
+                       std::vector<double> variance_estimates,
+                       std::vector<double> error_estimates,
+                       std::vector<double> excess_error_estimates):
+  predictions(std::move(predictions)),
+  variance_estimates(std::move(variance_estimates)),
+  error_estimates(std::move(error_estimates)),
+  excess_error_estimates(std::move(excess_error_estimates)) {}
 
 const std::vector<double>& Prediction::get_predictions() const {
   return predictions;
@@ -25,12 +25,12 @@ namespace grf {
 
 class Prediction {
 public:
-  Prediction(const std::vector<double>& predictions);
+  Prediction(std::vector<double> predictions);
 
-  Prediction(const std::vector<double>& predictions,
-             const std::vector<double>& variance_estimates,
-             const std::vector<double>& error_estimates,
-             const std::vector<double>& excess_error_estimates);
+  Prediction(std::vector<double> predictions,
+             std::vector<double> variance_estimates,
+             std::vector<double> error_estimates,
+             std::vector<double> excess_error_estimates);
 
   const std::vector<double>& get_predictions() const;
   const std::vector<double>& get_variance_estimates() const;
@@ -0,0 +1,126 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "prediction/PredictionOutput.h"
+
+namespace grf {
+
+PredictionOutput::PredictionOutput(size_t num_samples,
+                                   size_t prediction_length,
+                                   double* predictions,
+                                   double* variance_estimates,
+                                   double* error_estimates,
+                                   double* excess_error_estimates):
+  num_samples(num_samples),
+  prediction_length(prediction_length),
+  predictions(predictions),
+  variance_estimates(variance_estimates),
+  error_estimates(error_estimates),
+  excess_error_estimates(excess_error_estimates) {}
+
+void PredictionOutput::set_predictions(size_t sample, const std::vector<double>& values) {
+  if (values.size() != prediction_length) {
+    throw std::runtime_error("Prediction for sample " + std::to_string(sample) +
+                             " did not have the expected length.");
+  }
+  for (size_t j = 0; j < prediction_length; j++) {
+    predictions[sample + j * num_samples] = values[j];
+  }
+}
+
+void PredictionOutput::set_variance_estimates(size_t sample, const std::vector<double>& values) {
+  if (variance_estimates == nullptr) {
+    return;
+  }
+  if (values.size() > prediction_length) {
+    throw std::runtime_error("Variance estimate for sample " + std::to_string(sample) +
+                             " was longer than the prediction.");
+  }
+  for (size_t j = 0; j < prediction_length; j++) {
+    variance_estimates[sample + j * num_samples] = j < values.size() ? values[j] : 0.0;
+  }
+}
+
+void PredictionOutput::set_error_estimates(size_t sample, double error, double excess_error) {
+  if (error_estimates != nullptr) {
+    error_estimates[sample] = error;
+  }
+  if (excess_error_estimates != nullptr) {
+    excess_error_estimates[sample] = excess_error;
+  }
+}
+
+void PredictionOutput::set_missing(size_t sample) {
+  for (size_t j = 0; j < prediction_length; j++) {
+    predictions[sample + j * num_samples] = NAN;
+    if (variance_estimates != nullptr) {
+      variance_estimates[sample + j * num_samples] = NAN;
+    }
+  }
+  set_error_estimates(sample, NAN, NAN);
+}
+
+std::vector<Prediction> PredictionOutput::to_predictions() const {
+  std::vector<Prediction> result;
+  result.reserve(num_samples);
+
+  for (size_t sample = 0; sample < num_samples; sample++) {
+    std::vector<double> sample_predictions(prediction_length);
+    std::vector<double> sample_variance(variance_estimates != nullptr ? prediction_length : 0);
+    for (size_t j = 0; j < prediction_length; j++) {
+      sample_predictions[j] = predictions[sample + j * num_samples];
+      if (variance_estimates != nullptr) {
+        sample_variance[j] = variance_estimates[sample + j * num_samples];
+      }
+    }
+
+    std::vector<double> error;
+    std::vector<double> excess_error;
+    if (error_estimates != nullptr) {
+      error.push_back(error_estimates[sample]);
+    }
+    if (excess_error_estimates != nullptr) {
+      excess_error.push_back(excess_error_estimates[sample]);
+    }
+
+    result.emplace_back(std::move(sample_predictions), std::move(sample_variance),
+                        std::move(error), std::move(excess_error));
+  }
+  return result;
+}
+
+size_t PredictionOutput::get_num_samples() const {
+  return num_samples;
+}
+
+size_t PredictionOutput::get_prediction_length() const {
+  return prediction_length;
+}
+
+bool PredictionOutput::has_variance_estimates() const {
+  return variance_estimates != nullptr;
+}
+
+bool PredictionOutput::has_error_estimates() const {
+  return error_estimates != nullptr;
+}
+
+} // namespace grf
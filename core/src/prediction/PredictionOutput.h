@@ -0,0 +1,94 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_PREDICTIONOUTPUT_H
+#define GRF_PREDICTIONOUTPUT_H
+
+#include <cstddef>
+#include <vector>
+
+#include "prediction/Prediction.h"
+
+namespace grf {
+
+/**
+ * Columnar output buffers that prediction collectors write into directly, so that
+ * predicting does not allocate a Prediction object per sample.
+ *
+ * The buffers are owned by the caller, and are laid out in column-major order like R
+ * matrices: the value of column j for sample i is stored at index i + j * num_samples.
+ * predictions and variance_estimates have prediction_length columns, while
+ * error_estimates and excess_error_estimates have a single column. The optional
+ * buffers may be null, in which case those estimates are not written.
+ *
+ * Different samples occupy disjoint entries, so threads can fill disjoint ranges of
+ * samples concurrently.
+ */
+class PredictionOutput {
+public:
+  PredictionOutput(size_t num_samples,
+                   size_t prediction_length,
+                   double* predictions,
+                   double* variance_estimates,
+                   double* error_estimates,
+                   double* excess_error_estimates);
+
+  /**
+   * Writes the predictions for a sample, which must have prediction_length values.
+   */
+  void set_predictions(size_t sample, const std::vector<double>& values);
+
+  /**
+   * Writes the variance estimates for a sample, if variance estimates were requested.
+   * Strategies that do not estimate variance return a single placeholder value, so
+   * any columns not covered by values are set to zero.
+   */
+  void set_variance_estimates(size_t sample, const std::vector<double>& values);
+
+  /**
+   * Writes the error estimates for a sample, if error estimates were requested.
+   */
+  void set_error_estimates(size_t sample, double error, double excess_error);
+
+  /**
+   * Writes NaN to every requested output of a sample that could not be predicted.
+   */
+  void set_missing(size_t sample);
+
+  /**
+   * Copies the buffers into one Prediction per sample. This is used by the
+   * std::vector<Prediction> prediction interface.
+   */
+  std::vector<Prediction> to_predictions() const;
+
+  size_t get_num_samples() const;
+  size_t get_prediction_length() const;
+  bool has_variance_estimates() const;
+  bool has_error_estimates() const;
+
+private:
+  size_t num_samples;
+  size_t prediction_length;
+  double* predictions;
+  double* variance_estimates;
+  double* error_estimates;
+  double* excess_error_estimates;
+};
+
+} // namespace grf
+
+#endif //GRF_PREDICTIONOUTPUT_H
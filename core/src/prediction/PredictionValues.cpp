@@ -15,38 +15,97 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
 #include "prediction/PredictionValues.h"
 
 namespace grf {
 
+const size_t PredictionValues::EMPTY_SLOT = std::numeric_limits<size_t>::max();
+
 PredictionValues::PredictionValues():
   num_nodes(0),
   num_types(0) {}
 
 PredictionValues::PredictionValues(const std::vector<std::vector<double>>& values,
                                    size_t num_types):
-  values(values),
+  slots(values.size(), EMPTY_SLOT),
   num_nodes(values.size()),
-  num_types(num_types) {}
-
+  num_types(num_types) {
+  size_t num_slots = 0;
+  for (const auto& node_values : values) {
+    if (!node_values.empty()) {
+      num_slots++;
+    }
+  }
+
+  flat_values.reserve(num_slots * num_types);
+  size_t slot = 0;
+  for (size_t node = 0; node < num_nodes; node++) {
+    const std::vector<double>& node_values = values[node];
+    if (node_values.empty()) {
+      continue;
+    }
+    if (node_values.size() != num_types) {
+      throw std::runtime_error("Each non-empty node must have exactly num_types prediction values.");
+    }
+    slots[node] = slot++;
+    flat_values.insert(flat_values.end(), node_values.begin(), node_values.end());
+  }
+}
 
+PredictionValues::PredictionValues(std::vector<size_t> slots,
+                                   std::vector<double> flat_values,
+                                   size_t num_types):
+  slots(std::move(slots)),
+  flat_values(std::move(flat_values)),
+  num_nodes(this->slots.size()),
+  num_types(num_types) {
+  for (size_t slot : this->slots) {
+    if (slot != EMPTY_SLOT && (slot + 1) * num_types > this->flat_values.size()) {
+      throw std::runtime_error("Prediction value slot out of range.");
+    }
+  }
+}
 
 double PredictionValues::get(std::size_t node, size_t type) const {
-  return values.at(node).at(type);
+  return flat_values[slots[node] * num_types + type];
 }
 
-const std::vector<double>& PredictionValues::get_values(std::size_t node) const {
-  return values.at(node);
+const double* PredictionValues::get_data(std::size_t node) const {
+  return flat_values.data() + slots[node] * num_types;
+}
+
+std::vector<double> PredictionValues::get_values(std::size_t node) const {
+  if (empty(node)) {
+    return std::vector<double>();
+  }
+  const double* data = get_data(node);
+  return std::vector<double>(data, data + num_types);
 }
 
 bool PredictionValues::empty(std::size_t node) const {
-  return values.at(node).empty();
+  return slots.at(node) == EMPTY_SLOT;
 }
 
-const std::vector<std::vector<double>>& PredictionValues::get_all_values() const {
+std::vector<std::vector<double>> PredictionValues::get_all_values() const {
+  std::vector<std::vector<double>> values(num_nodes);
+  for (size_t node = 0; node < num_nodes; node++) {
+    values[node] = get_values(node);
+  }
   return values;
 }
 
+const std::vector<size_t>& PredictionValues::get_slots() const {
+  return slots;
+}
+
+const std::vector<double>& PredictionValues::get_flat_values() const {
+  return flat_values;
+}
+
 const size_t PredictionValues::get_num_nodes() const {
   return num_nodes;
 }
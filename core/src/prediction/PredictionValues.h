@@ -23,28 +23,72 @@
 
 namespace grf {
 
+/**
+ * Precomputed summary values for the leaves of a tree, num_types values per leaf.
+ *
+ * The values are stored in a single contiguous leaf-major block: the values of the
+ * k-th non-empty node occupy positions k * num_types, ..., (k + 1) * num_types - 1.
+ * A node-to-slot map gives each node's position in that block, with EMPTY_SLOT marking
+ * nodes without values (internal nodes, and leaves that are empty or have negligible
+ * weight). Reading the values of a leaf is then a single contiguous access.
+ */
 class PredictionValues {
 public:
   PredictionValues();
 
+  /**
+   * Builds prediction values from a list of values for each node. Every non-empty
+   * list must contain exactly num_types values.
+   */
   PredictionValues(const std::vector<std::vector<double>>& values,
                    size_t num_types);
 
+  /**
+   * Builds prediction values directly from their flat representation, see
+   * get_slots() and get_flat_values().
+   */
+  PredictionValues(std::vector<size_t> slots,
+                   std::vector<double> flat_values,
+                   size_t num_types);
 
   double get(size_t node, size_t type) const;
-  const std::vector<double>& get_values(size_t node) const;
+
+  /**
+   * A pointer to the num_types contiguous values of a non-empty node.
+   */
+  const double* get_data(size_t node) const;
+
+  /**
+   * A copy of the values of the given node, which is empty if the node has no values.
+   */
+  std::vector<double> get_values(size_t node) const;
+
   bool empty(size_t node) const;
 
   /**
-   *  Returns all prediction values in this object. Values are
-   *  organized first by node, then by type.
+   *  Returns a copy of all prediction values in this object, organized first
+   *  by node, then by type.
+   */
+  std::vector<std::vector<double>> get_all_values() const;
+
+  /**
+   * For each node, the index of its values in the flat value block, or EMPTY_SLOT.
    */
-  const std::vector<std::vector<double>>& get_all_values() const;
+  const std::vector<size_t>& get_slots() const;
+
+  /**
+   * The values of all non-empty nodes as one block, organized first by slot, then by type.
+   */
+  const std::vector<double>& get_flat_values() const;
+
   const size_t get_num_nodes() const;
   const size_t get_num_types() const;
 
+  static const size_t EMPTY_SLOT;
+
 private:
-  std::vector<std::vector<double>> values;
+  std::vector<size_t> slots;
+  std::vector<double> flat_values;
   size_t num_nodes;
   size_t num_types;
 };
@@ -15,7 +15,9 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <cmath>
+
 #include "prediction/ProbabilityPredictionStrategy.h"
 
 namespace grf {
@@ -42,41 +44,22 @@ std::vector<double> ProbabilityPredictionStrategy::predict(const std::vector<dou
 
 std::vector<double> ProbabilityPredictionStrategy::compute_variance(
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
-    size_t ci_group_size) const {
+    const LeafValueMoments& leaf_value_moments) const {
   std::vector<double> variance_estimates(num_classes);
   double weight_bar = average[weight_index];
+  size_t ci_group_size = leaf_value_moments.get_ci_group_size();
+  double num_good_groups = leaf_value_moments.get_num_good_groups();
+  std::vector<double> rho_coefficients(leaf_value_moments.get_num_types(), 0.0);
   for (size_t cls = 0; cls < num_classes; ++cls) {
     double average_outcome = average.at(cls) / weight_bar;
 
-    double num_good_groups = 0;
-    double rho_squared = 0;
-    double rho_grouped_squared = 0;
-
-    for (size_t group = 0; group < leaf_values.get_num_nodes() / ci_group_size; ++group) {
-      bool good_group = true;
-      for (size_t j = 0; j < ci_group_size; ++j) {
-        if (leaf_values.empty(group * ci_group_size + j)) {
-          good_group = false;
-        }
-      }
-      if (!good_group) continue;
-
-      num_good_groups++;
-
-      double group_rho = 0;
+    // rho = (leaf class count - average_outcome * leaf weight) / weight_bar
+    std::fill(rho_coefficients.begin(), rho_coefficients.end(), 0.0);
+    rho_coefficients[cls] = 1 / weight_bar;
+    rho_coefficients[weight_index] = -average_outcome / weight_bar;
 
-      for (size_t j = 0; j < ci_group_size; ++j) {
-        size_t i = group * ci_group_size + j;
-        double rho = (leaf_values.get(i, cls) - average_outcome * leaf_values.get(i, weight_index)) / weight_bar;
-
-        rho_squared += rho * rho;
-        group_rho += rho;
-      }
-
-      group_rho /= ci_group_size;
-      rho_grouped_squared += group_rho * group_rho;
-    }
+    double rho_squared = leaf_value_moments.get_sum_of_squares(rho_coefficients);
+    double rho_grouped_squared = leaf_value_moments.get_sum_of_group_squares(rho_coefficients);
 
     double var_between = rho_grouped_squared / num_good_groups;
     double var_total = rho_squared / (num_good_groups * ci_group_size);
@@ -144,4 +127,17 @@ std::vector<std::pair<double, double>> ProbabilityPredictionStrategy::compute_er
   return { std::make_pair<double, double>(NAN, NAN) };
 }
 
+std::vector<std::pair<double, double>> ProbabilityPredictionStrategy::compute_error(
+    size_t sample,
+    const std::vector<double>& average,
+    const std::vector<double>& centered_products,
+    size_t num_trees,
+    const Data& data) const {
+  return { std::make_pair<double, double>(NAN, NAN) };
+}
+
+bool ProbabilityPredictionStrategy::has_streamed_error_estimates() const {
+  return false;
+}
+
 } // namespace grf
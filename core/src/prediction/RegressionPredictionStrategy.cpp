@@ -50,40 +50,20 @@ std::vector<double> RegressionPredictionStrategy::predict(const std::vector<doub
  */
 std::vector<double> RegressionPredictionStrategy::compute_variance(
     const std::vector<double>& average,
-    const PredictionValues& leaf_values,
-    size_t ci_group_size) const {
+    const LeafValueMoments& leaf_value_moments) const {
 
   double average_weight = average.at(WEIGHT);
   double average_outcome = average.at(OUTCOME) / average_weight;
 
-  double num_good_groups = 0;
-  double rho_squared = 0;
-  double rho_grouped_squared = 0;
-
-  for (size_t group = 0; group < leaf_values.get_num_nodes() / ci_group_size; ++group) {
-    bool good_group = true;
-    for (size_t j = 0; j < ci_group_size; ++j) {
-      if (leaf_values.empty(group * ci_group_size + j)) {
-        good_group = false;
-      }
-    }
-    if (!good_group) continue;
-
-    num_good_groups++;
+  // rho = (leaf outcome - average_outcome * leaf weight) / average_weight
+  std::vector<double> rho_coefficients(leaf_value_moments.get_num_types(), 0.0);
+  rho_coefficients[OUTCOME] = 1 / average_weight;
+  rho_coefficients[WEIGHT] = -average_outcome / average_weight;
 
-    double group_rho = 0;
-
-    for (size_t j = 0; j < ci_group_size; ++j) {
-      size_t i = group * ci_group_size + j;
-      double rho = (leaf_values.get(i, OUTCOME) - average_outcome * leaf_values.get(i, WEIGHT)) / average_weight;
-
-      rho_squared += rho * rho;
-      group_rho += rho;
-    }
-
-    group_rho /= ci_group_size;
-    rho_grouped_squared += group_rho * group_rho;
-  }
+  size_t ci_group_size = leaf_value_moments.get_ci_group_size();
+  double num_good_groups = leaf_value_moments.get_num_good_groups();
+  double rho_squared = leaf_value_moments.get_sum_of_squares(rho_coefficients);
+  double rho_grouped_squared = leaf_value_moments.get_sum_of_group_squares(rho_coefficients);
 
   double var_between = rho_grouped_squared / num_good_groups;
   double var_total = rho_squared / (num_good_groups * ci_group_size);
@@ -174,4 +154,40 @@ std::vector<std::pair<double, double>> RegressionPredictionStrategy::compute_err
   return { output };
 }
 
+std::vector<std::pair<double, double>> RegressionPredictionStrategy::compute_error(
+    size_t sample,
+    const std::vector<double>& average,
+    const std::vector<double>& centered_products,
+    size_t num_trees,
+    const Data& data) const {
+  if (num_trees <= 1) {
+    return { std::make_pair<double, double>(NAN, NAN) };
+  }
+
+  double outcome = data.get_outcome(sample);
+  double average_weight = average.at(WEIGHT);
+  double average_outcome = average.at(OUTCOME) / average_weight;
+  double error = average_outcome - outcome;
+  double mse = error * error;
+
+  // The bias above sums (O - a W)^2 over the trees, where O and W are a tree's leaf outcome
+  // and weight and a = average_outcome. Since the averages of O and W satisfy the same
+  // relation, O - a W equals dO - a dW for the deviations dO and dW from those averages,
+  // so the sum expands to sum dO^2 - 2 a sum dO dW + a^2 sum dW^2.
+  size_t num_types = prediction_value_length();
+  double outcome_outcome = centered_products[OUTCOME * num_types + OUTCOME];
+  double outcome_weight = centered_products[OUTCOME * num_types + WEIGHT];
+  double weight_weight = centered_products[WEIGHT * num_types + WEIGHT];
+  double bias = outcome_outcome - 2 * average_outcome * outcome_weight
+      + average_outcome * average_outcome * weight_weight;
+  bias /= average_weight * average_weight * num_trees * (num_trees - 1);
+
+  double debiased_error = mse - bias;
+  return { std::make_pair(debiased_error, bias) };
+}
+
+bool RegressionPredictionStrategy::has_streamed_error_estimates() const {
+  return true;
+}
+
 } // namespace grf
@@ -0,0 +1,130 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "prediction/RidgePathSolver.h"
+
+namespace grf {
+
+RidgePathSolver::RidgePathSolver(const Eigen::MatrixXd& M,
+                                 const std::vector<size_t>& unpenalized_indices,
+                                 bool weight_penalty):
+    unpenalized_indices(unpenalized_indices) {
+  size_t dim = M.rows();
+  std::vector<bool> is_unpenalized(dim, false);
+  for (size_t index : unpenalized_indices) {
+    is_unpenalized[index] = true;
+  }
+  for (size_t j = 0; j < dim; j++) {
+    if (!is_unpenalized[j]) {
+      penalized_indices.push_back(j);
+    }
+  }
+
+  size_t num_unpenalized = this->unpenalized_indices.size();
+  size_t num_penalized = penalized_indices.size();
+
+  Eigen::MatrixXd unpenalized_block(num_unpenalized, num_unpenalized);
+  cross_block.resize(num_unpenalized, num_penalized);
+  Eigen::MatrixXd penalized_block(num_penalized, num_penalized);
+  for (size_t i = 0; i < num_unpenalized; i++) {
+    size_t row = this->unpenalized_indices[i];
+    for (size_t j = 0; j < num_unpenalized; j++) {
+      unpenalized_block(i, j) = M(row, this->unpenalized_indices[j]);
+    }
+    for (size_t j = 0; j < num_penalized; j++) {
+      cross_block(i, j) = M(row, penalized_indices[j]);
+    }
+  }
+  for (size_t i = 0; i < num_penalized; i++) {
+    for (size_t j = 0; j < num_penalized; j++) {
+      penalized_block(i, j) = M(penalized_indices[i], penalized_indices[j]);
+    }
+  }
+
+  unpenalized_ldlt.compute(unpenalized_block);
+  elimination = unpenalized_ldlt.solve(cross_block);
+  Eigen::MatrixXd schur_complement = penalized_block;
+  schur_complement.noalias() -= cross_block.transpose() * elimination;
+
+  // Rescale the penalized coefficients so that the penalty is lambda * penalty_normalization * I.
+  // A variable with zero covariance penalty carries no information (its column is zero),
+  // so leaving it unscaled only selects the minimum-norm solution.
+  scale.resize(num_penalized);
+  if (!weight_penalty) {
+    penalty_normalization = M.trace() / dim;
+    scale.setOnes();
+  } else {
+    penalty_normalization = 1.0;
+    for (size_t j = 0; j < num_penalized; j++) {
+      double penalty = penalized_block(j, j);
+      scale(j) = penalty > 0 ? 1.0 / std::sqrt(penalty) : 1.0;
+    }
+  }
+
+  Eigen::MatrixXd scaled_schur_complement = scale.asDiagonal() * schur_complement * scale.asDiagonal();
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigen_solver(scaled_schur_complement);
+  eigenvectors = eigen_solver.eigenvectors();
+  eigenvalues = eigen_solver.eigenvalues();
+
+  double max_eigenvalue = num_penalized > 0 ? eigenvalues.cwiseAbs().maxCoeff() : 0.0;
+  eigenvalue_tolerance = max_eigenvalue * dim * std::numeric_limits<double>::epsilon();
+}
+
+Eigen::VectorXd RidgePathSolver::solve(const Eigen::VectorXd& rhs, double lambda) const {
+  size_t num_unpenalized = unpenalized_indices.size();
+  size_t num_penalized = penalized_indices.size();
+
+  Eigen::VectorXd rhs_unpenalized(num_unpenalized);
+  for (size_t i = 0; i < num_unpenalized; i++) {
+    rhs_unpenalized(i) = rhs(unpenalized_indices[i]);
+  }
+  Eigen::VectorXd rhs_penalized(num_penalized);
+  for (size_t j = 0; j < num_penalized; j++) {
+    rhs_penalized(j) = rhs(penalized_indices[j]);
+  }
+
+  // Solve the penalized block in the eigenbasis of the rescaled Schur complement.
+  Eigen::VectorXd reduced_rhs = rhs_penalized;
+  reduced_rhs.noalias() -= elimination.transpose() * rhs_unpenalized;
+  Eigen::VectorXd projected = eigenvectors.transpose() * scale.cwiseProduct(reduced_rhs);
+  double shift = lambda * penalty_normalization;
+  for (size_t j = 0; j < num_penalized; j++) {
+    double denominator = eigenvalues(j) + shift;
+    projected(j) = std::abs(denominator) > eigenvalue_tolerance ? projected(j) / denominator : 0.0;
+  }
+  Eigen::VectorXd beta_penalized = scale.cwiseProduct(eigenvectors * projected);
+
+  // Back-substitute for the unpenalized coefficients.
+  Eigen::VectorXd beta_unpenalized = rhs_unpenalized;
+  beta_unpenalized.noalias() -= cross_block * beta_penalized;
+  beta_unpenalized = unpenalized_ldlt.solve(beta_unpenalized);
+
+  Eigen::VectorXd beta(num_unpenalized + num_penalized);
+  for (size_t i = 0; i < num_unpenalized; i++) {
+    beta(unpenalized_indices[i]) = beta_unpenalized(i);
+  }
+  for (size_t j = 0; j < num_penalized; j++) {
+    beta(penalized_indices[j]) = beta_penalized(j);
+  }
+  return beta;
+}
+
+} // namespace grf
@@ -0,0 +1,69 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_RIDGEPATHSOLVER_H
+#define GRF_RIDGEPATHSOLVER_H
+
+#include <cstddef>
+#include <vector>
+#include "Eigen/Dense"
+
+namespace grf {
+
+/**
+ * Solves the family of ridge systems (M + lambda * P) beta = rhs along a path of
+ * regularization parameters lambda, where M is a fixed (unpenalized) Gram matrix.
+ *
+ * The penalty P is diagonal and zero for the given unpenalized coefficients (e.g. the
+ * intercept). With the standard ridge penalty, the penalized diagonal equals
+ * trace(M) / dim(M); with the covariance penalty (weight_penalty = true) it equals the
+ * corresponding diagonal entry of M.
+ *
+ * The unpenalized coefficients are eliminated through a Schur complement, which is
+ * rescaled so the penalty becomes a multiple of the identity and then eigendecomposed
+ * once. Every subsequent solve, for any lambda, only costs a few matrix-vector products.
+ */
+class RidgePathSolver {
+public:
+  RidgePathSolver(const Eigen::MatrixXd& M,
+                  const std::vector<size_t>& unpenalized_indices,
+                  bool weight_penalty);
+
+  Eigen::VectorXd solve(const Eigen::VectorXd& rhs, double lambda) const;
+
+private:
+  std::vector<size_t> unpenalized_indices;
+  std::vector<size_t> penalized_indices;
+
+  Eigen::LDLT<Eigen::MatrixXd> unpenalized_ldlt;
+  // M restricted to (unpenalized rows, penalized columns).
+  Eigen::MatrixXd cross_block;
+  // The solution of M_uu * A = M_up, used to eliminate the unpenalized coefficients.
+  Eigen::MatrixXd elimination;
+
+  // The inverse square root of the penalty on each penalized coefficient.
+  Eigen::VectorXd scale;
+  double penalty_normalization;
+
+  Eigen::MatrixXd eigenvectors;
+  Eigen::VectorXd eigenvalues;
+  double eigenvalue_tolerance;
+};
+
+} // namespace grf
+
+#endif //GRF_RIDGEPATHSOLVER_H
@@ -27,25 +27,25 @@ DefaultPredictionCollector::DefaultPredictionCollector(std::unique_ptr<DefaultPr
                                                        uint num_threads):
     strategy(std::move(strategy)), num_threads(num_threads) {}
 
-std::vector<Prediction> DefaultPredictionCollector::collect_predictions(
+void DefaultPredictionCollector::collect_predictions(
     const Forest& forest,
     const Data& train_data,
     const Data& data,
     const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
     const std::vector<std::vector<bool>>& valid_trees_by_sample,
-    bool estimate_variance,
-    bool estimate_error) const {
+    PredictionOutput& output) const {
+  if (!forest.has_leaf_samples()) {
+    throw std::runtime_error("This forest does not contain leaf samples, so it can only be used"
+                             " with a prediction strategy based on precomputed prediction values.");
+  }
 
   size_t num_samples = data.get_num_rows();
   std::vector<uint> thread_ranges;
   split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
 
-  std::vector<std::future<std::vector<Prediction>>> futures;
+  std::vector<std::future<void>> futures;
   futures.reserve(thread_ranges.size());
 
-  std::vector<Prediction> predictions;
-  predictions.reserve(num_samples);
-
   for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
     size_t start_index = thread_ranges[i];
     size_t num_samples_batch = thread_ranges[i + 1] - start_index;
@@ -58,35 +58,80 @@ std::vector<Prediction> DefaultPredictionCollector::collect_predictions(
                                  std::ref(data),
                                  std::ref(leaf_nodes_by_tree),
                                  std::ref(valid_trees_by_sample),
-                                 estimate_variance,
                                  start_index,
-                                 num_samples_batch));
+                                 num_samples_batch,
+                                 std::ref(output)));
   }
 
   for (auto& future : futures) {
-    std::vector<Prediction> thread_predictions = future.get();
-    predictions.insert(predictions.end(),
-                       std::make_move_iterator(thread_predictions.begin()),
-                       std::make_move_iterator(thread_predictions.end()));
+    future.get();
+  }
+}
+
+void DefaultPredictionCollector::collect_predictions_direct(const Forest& forest,
+                                                            const Data& train_data,
+                                                            const Data& data,
+                                                            PredictionOutput& output,
+                                                            PredictionScratch& scratch) const {
+  if (!forest.has_leaf_samples()) {
+    throw std::runtime_error("This forest does not contain leaf samples, so it can only be used"
+                             " with a prediction strategy based on precomputed prediction values.");
+  }
+
+  size_t num_samples = data.get_num_rows();
+  size_t num_trees = forest.get_trees().size();
+
+  // The leaves are stored by sample, but found one tree at a time so that each tree's
+  // nodes stay in cache while all samples of the batch are routed through it.
+  std::vector<size_t>& leaf_nodes = scratch.get_leaf_nodes();
+  leaf_nodes.resize(num_samples * num_trees);
+  for (size_t tree_index = 0; tree_index < num_trees; ++tree_index) {
+    const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
+    for (size_t sample = 0; sample < num_samples; ++sample) {
+      leaf_nodes[sample * num_trees + tree_index] = tree->find_leaf_node(data, sample);
+    }
   }
 
-  return predictions;
+  for (size_t sample = 0; sample < num_samples; ++sample) {
+    const size_t* sample_leaf_nodes = leaf_nodes.data() + sample * num_trees;
+    std::unordered_map<size_t, double> weights_by_sample = weight_computer.compute_weights(forest, sample_leaf_nodes);
+    std::vector<std::vector<size_t>> samples_by_tree;
+    if (weights_by_sample.empty()) {
+      output.set_missing(sample);
+      continue;
+    }
+
+    if (output.has_variance_estimates()) {
+      samples_by_tree.resize(num_trees);
+      for (size_t tree_index = 0; tree_index < num_trees; ++tree_index) {
+        const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
+        samples_by_tree.push_back(tree->get_leaf_samples().at(sample_leaf_nodes[tree_index]));
+      }
+    }
+
+    write_prediction(sample, weights_by_sample, samples_by_tree, forest, train_data, data, output);
+  }
 }
 
-std::vector<Prediction> DefaultPredictionCollector::collect_predictions_batch(
+size_t DefaultPredictionCollector::get_prediction_length() const {
+  return strategy->prediction_length();
+}
+
+bool DefaultPredictionCollector::supports_error_estimates() const {
+  return false;
+}
+
+void DefaultPredictionCollector::collect_predictions_batch(
     const Forest& forest,
     const Data& train_data,
     const Data& data,
     const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
     const std::vector<std::vector<bool>>& valid_trees_by_sample,
-    bool estimate_variance,
     size_t start,
-    size_t num_samples) const {
+    size_t num_samples,
+    PredictionOutput& output) const {
   size_t num_trees = forest.get_trees().size();
-  bool record_leaf_samples = estimate_variance;
-
-  std::vector<Prediction> predictions;
-  predictions.reserve(num_samples);
+  bool record_leaf_samples = output.has_variance_estimates();
 
   for (size_t sample = start; sample < num_samples + start; ++sample) {
     std::unordered_map<size_t, double> weights_by_sample = weight_computer.compute_weights(
@@ -96,9 +141,7 @@ std::vector<Prediction> DefaultPredictionCollector::collect_predictions_batch(
     // If this sample has no neighbors, then return placeholder predictions. Note
     // that this can only occur when honesty is enabled, and is expected to be rare.
     if (weights_by_sample.empty()) {
-      std::vector<double> nan(strategy->prediction_length(), NAN);
-      std::vector<double> empty;
-      predictions.emplace_back(nan, estimate_variance ? nan : empty, empty, empty);
+      output.set_missing(sample);
       continue;
     }
 
@@ -118,36 +161,34 @@ std::vector<Prediction> DefaultPredictionCollector::collect_predictions_batch(
       }
     }
 
-    std::vector<double> point_prediction = strategy->predict(sample, weights_by_sample, train_data, data);
-    std::vector<double> variance = estimate_variance
-        ? strategy->compute_variance(sample, samples_by_tree, weights_by_sample, train_data, data, forest.get_ci_group_size())
-        : std::vector<double>();
-
-    // If the returned predictions are empty, then return placeholder predictions.
-    // This can occur if for example all case sample weights are zero,
-    // and the prediction strategy opts to predict nothing.
-    if (point_prediction.empty()) {
-      std::vector<double> nan(strategy->prediction_length(), NAN);
-      std::vector<double> empty;
-      predictions.emplace_back(nan, estimate_variance ? nan : empty, empty, empty);
-      continue;
-    }
-
-    Prediction prediction(point_prediction, variance, {}, {});
-    validate_prediction(sample, point_prediction);
-    predictions.push_back(prediction);
+    write_prediction(sample, weights_by_sample, samples_by_tree, forest, train_data, data, output);
   }
-
-  return predictions;
 }
 
-void DefaultPredictionCollector::validate_prediction(size_t sample,
-                                                     const Prediction& prediction) const {
-  size_t prediction_length = strategy->prediction_length();
-  if (prediction.size() != prediction_length) {
-    throw std::runtime_error("Prediction for sample " + std::to_string(sample) +
-                             " did not have the expected length.");
+void DefaultPredictionCollector::write_prediction(
+    size_t sample,
+    const std::unordered_map<size_t, double>& weights_by_sample,
+    const std::vector<std::vector<size_t>>& samples_by_tree,
+    const Forest& forest,
+    const Data& train_data,
+    const Data& data,
+    PredictionOutput& output) const {
+  std::vector<double> point_prediction = strategy->predict(sample, weights_by_sample, train_data, data);
+  std::vector<double> variance = output.has_variance_estimates()
+      ? strategy->compute_variance(sample, samples_by_tree, weights_by_sample, train_data, data, forest.get_ci_group_size())
+      : std::vector<double>();
+
+  // If the returned predictions are empty, then return placeholder predictions.
+  // This can occur if for example all case sample weights are zero,
+  // and the prediction strategy opts to predict nothing.
+  if (point_prediction.empty()) {
+    output.set_missing(sample);
+    return;
   }
+
+  output.set_predictions(sample, point_prediction);
+  output.set_variance_estimates(sample, variance);
+  output.set_error_estimates(sample, NAN, NAN);
 }
 
 } // namespace grf
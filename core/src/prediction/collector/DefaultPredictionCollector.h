@@ -33,27 +33,43 @@ public:
   /**
    * Collect predictions and variance estimates computed by the DefaultPredictionStrategy.
    *
-   * Note: estimate_error is unused as this prediction strategy does not implement error estimates.
+   * Note: this prediction strategy does not implement error estimates, so any error
+   * buffers in output are filled with NaN.
    */
-  std::vector<Prediction> collect_predictions(const Forest& forest,
-                                              const Data& train_data,
-                                              const Data& data,
-                                              const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                              const std::vector<std::vector<bool>>& valid_trees_by_sample,
-                                              bool estimate_variance,
-                                              bool estimate_error) const;
+  void collect_predictions(const Forest& forest,
+                           const Data& train_data,
+                           const Data& data,
+                           const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                           const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                           PredictionOutput& output) const;
+
+  void collect_predictions_direct(const Forest& forest,
+                                  const Data& train_data,
+                                  const Data& data,
+                                  PredictionOutput& output,
+                                  PredictionScratch& scratch) const;
+
+  size_t get_prediction_length() const;
+
+  bool supports_error_estimates() const;
 
 private:
-  std::vector<Prediction> collect_predictions_batch(const Forest& forest,
-                                                    const Data& train_data,
-                                                    const Data& data,
-                                                    const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                    const std::vector<std::vector<bool>>& valid_trees_by_sample,
-                                                    bool estimate_variance,
-                                                    size_t start,
-                                                    size_t num_samples) const;
-
-  void validate_prediction(size_t sample, const Prediction& prediction) const;
+  void collect_predictions_batch(const Forest& forest,
+                                 const Data& train_data,
+                                 const Data& data,
+                                 const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                                 const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                 size_t start,
+                                 size_t num_samples,
+                                 PredictionOutput& output) const;
+
+  void write_prediction(size_t sample,
+                        const std::unordered_map<size_t, double>& weights_by_sample,
+                        const std::vector<std::vector<size_t>>& samples_by_tree,
+                        const Forest& forest,
+                        const Data& train_data,
+                        const Data& data,
+                        PredictionOutput& output) const;
 
   std::unique_ptr<DefaultPredictionStrategy> strategy;
   SampleWeightComputer weight_computer;
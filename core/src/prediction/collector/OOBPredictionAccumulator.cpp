@@ -0,0 +1,223 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <stdexcept>
+
+#include "commons/utility.h"
+#include "prediction/collector/OOBPredictionAccumulator.h"
+
+namespace grf {
+
+OOBPredictionAccumulator::OOBPredictionAccumulator(size_t num_samples,
+                                                   size_t num_types):
+    OOBPredictionAccumulator(num_samples, num_types, false) {}
+
+OOBPredictionAccumulator::OOBPredictionAccumulator(size_t num_samples,
+                                                   size_t num_types,
+                                                   bool accumulate_products):
+    num_types(num_types),
+    accumulate_products(accumulate_products),
+    value_sums(num_samples * num_types, 0.0),
+    num_leaves(num_samples, 0),
+    shifts(accumulate_products ? num_samples * num_types : 0, 0.0),
+    value_products(accumulate_products ? num_samples * num_types * (num_types + 1) / 2 : 0, 0.0) {}
+
+void OOBPredictionAccumulator::add_tree(const Tree& tree,
+                                        const Data& data) {
+  add_tree_samples(tree, 0, num_leaves.size(), data);
+}
+
+void OOBPredictionAccumulator::add_trees(const Forest& forest,
+                                         size_t start_tree,
+                                         const Data& data,
+                                         uint num_threads) {
+  add_trees(forest.get_trees(), start_tree, data, num_threads);
+}
+
+void OOBPredictionAccumulator::add_trees(const std::vector<std::unique_ptr<Tree>>& trees,
+                                         size_t start_tree,
+                                         const Data& data,
+                                         uint num_threads) {
+  size_t num_samples = num_leaves.size();
+  if (start_tree >= trees.size() || num_samples == 0) {
+    return;
+  }
+
+  // The threads split the samples rather than the trees, so that each writes to its own rows.
+  std::vector<uint> thread_ranges;
+  split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
+
+  std::vector<std::future<void>> futures;
+  futures.reserve(thread_ranges.size());
+
+  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
+    size_t start_sample = thread_ranges[i];
+    size_t end_sample = thread_ranges[i + 1];
+    futures.push_back(std::async(std::launch::async,
+                                 &OOBPredictionAccumulator::add_sample_batch,
+                                 this,
+                                 std::ref(trees),
+                                 start_tree,
+                                 start_sample,
+                                 end_sample,
+                                 std::ref(data)));
+  }
+
+  for (auto& future : futures) {
+    future.get();
+  }
+}
+
+void OOBPredictionAccumulator::add_sample_batch(const std::vector<std::unique_ptr<Tree>>& trees,
+                                                size_t start_tree,
+                                                size_t start_sample,
+                                                size_t end_sample,
+                                                const Data& data) {
+  for (size_t i = start_tree; i < trees.size(); i++) {
+    add_tree_samples(*trees[i], start_sample, end_sample, data);
+  }
+}
+
+void OOBPredictionAccumulator::add_tree_samples(const Tree& tree,
+                                                size_t start_sample,
+                                                size_t end_sample,
+                                                const Data& data) {
+  const PredictionValues& prediction_values = tree.get_prediction_values();
+
+  for (size_t sample = start_sample; sample < end_sample; sample++) {
+    if (tree.is_drawn(sample)) {
+      continue;
+    }
+
+    size_t node = tree.find_leaf_node(data, sample);
+    if (prediction_values.empty(node)) {
+      continue;
+    }
+
+    const double* values = prediction_values.get_data(node);
+    for (size_t type = 0; type < num_types; type++) {
+      value_sums[sample * num_types + type] += values[type];
+    }
+    if (accumulate_products) {
+      double* shift = &shifts[sample * num_types];
+      if (num_leaves[sample] == 0) {
+        std::copy(values, values + num_types, shift);
+      }
+      double* products = &value_products[sample * num_types * (num_types + 1) / 2];
+      for (size_t i = 0; i < num_types; i++) {
+        for (size_t j = i; j < num_types; j++) {
+          *products++ += (values[i] - shift[i]) * (values[j] - shift[j]);
+        }
+      }
+    }
+    num_leaves[sample]++;
+  }
+}
+
+std::vector<Prediction> OOBPredictionAccumulator::get_predictions(
+    const OptimizedPredictionStrategy& strategy) const {
+  if (strategy.prediction_value_length() != num_types) {
+    throw std::runtime_error("The prediction strategy does not match the accumulated prediction values.");
+  }
+
+  size_t num_samples = num_leaves.size();
+  std::vector<Prediction> predictions;
+  predictions.reserve(num_samples);
+
+  std::vector<double> average_value(num_types);
+  for (size_t sample = 0; sample < num_samples; sample++) {
+    if (num_leaves[sample] == 0) {
+      std::vector<double> nan(strategy.prediction_length(), NAN);
+      predictions.emplace_back(nan);
+      continue;
+    }
+
+    for (size_t type = 0; type < num_types; type++) {
+      average_value[type] = value_sums[sample * num_types + type] / num_leaves[sample];
+    }
+    predictions.emplace_back(strategy.predict(average_value));
+  }
+  return predictions;
+}
+
+void OOBPredictionAccumulator::predict(const OptimizedPredictionStrategy& strategy,
+                                       const Data& data,
+                                       PredictionOutput& output) const {
+  size_t num_samples = num_leaves.size();
+  if (strategy.prediction_value_length() != num_types) {
+    throw std::runtime_error("The prediction strategy does not match the accumulated prediction values.");
+  } else if (output.get_num_samples() != num_samples
+      || output.get_prediction_length() != strategy.prediction_length()) {
+    throw std::runtime_error("The prediction output does not match the accumulated samples.");
+  }
+
+  bool estimate_error = output.has_error_estimates() && strategy.has_streamed_error_estimates();
+  if (estimate_error && !accumulate_products) {
+    throw std::runtime_error("Error estimates require an OOB accumulator of leaf value products.");
+  }
+
+  std::vector<double> average_value(num_types);
+  std::vector<double> products(estimate_error ? num_types * num_types : 0);
+  for (size_t sample = 0; sample < num_samples; sample++) {
+    if (num_leaves[sample] == 0) {
+      output.set_missing(sample);
+      continue;
+    }
+
+    for (size_t type = 0; type < num_types; type++) {
+      average_value[type] = value_sums[sample * num_types + type] / num_leaves[sample];
+    }
+    output.set_predictions(sample, strategy.predict(average_value));
+
+    if (estimate_error) {
+      // Center the products of the shifted values: with d = average - shift, the sum of
+      // (x - average)(x - average)' is the sum of (x - shift)(x - shift)' minus n d d'.
+      const double* sums = &value_products[sample * num_types * (num_types + 1) / 2];
+      const double* shift = &shifts[sample * num_types];
+      for (size_t i = 0; i < num_types; i++) {
+        for (size_t j = i; j < num_types; j++) {
+          double centered = *sums++ - num_leaves[sample]
+              * (average_value[i] - shift[i]) * (average_value[j] - shift[j]);
+          products[i * num_types + j] = centered;
+          products[j * num_types + i] = centered;
+        }
+      }
+      std::vector<std::pair<double, double>> error = strategy.compute_error(
+          sample, average_value, products, num_leaves[sample], data);
+      output.set_error_estimates(sample, error[0].first, error[0].second);
+    } else if (output.has_error_estimates()) {
+      output.set_error_estimates(sample, NAN, NAN);
+    }
+  }
+}
+
+size_t OOBPredictionAccumulator::get_num_samples() const {
+  return num_leaves.size();
+}
+
+size_t OOBPredictionAccumulator::get_num_types() const {
+  return num_types;
+}
+
+bool OOBPredictionAccumulator::has_products() const {
+  return accumulate_products;
+}
+
+} // namespace grf
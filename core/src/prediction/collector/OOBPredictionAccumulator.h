@@ -0,0 +1,130 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_OOBPREDICTIONACCUMULATOR_H
+#define GRF_OOBPREDICTIONACCUMULATOR_H
+
+#include <vector>
+
+#include "forest/Forest.h"
+#include "prediction/OptimizedPredictionStrategy.h"
+#include "prediction/Prediction.h"
+#include "prediction/PredictionOutput.h"
+
+namespace grf {
+
+/**
+ * Keeps a running sum of the out-of-bag prediction values of each training sample,
+ * so that OOB point predictions can be updated as trees are added to a forest,
+ * without traversing the trees that were already accounted for.
+ *
+ * This only applies to forests with an {@link OptimizedPredictionStrategy}, whose point
+ * predictions depend on the leaf prediction values only through their average.
+ *
+ * Optionally, the accumulator also keeps the running sums of the products x x' of the
+ * leaf values x, from which strategies derive OOB error estimates, see
+ * OptimizedPredictionStrategy::compute_error. As in LeafValueMoments, the products are
+ * summed after subtracting the first leaf values of each sample, so that they are not
+ * lost to cancellation when the leaf values are large relative to their spread. These
+ * take num_types * (num_types + 3) / 2 additional values per sample.
+ */
+class OOBPredictionAccumulator {
+public:
+  OOBPredictionAccumulator(size_t num_samples,
+                           size_t num_types);
+
+  /**
+   * An accumulator that, if accumulate_products is set, also sums the leaf value
+   * products needed for error estimates.
+   */
+  OOBPredictionAccumulator(size_t num_samples,
+                           size_t num_types,
+                           bool accumulate_products);
+
+  /**
+   * Adds the prediction values of the leaves that each sample not drawn
+   * for this tree falls into.
+   */
+  void add_tree(const Tree& tree,
+                const Data& data);
+
+  /**
+   * Adds the trees with index start_tree and above of the given forest. The samples
+   * are split across the given number of threads, which each add every tree to their
+   * own samples, so that no thread needs a copy of the sums.
+   */
+  void add_trees(const Forest& forest,
+                 size_t start_tree,
+                 const Data& data,
+                 uint num_threads);
+
+  void add_trees(const std::vector<std::unique_ptr<Tree>>& trees,
+                 size_t start_tree,
+                 const Data& data,
+                 uint num_threads);
+
+  /**
+   * Computes the current OOB point prediction of each sample. Samples that have
+   * not landed in any non-empty OOB leaf yet receive NaN predictions.
+   */
+  std::vector<Prediction> get_predictions(const OptimizedPredictionStrategy& strategy) const;
+
+  /**
+   * Writes the current OOB predictions into the given output, together with the
+   * debiased and excess error estimates if the output requests them. These are NaN for
+   * strategies without streamed error estimates, and otherwise require an accumulator
+   * of leaf value products. Samples that have not landed in any non-empty OOB leaf yet
+   * are set to missing.
+   */
+  void predict(const OptimizedPredictionStrategy& strategy,
+               const Data& data,
+               PredictionOutput& output) const;
+
+  size_t get_num_samples() const;
+  size_t get_num_types() const;
+  bool has_products() const;
+
+private:
+  void add_sample_batch(const std::vector<std::unique_ptr<Tree>>& trees,
+                        size_t start_tree,
+                        size_t start_sample,
+                        size_t end_sample,
+                        const Data& data);
+
+  void add_tree_samples(const Tree& tree,
+                        size_t start_sample,
+                        size_t end_sample,
+                        const Data& data);
+
+  size_t num_types;
+  bool accumulate_products;
+
+  // Prediction value sums organized first by sample, then by type.
+  std::vector<double> value_sums;
+  std::vector<size_t> num_leaves;
+
+  // The first leaf values of each sample, organized first by sample, then by type.
+  std::vector<double> shifts;
+
+  // The upper triangle of the sum of (x - shift)(x - shift)' of each sample, organized
+  // first by sample, then row by row.
+  std::vector<double> value_products;
+};
+
+} // namespace grf
+
+#endif //GRF_OOBPREDICTIONACCUMULATOR_H
@@ -17,6 +17,7 @@
 
 #include <future>
 #include <stdexcept>
+#include <string>
 
 #include "prediction/collector/OptimizedPredictionCollector.h"
 #include "commons/utility.h"
@@ -26,23 +27,21 @@ namespace grf {
 OptimizedPredictionCollector::OptimizedPredictionCollector(std::unique_ptr<OptimizedPredictionStrategy> strategy, uint num_threads):
     strategy(std::move(strategy)), num_threads(num_threads) {}
 
-std::vector<Prediction> OptimizedPredictionCollector::collect_predictions(const Forest& forest,
-                                                                          const Data& train_data,
-                                                                          const Data& data,
-                                                                          const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                                          const std::vector<std::vector<bool>>& valid_trees_by_sample,
-                                                                          bool estimate_variance,
-                                                                          bool estimate_error) const {
+void OptimizedPredictionCollector::collect_predictions(const Forest& forest,
+                                                       const Data& train_data,
+                                                       const Data& data,
+                                                       const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                                                       const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                                       PredictionOutput& output) const {
+  check_prediction_values(forest);
+
   size_t num_samples = data.get_num_rows();
   std::vector<uint> thread_ranges;
   split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
 
-  std::vector<std::future<std::vector<Prediction>>> futures;
+  std::vector<std::future<void>> futures;
   futures.reserve(thread_ranges.size());
 
-  std::vector<Prediction> predictions;
-  predictions.reserve(num_samples);
-
   for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
     size_t start_index = thread_ranges[i];
     size_t num_samples_batch = thread_ranges[i + 1] - start_index;
@@ -55,100 +54,183 @@ std::vector<Prediction> OptimizedPredictionCollector::collect_predictions(const
                                  std::ref(data),
                                  std::ref(leaf_nodes_by_tree),
                                  std::ref(valid_trees_by_sample),
-                                 estimate_variance,
-                                 estimate_error,
                                  start_index,
-                                 num_samples_batch));
+                                 num_samples_batch,
+                                 std::ref(output)));
   }
 
   for (auto& future : futures) {
-    std::vector<Prediction> thread_predictions = future.get();
-    predictions.insert(predictions.end(),
-                       std::make_move_iterator(thread_predictions.begin()),
-                       std::make_move_iterator(thread_predictions.end()));
+    future.get();
+  }
+}
+
+void OptimizedPredictionCollector::collect_predictions_direct(const Forest& forest,
+                                                              const Data& train_data,
+                                                              const Data& data,
+                                                              PredictionOutput& output,
+                                                              PredictionScratch& scratch) const {
+  check_prediction_values(forest);
+
+  size_t num_samples = data.get_num_rows();
+  size_t num_types = strategy->prediction_value_length();
+  bool estimate_variance = output.has_variance_estimates();
+
+  std::vector<double>& sum_values = scratch.get_average_values();
+  std::vector<size_t>& num_leaves = scratch.get_num_leaves();
+  sum_values.assign(num_samples * num_types, 0.0);
+  num_leaves.assign(num_samples, 0);
+  std::vector<LeafValueMoments>& leaf_value_moments = scratch.get_leaf_value_moments(
+      estimate_variance ? num_samples : 0, num_types, forest.get_ci_group_size());
+  if (estimate_variance) {
+    for (size_t sample = 0; sample < num_samples; ++sample) {
+      leaf_value_moments[sample].clear();
+    }
+  }
+
+  // Visit the trees in the outer loop, so that each tree's nodes stay in cache while
+  // all samples of the batch are routed through it.
+  for (const std::unique_ptr<Tree>& tree : forest.get_trees()) {
+    const PredictionValues& prediction_values = tree->get_prediction_values();
+    for (size_t sample = 0; sample < num_samples; ++sample) {
+      size_t node = tree->find_leaf_node(data, sample);
+      if (prediction_values.empty(node)) {
+        if (estimate_variance) {
+          leaf_value_moments[sample].add_empty();
+        }
+        continue;
+      }
+
+      const double* values = prediction_values.get_data(node);
+      double* sum = sum_values.data() + sample * num_types;
+      for (size_t type = 0; type < num_types; ++type) {
+        sum[type] += values[type];
+      }
+      num_leaves[sample]++;
+      if (estimate_variance) {
+        leaf_value_moments[sample].add(values);
+      }
+    }
+  }
+
+  std::vector<double> average_value(num_types);
+  for (size_t sample = 0; sample < num_samples; ++sample) {
+    if (num_leaves[sample] == 0) {
+      output.set_missing(sample);
+      continue;
+    }
+
+    const double* sum = sum_values.data() + sample * num_types;
+    for (size_t type = 0; type < num_types; ++type) {
+      average_value[type] = sum[type] / num_leaves[sample];
+    }
+    output.set_predictions(sample, strategy->predict(average_value));
+
+    if (estimate_variance) {
+      output.set_variance_estimates(sample, strategy->compute_variance(average_value, leaf_value_moments[sample]));
+    }
+  }
+}
+
+void OptimizedPredictionCollector::check_prediction_values(const Forest& forest) const {
+  size_t num_types = strategy->prediction_value_length();
+  for (const std::unique_ptr<Tree>& tree : forest.get_trees()) {
+    size_t forest_num_types = tree->get_prediction_values().get_num_types();
+    if (forest_num_types != num_types) {
+      throw std::runtime_error("The forest holds " + std::to_string(forest_num_types)
+          + " prediction values per leaf, but the prediction strategy expects "
+          + std::to_string(num_types) + ".");
+    }
   }
+}
 
-  return predictions;
+size_t OptimizedPredictionCollector::get_prediction_length() const {
+  return strategy->prediction_length();
 }
 
-std::vector<Prediction> OptimizedPredictionCollector::collect_predictions_batch(const Forest& forest,
-                                                                                const Data& train_data,
-                                                                                const Data& data,
-                                                                                const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                                                const std::vector<std::vector<bool>>& valid_trees_by_sample,
-                                                                                bool estimate_variance,
-                                                                                bool estimate_error,
-                                                                                size_t start,
-                                                                                size_t num_samples) const {
+bool OptimizedPredictionCollector::supports_error_estimates() const {
+  return true;
+}
+
+void OptimizedPredictionCollector::collect_predictions_batch(const Forest& forest,
+                                                             const Data& train_data,
+                                                             const Data& data,
+                                                             const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                                                             const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                                             size_t start,
+                                                             size_t num_samples,
+                                                             PredictionOutput& output) const {
   size_t num_trees = forest.get_trees().size();
-  bool record_leaf_values = estimate_variance || estimate_error;
+  bool estimate_variance = output.has_variance_estimates();
+  bool estimate_error = output.has_error_estimates();
 
-  std::vector<Prediction> predictions;
-  predictions.reserve(num_samples);
+  // Variance estimates only need the moments of the leaf values within each ci group,
+  // which are accumulated while the trees are visited, reusing one buffer for all samples.
+  LeafValueMoments leaf_value_moments(estimate_variance ? strategy->prediction_value_length() : 0,
+                                      forest.get_ci_group_size());
 
   for (size_t sample = start; sample < num_samples + start; ++sample) {
     std::vector<double> average_value;
-    std::vector<std::vector<double>> leaf_values;
-    if (record_leaf_values) {
-      leaf_values.resize(num_trees);
+    // Error estimates need each tree's leaf values, which are gathered into one
+    // flat block, see PredictionValues.
+    std::vector<size_t> leaf_slots;
+    std::vector<double> leaf_values;
+    if (estimate_error) {
+      leaf_slots.resize(num_trees, PredictionValues::EMPTY_SLOT);
+    }
+    if (estimate_variance) {
+      leaf_value_moments.clear();
     }
 
     // Create a list of weighted neighbors for this sample.
     uint num_leaves = 0;
     for (size_t tree_index = 0; tree_index < forest.get_trees().size(); ++tree_index) {
-      if (!valid_trees_by_sample[sample][tree_index]) {
-        continue;
-      }
-
       const std::vector<size_t>& leaf_nodes = leaf_nodes_by_tree.at(tree_index);
-      size_t node = leaf_nodes.at(sample);
-
       const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
       const PredictionValues& prediction_values = tree->get_prediction_values();
 
-      if (!prediction_values.empty(node)) {
-        num_leaves++;
-        add_prediction_values(node, prediction_values, average_value);
-        if (record_leaf_values) {
-          leaf_values[tree_index] = prediction_values.get_values(node);
+      if (!valid_trees_by_sample[sample][tree_index] || prediction_values.empty(leaf_nodes.at(sample))) {
+        if (estimate_variance) {
+          leaf_value_moments.add_empty();
         }
+        continue;
+      }
+
+      size_t node = leaf_nodes.at(sample);
+      num_leaves++;
+      add_prediction_values(node, prediction_values, average_value);
+      if (estimate_variance) {
+        leaf_value_moments.add(prediction_values.get_data(node));
+      }
+      if (estimate_error) {
+        size_t num_types = prediction_values.get_num_types();
+        const double* values = prediction_values.get_data(node);
+        leaf_slots[tree_index] = leaf_values.size() / num_types;
+        leaf_values.insert(leaf_values.end(), values, values + num_types);
       }
     }
 
     // If this sample has no neighbors, then return placeholder predictions. Note
     // that this can only occur when honesty is enabled, and is expected to be rare.
     if (num_leaves == 0) {
-      std::vector<double> nan(strategy->prediction_length(), NAN);
-      std::vector<double> nan_error(1, NAN);
-      predictions.emplace_back(nan, estimate_variance ? nan : std::vector<double>(), nan_error, nan_error);
+      output.set_missing(sample);
       continue;
     }
 
     normalize_prediction_values(num_leaves, average_value);
-    std::vector<double> point_prediction = strategy->predict(average_value);
-
-    PredictionValues prediction_values(leaf_values, strategy->prediction_value_length());
-    std::vector<double> variance = estimate_variance
-        ? strategy->compute_variance(average_value, prediction_values, forest.get_ci_group_size())
-        : std::vector<double>();
+    output.set_predictions(sample, strategy->predict(average_value));
 
-    std::vector<double> mse;
-    std::vector<double> mce;
+    if (estimate_variance) {
+      output.set_variance_estimates(sample, strategy->compute_variance(average_value, leaf_value_moments));
+    }
 
     if (estimate_error) {
+      PredictionValues prediction_values(std::move(leaf_slots), std::move(leaf_values),
+                                         strategy->prediction_value_length());
       std::vector<std::pair<double, double>> error = strategy->compute_error(
               sample, average_value, prediction_values, data);
-
-      mse.push_back(error[0].first);
-      mce.push_back(error[0].second);
+      output.set_error_estimates(sample, error[0].first, error[0].second);
     }
-
-    Prediction prediction(point_prediction, variance, mse, mce);
-
-    validate_prediction(sample, prediction);
-    predictions.push_back(prediction);
   }
-  return predictions;
 }
 
 void OptimizedPredictionCollector::add_prediction_values(size_t node,
@@ -158,8 +240,9 @@ void OptimizedPredictionCollector::add_prediction_values(size_t node,
     combined_average.resize(prediction_values.get_num_types());
   }
 
+  const double* values = prediction_values.get_data(node);
   for (size_t type = 0; type < prediction_values.get_num_types(); ++type) {
-    combined_average[type] += prediction_values.get(node, type);
+    combined_average[type] += values[type];
   }
 }
 
@@ -170,13 +253,4 @@ void OptimizedPredictionCollector::normalize_prediction_values(size_t num_leaves
   }
 }
 
-void OptimizedPredictionCollector::validate_prediction(size_t sample,
-                                                       const Prediction& prediction) const {
-  size_t prediction_length = strategy->prediction_length();
-  if (prediction.size() != prediction_length) {
-    throw std::runtime_error("Prediction for sample " + std::to_string(sample) +
-                             " did not have the expected length.");
-  }
-}
-
 } // namespace grf
@@ -28,24 +28,39 @@ class OptimizedPredictionCollector final: public PredictionCollector {
 public:
   OptimizedPredictionCollector(std::unique_ptr<OptimizedPredictionStrategy> strategy, uint num_threads);
 
-  std::vector<Prediction> collect_predictions(const Forest& forest,
-                                              const Data& train_data,
-                                              const Data& data,
-                                              const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                              const std::vector<std::vector<bool>>& valid_trees_by_sample,
-                                              bool estimate_variance,
-                                              bool estimate_error) const;
+  void collect_predictions(const Forest& forest,
+                           const Data& train_data,
+                           const Data& data,
+                           const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                           const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                           PredictionOutput& output) const;
+
+  void collect_predictions_direct(const Forest& forest,
+                                  const Data& train_data,
+                                  const Data& data,
+                                  PredictionOutput& output,
+                                  PredictionScratch& scratch) const;
+
+  size_t get_prediction_length() const;
+
+  bool supports_error_estimates() const;
 
 private:
-  std::vector<Prediction> collect_predictions_batch(const Forest& forest,
-                                                    const Data& train_data,
-                                                    const Data& data,
-                                                    const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                    const std::vector<std::vector<bool>>& valid_trees_by_sample,
-                                                    bool estimate_variance,
-                                                    bool estimate_error,
-                                                    size_t start,
-                                                    size_t num_samples) const;
+  /**
+   * Checks that every tree of the forest holds prediction values of the length this
+   * strategy reads, for example to reject a forest trained for a different number of
+   * classes or arms.
+   */
+  void check_prediction_values(const Forest& forest) const;
+
+  void collect_predictions_batch(const Forest& forest,
+                                 const Data& train_data,
+                                 const Data& data,
+                                 const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                                 const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                 size_t start,
+                                 size_t num_samples,
+                                 PredictionOutput& output) const;
 
   void add_prediction_values(size_t node,
                              const PredictionValues& prediction_values,
@@ -54,9 +69,6 @@ private:
   void normalize_prediction_values(size_t num_leaves,
                                    std::vector<double>& combined_average) const;
 
-  void validate_prediction(size_t sample,
-                           const Prediction& prediction) const;
-
   std::unique_ptr<OptimizedPredictionStrategy> strategy;
   uint num_threads;
 };
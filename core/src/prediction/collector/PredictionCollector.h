@@ -19,6 +19,8 @@
 #define GRF_PREDICTIONCOLLECTOR_H
 
 #include "forest/Forest.h"
+#include "prediction/PredictionOutput.h"
+#include "prediction/collector/PredictionScratch.h"
 
 namespace grf {
 
@@ -27,13 +29,37 @@ public:
 
   virtual ~PredictionCollector() = default;
 
-  virtual std::vector<Prediction> collect_predictions(const Forest& forest,
-                                                      const Data& train_data,
-                                                      const Data& data,
-                                                      const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                      const std::vector<std::vector<bool>>& valid_trees_by_sample,
-                                                      bool estimate_variance,
-                                                      bool estimate_error) const = 0;
+  /**
+   * Computes the predictions for every sample in data and writes them into output.
+   * Variance estimates are computed if output has a variance buffer, and error
+   * estimates if it has error buffers.
+   */
+  virtual void collect_predictions(const Forest& forest,
+                                   const Data& train_data,
+                                   const Data& data,
+                                   const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                                   const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                   PredictionOutput& output) const = 0;
+
+  /**
+   * Computes the predictions for every sample in data on the calling thread, finding
+   * each sample's leaf in every tree as the trees are visited instead of first
+   * traversing the trees for all samples. This avoids the per-tree leaf buffers and
+   * thread dispatch of collect_predictions, which dominate when predicting only a
+   * few samples. Error estimates are not computed.
+   */
+  virtual void collect_predictions_direct(const Forest& forest,
+                                          const Data& train_data,
+                                          const Data& data,
+                                          PredictionOutput& output,
+                                          PredictionScratch& scratch) const = 0;
+
+  virtual size_t get_prediction_length() const = 0;
+
+  /**
+   * Whether this collector's strategy computes error estimates for out-of-bag predictions.
+   */
+  virtual bool supports_error_estimates() const = 0;
 };
 
 } // namespace grf
@@ -0,0 +1,48 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "prediction/collector/PredictionScratch.h"
+
+namespace grf {
+
+std::vector<size_t>& PredictionScratch::get_leaf_nodes() {
+  return leaf_nodes;
+}
+
+std::vector<double>& PredictionScratch::get_average_values() {
+  return average_values;
+}
+
+std::vector<size_t>& PredictionScratch::get_num_leaves() {
+  return num_leaves;
+}
+
+std::vector<LeafValueMoments>& PredictionScratch::get_leaf_value_moments(size_t num_samples,
+                                                                         size_t num_types,
+                                                                         size_t ci_group_size) {
+  if (!leaf_value_moments.empty() &&
+      (leaf_value_moments[0].get_num_types() != num_types ||
+       leaf_value_moments[0].get_ci_group_size() != ci_group_size)) {
+    leaf_value_moments.clear();
+  }
+  if (leaf_value_moments.size() < num_samples) {
+    leaf_value_moments.resize(num_samples, LeafValueMoments(num_types, ci_group_size));
+  }
+  return leaf_value_moments;
+}
+
+} // namespace grf
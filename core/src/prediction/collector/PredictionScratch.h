@@ -0,0 +1,70 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_PREDICTIONSCRATCH_H
+#define GRF_PREDICTIONSCRATCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include "prediction/LeafValueMoments.h"
+
+namespace grf {
+
+/**
+ * Working memory for ForestPredictor::predict_micro_batch, owned by the caller so that
+ * repeated predictions for a few samples at a time do not allocate once the buffers
+ * have grown to size.
+ *
+ * A scratch object may be reused across forests and predictors, but must not be used
+ * by several threads at once.
+ */
+class PredictionScratch {
+public:
+  /**
+   * Buffer for the leaf nodes the samples fall into, one entry per sample and tree.
+   */
+  std::vector<size_t>& get_leaf_nodes();
+
+  /**
+   * Buffer for the summed leaf prediction values of each sample.
+   */
+  std::vector<double>& get_average_values();
+
+  /**
+   * Buffer for the number of trees with leaf prediction values for each sample.
+   */
+  std::vector<size_t>& get_num_leaves();
+
+  /**
+   * Returns moments storage for num_samples samples of the given shape. The storage
+   * is only reallocated when the shape differs from the previous call.
+   */
+  std::vector<LeafValueMoments>& get_leaf_value_moments(size_t num_samples,
+                                                        size_t num_types,
+                                                        size_t ci_group_size);
+
+private:
+  std::vector<size_t> leaf_nodes;
+  std::vector<double> average_values;
+  std::vector<size_t> num_leaves;
+  std::vector<LeafValueMoments> leaf_value_moments;
+};
+
+} // namespace grf
+
+#endif //GRF_PREDICTIONSCRATCH_H
@@ -15,6 +15,8 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <stdexcept>
+
 #include "SampleWeightComputer.h"
 
 #include "tree/Tree.h"
@@ -37,6 +39,9 @@ std::unordered_map<size_t, double> SampleWeightComputer::compute_weights(size_t
     size_t node = leaf_nodes.at(sample);
 
     const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
+    if (!tree->has_leaf_samples()) {
+      throw std::runtime_error("Sample weights cannot be computed, as this forest does not contain leaf samples.");
+    }
     const std::vector<size_t>& samples = tree->get_leaf_samples()[node];
     if (!samples.empty()) {
       add_sample_weights(samples, weights_by_sample);
@@ -47,6 +52,25 @@ std::unordered_map<size_t, double> SampleWeightComputer::compute_weights(size_t
   return weights_by_sample;
 }
 
+std::unordered_map<size_t, double> SampleWeightComputer::compute_weights(const Forest& forest,
+                                                                         const size_t* leaf_nodes) const {
+  std::unordered_map<size_t, double> weights_by_sample;
+
+  for (size_t tree_index = 0; tree_index < forest.get_trees().size(); ++tree_index) {
+    const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
+    if (!tree->has_leaf_samples()) {
+      throw std::runtime_error("Sample weights cannot be computed, as this forest does not contain leaf samples.");
+    }
+    const std::vector<size_t>& samples = tree->get_leaf_samples()[leaf_nodes[tree_index]];
+    if (!samples.empty()) {
+      add_sample_weights(samples, weights_by_sample);
+    }
+  }
+
+  normalize_sample_weights(weights_by_sample);
+  return weights_by_sample;
+}
+
 void SampleWeightComputer::add_sample_weights(const std::vector<size_t>& samples,
                                               std::unordered_map<size_t, double>& weights_by_sample) const {
   double sample_weight = 1.0 / samples.size();
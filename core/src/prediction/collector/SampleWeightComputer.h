@@ -32,6 +32,13 @@ public:
                                                      const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
                                                      const std::vector<std::vector<bool>>& valid_trees_by_sample) const;
 
+  /**
+   * Computes the weights of a single test sample, where leaf_nodes[t] is the leaf node
+   * it falls into in tree t of the forest.
+   */
+  std::unordered_map<size_t, double> compute_weights(const Forest& forest,
+                                                     const size_t* leaf_nodes) const;
+
 private:
   void add_sample_weights(const std::vector<size_t>& samples,
                           std::unordered_map<size_t, double>& weights_by_sample) const;
@@ -19,6 +19,7 @@
 #include "commons/utility.h"
 
 #include <future>
+#include <numeric>
 
 namespace grf {
 
@@ -72,9 +73,10 @@ std::vector<std::vector<bool>> TreeTraverser::get_valid_trees_by_sample(const Fo
 
   std::vector<std::vector<bool>> result(num_samples, std::vector<bool>(num_trees, true));
   if (oob_prediction) {
-    for (size_t tree_idx = 0; tree_idx < num_trees; ++tree_idx) {
-      for (size_t sample : forest.get_trees()[tree_idx]->get_drawn_samples()) {
-        result[sample][tree_idx] = false;
+    for (size_t sample = 0; sample < num_samples; ++sample) {
+      std::vector<bool>& valid_trees = result[sample];
+      for (size_t tree_idx = 0; tree_idx < num_trees; ++tree_idx) {
+        valid_trees[tree_idx] = !forest.get_trees()[tree_idx]->is_drawn(sample);
       }
     }
   }
@@ -90,28 +92,21 @@ std::vector<std::vector<size_t>> TreeTraverser::get_leaf_node_batch(
 
   size_t num_samples = data.get_num_rows();
   std::vector<std::vector<size_t>> all_leaf_nodes(num_trees);
+  // When predicting on all samples, the compact leaf buffer for the sample IDs
+  // 0, ..., num_samples - 1 is already indexed by sample, and is filled in place.
+  std::vector<size_t> all_samples(oob_prediction ? 0 : num_samples);
+  std::iota(all_samples.begin(), all_samples.end(), 0);
 
   for (size_t i = 0; i < num_trees; ++i) {
     const std::unique_ptr<Tree>& tree = forest.get_trees()[start + i];
-
-    std::vector<bool> valid_samples = get_valid_samples(num_samples, tree, oob_prediction);
-    std::vector<size_t> leaf_nodes = tree->find_leaf_nodes(data, valid_samples);
-    all_leaf_nodes[i] = leaf_nodes;
+    if (oob_prediction) {
+      all_leaf_nodes[i] = tree->find_oob_leaf_nodes(data);
+    } else {
+      tree->find_leaf_nodes(data, all_samples, all_leaf_nodes[i]);
+    }
   }
 
   return all_leaf_nodes;
 }
 
-std::vector<bool> TreeTraverser::get_valid_samples(size_t num_samples,
-                                                   const std::unique_ptr<Tree>& tree,
-                                                   bool oob_prediction) const {
-  std::vector<bool> valid_samples(num_samples, true);
-  if (oob_prediction) {
-    for (size_t sample : tree->get_drawn_samples()) {
-      valid_samples[sample] = false;
-    }
-  }
-  return valid_samples;
-}
-
 } // namespace grf
@@ -43,10 +43,6 @@ private:
       const Data& data,
       bool oob_prediction) const;
 
-  std::vector<bool> get_valid_samples(size_t num_samples,
-                                      const std::unique_ptr<Tree>& tree,
-                                      bool oob_prediction) const;
-
   uint num_threads;
 };
 
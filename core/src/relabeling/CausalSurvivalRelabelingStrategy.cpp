@@ -23,7 +23,7 @@ namespace grf {
 bool CausalSurvivalRelabelingStrategy::relabel(
     const std::vector<size_t>& samples,
     const Data& data,
-    Eigen::ArrayXXd& responses_by_sample) const {
+    RowMajorArrayXXd& responses_by_sample) const {
 
   // Prepare the relevant averages.
   double numerator_sum = 0;
@@ -44,10 +44,11 @@ bool CausalSurvivalRelabelingStrategy::relabel(
   double eta = numerator_sum / denominator_sum;
 
   // Create the new outcomes.
-  for (size_t sample : samples) {
+  for (size_t i = 0; i < samples.size(); i++) {
+    size_t sample = samples[i];
     double response = (data.get_causal_survival_numerator(sample) -
       data.get_causal_survival_denominator(sample) * eta) / denominator_sum;
-    responses_by_sample(sample, 0) = response;
+    responses_by_sample(i, 0) = response;
   }
   return false;
 }
@@ -29,7 +29,7 @@ InstrumentalRelabelingStrategy::InstrumentalRelabelingStrategy(double reduced_fo
 bool InstrumentalRelabelingStrategy::relabel(
     const std::vector<size_t>& samples,
     const Data& data,
-    Eigen::ArrayXXd& responses_by_sample) const {
+    RowMajorArrayXXd& responses_by_sample) const {
 
   // Prepare the relevant averages.
   double sum_weight = 0.0;
@@ -79,14 +79,15 @@ bool InstrumentalRelabelingStrategy::relabel(
   double local_average_treatment_effect = numerator / denominator;
 
   // Create the new outcomes.
-  for (size_t sample : samples) {
+  for (size_t i = 0; i < samples.size(); i++) {
+    size_t sample = samples[i];
     double response = data.get_outcome(sample);
     double treatment = data.get_treatment(sample);
     double instrument = data.get_instrument(sample);
     double regularized_instrument = (1 - reduced_form_weight) * instrument + reduced_form_weight * treatment;
 
     double residual = (response - average_outcome) - local_average_treatment_effect * (treatment - average_treatment);
-    responses_by_sample(sample, 0) = (regularized_instrument - average_regularized_instrument) * residual;
+    responses_by_sample(i, 0) = (regularized_instrument - average_regularized_instrument) * residual;
   }
   return false;
 }
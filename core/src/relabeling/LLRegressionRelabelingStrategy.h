@@ -32,7 +32,7 @@ public:
   bool relabel(
       const std::vector<size_t>& samples,
       const Data& data,
-      Eigen::ArrayXXd& responses_by_sample) const;
+      RowMajorArrayXXd& responses_by_sample) const;
 private:
     double split_lambda;
     bool weight_penalty;
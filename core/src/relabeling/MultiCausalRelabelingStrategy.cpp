@@ -26,7 +26,7 @@ MultiCausalRelabelingStrategy::MultiCausalRelabelingStrategy(size_t response_len
 bool MultiCausalRelabelingStrategy::relabel(
     const std::vector<size_t>& samples,
     const Data& data,
-    Eigen::ArrayXXd& responses_by_sample) const {
+    RowMajorArrayXXd& responses_by_sample) const {
 
   // Prepare the relevant averages.
   size_t num_samples = samples.size();
@@ -77,13 +77,12 @@ bool MultiCausalRelabelingStrategy::relabel(
   Eigen::MatrixXd residual = Y_centered - W_centered * beta; // [num_samples X num_outcomes]
 
   // Create the new outcomes, eq (20) in https://arxiv.org/pdf/1610.01271.pdf
-  // `responses_by_sample(sample_i, )` is a `num_treatments*num_outcomes`-sized vector.
+  // `responses_by_sample(i, )` is a `num_treatments*num_outcomes`-sized vector.
   for (size_t i = 0; i < num_samples; i++) {
-    size_t sample = samples[i];
     size_t j = 0;
     for (size_t outcome = 0; outcome < num_outcomes; outcome++) {
       for (size_t treatment = 0; treatment < num_treatments; treatment++) {
-        responses_by_sample(sample, j) = rho_weight(i, treatment) * residual(i, outcome);
+        responses_by_sample(i, j) = rho_weight(i, treatment) * residual(i, outcome);
         j++;
       }
     }
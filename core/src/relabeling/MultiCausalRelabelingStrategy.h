@@ -45,7 +45,7 @@ public:
   bool relabel(
       const std::vector<size_t>& samples,
       const Data& data,
-      Eigen::ArrayXXd& responses_by_sample) const;
+      RowMajorArrayXXd& responses_by_sample) const;
 
   size_t get_response_length() const;
 
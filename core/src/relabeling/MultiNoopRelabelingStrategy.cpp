@@ -25,10 +25,10 @@
  bool MultiNoopRelabelingStrategy::relabel(
      const std::vector<size_t>& samples,
      const Data& data,
-     Eigen::ArrayXXd& responses_by_sample) const {
+     RowMajorArrayXXd& responses_by_sample) const {
 
-   for (size_t sample : samples) {
-     responses_by_sample.row(sample) = data.get_outcomes(sample);
+   for (size_t i = 0; i < samples.size(); i++) {
+     responses_by_sample.row(i) = data.get_outcomes(samples[i]);
    }
    return false;
  }
@@ -22,11 +22,11 @@
  bool NoopRelabelingStrategy::relabel(
      const std::vector<size_t>& samples,
      const Data& data,
-     Eigen::ArrayXXd& responses_by_sample) const {
+     RowMajorArrayXXd& responses_by_sample) const {
 
-   for (size_t sample : samples) {
-     double outcome = data.get_outcome(sample);
-     responses_by_sample(sample, 0) = outcome;
+   for (size_t i = 0; i < samples.size(); i++) {
+     double outcome = data.get_outcome(samples[i]);
+     responses_by_sample(i, 0) = outcome;
    }
    return false;
  }
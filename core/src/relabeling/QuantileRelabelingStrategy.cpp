@@ -26,7 +26,7 @@ QuantileRelabelingStrategy::QuantileRelabelingStrategy(const std::vector<double>
 bool QuantileRelabelingStrategy::relabel(
     const std::vector<size_t>& samples,
     const Data& data,
-    Eigen::ArrayXXd& responses_by_sample) const {
+    RowMajorArrayXXd& responses_by_sample) const {
 
   std::vector<double> sorted_outcomes(samples.size());
   for (size_t i = 0; i < samples.size(); i++) {
@@ -49,13 +49,13 @@ bool QuantileRelabelingStrategy::relabel(
                          quantile_cutoffs.end());
 
   // Assign a class to each response based on what quantile it belongs to.
-  for (size_t sample : samples) {
-    double outcome = data.get_outcome(sample);
+  for (size_t i = 0; i < samples.size(); i++) {
+    double outcome = data.get_outcome(samples[i]);
     auto quantile = std::lower_bound(quantile_cutoffs.begin(),
                                      quantile_cutoffs.end(),
                                      outcome);
     long quantile_index = static_cast<long>(quantile - quantile_cutoffs.begin());
-    responses_by_sample(sample, 0) = static_cast<uint>(quantile_index);
+    responses_by_sample(i, 0) = static_cast<uint>(quantile_index);
   }
   return false;
 }
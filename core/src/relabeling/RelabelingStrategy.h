@@ -25,6 +25,12 @@
 
 namespace grf {
 
+/**
+ * The relabeled responses of the samples in a node, one row per sample. The array is row major,
+ * so that the response vector of each sample is contiguous.
+ */
+typedef Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorArrayXXd;
+
 /**
  * Produces a relabelled set of outcomes for a set of training samples. These outcomes
  * will then be used in calculating a standard regression (or classification) split.
@@ -40,22 +46,23 @@ public:
  /**
    * samples: the subset of samples to relabel.
    * data: the training data matrix.
-   * responses_by_sample: the output of the method, an array of relabelled response for each sample ID in `samples`.
-   * The dimension of this array is N * K where N is the total number of samples in the data, and K is given
-   * by `get_response_length()`.
+   * responses_by_sample: the output of the method, an array with the relabelled response of `samples[i]`
+   * in row i. The array has at least N rows and K columns, where N is the number of samples in `samples`,
+   * and K is given by `get_response_length()`.
    *
    * In most cases, like a single-variable regression forest, K is 1, and `responses_by_sample` is a scalar for
    * each sample. In other forests, like multi-output regression forest, K is equal to the number of outcomes,
    * and `responses_by_sample` is a length K vector for each sample (working with a vector-valued splitting rule).
    *
-   * Note that for performance reasons (avoiding clearing out the array after each split) this array may
-   * contain garbage values for indices outside of the given set of sample IDs.
+   * The rows follow the order of `samples`, so that the splitting rules scan a compact buffer instead of
+   * indexing an array over all samples in the data. Note that for performance reasons (avoiding
+   * reallocating the array for each node) this array may contain garbage values in rows N and above.
    *
    * returns: a boolean that will be 'true' if splitting should stop early.
    */
   virtual bool relabel(const std::vector<size_t>& samples,
                        const Data& data,
-                       Eigen::ArrayXXd& responses_by_sample) const = 0;
+                       RowMajorArrayXXd& responses_by_sample) const = 0;
 
  /**
    * Override to specify the column dimension of `responses_by_sample`.
@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 
 #include "CausalSurvivalSplittingRule.h"
 
@@ -65,7 +66,8 @@ CausalSurvivalSplittingRule::~CausalSurvivalSplittingRule() {
 bool CausalSurvivalSplittingRule::find_best_split(const Data& data,
                                                   size_t node,
                                                   const std::vector<size_t>& possible_split_vars,
-                                                  const Eigen::ArrayXXd& responses_by_sample,
+                                                  const RowMajorArrayXXd& responses_by_sample,
+                                                  const std::vector<double>& weights_by_sample,
                                                   const std::vector<std::vector<size_t>>& samples,
                                                   std::vector<size_t>& split_vars,
                                                   std::vector<double>& split_values,
@@ -78,12 +80,16 @@ bool CausalSurvivalSplittingRule::find_best_split(const Data& data,
   double sum_node_z = 0.0;
   double sum_node_z_squared = 0.0;
   size_t num_failures_node = 0;
-  for (auto& sample : samples[node]) {
-    double sample_weight = data.get_weight(sample);
+  // Gather the instruments once, so they can be read by position while scanning each split variable.
+  std::vector<double> instruments(num_samples);
+  for (size_t i = 0; i < num_samples; i++) {
+    size_t sample = samples[node][i];
+    double sample_weight = weights_by_sample[i];
     weight_sum_node += sample_weight;
-    sum_node += sample_weight * responses_by_sample(sample, 0);
+    sum_node += sample_weight * responses_by_sample(i, 0);
 
     double z = data.get_instrument(sample);
+    instruments[i] = z;
     sum_node_z += sample_weight * z;
     sum_node_z_squared += sample_weight * z * z;
 
@@ -98,8 +104,7 @@ bool CausalSurvivalSplittingRule::find_best_split(const Data& data,
 
   double mean_z_node = sum_node_z / weight_sum_node;
   size_t num_node_small_z = 0;
-  for (auto& sample : samples[node]) {
-    double z = data.get_instrument(sample);
+  for (double z : instruments) {
     if (z < mean_z_node) {
       num_node_small_z++;
     }
@@ -111,10 +116,13 @@ bool CausalSurvivalSplittingRule::find_best_split(const Data& data,
   double best_decrease = 0.0;
   bool best_send_missing_left = true;
 
+  data.index_samples(samples[node], sample_positions);
+
   for (auto& var : possible_split_vars) {
     find_best_split_value(data, node, var, num_samples, weight_sum_node, sum_node, mean_z_node, num_node_small_z,
                           sum_node_z, sum_node_z_squared, num_failures_node, min_child_size, min_child_size_survival,
-                          best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+                          instruments, best_value, best_var, best_decrease, best_send_missing_left,
+                          responses_by_sample, weights_by_sample, samples);
   }
 
   // Stop if no good split found
@@ -141,15 +149,20 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
                                                         size_t num_failures_node,
                                                         double min_child_size,
                                                         size_t min_child_size_survival,
+                                                        const std::vector<double>& instruments,
                                                         double& best_value,
                                                         size_t& best_var,
                                                         double& best_decrease,
                                                         bool& best_send_missing_left,
-                                                        const Eigen::ArrayXXd& responses_by_sample,
+                                                        const RowMajorArrayXXd& responses_by_sample,
+                                                        const std::vector<double>& weights_by_sample,
                                                         const std::vector<std::vector<size_t>>& samples) {
+  // index: the positions of the node samples in increasing order of their values. For a
+  // sparse variable, only the samples with a nonzero value are listed.
   std::vector<double> possible_split_values;
-  std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+  std::vector<double> sorted_values;
+  std::vector<size_t> index = data.get_split_values(possible_split_values, sorted_values, samples[node],
+                                                    sample_positions, var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -158,13 +171,13 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
 
   size_t num_splits = possible_split_values.size() - 1;
 
-  std::fill(counter, counter + num_splits, 0);
-  std::fill(weight_sums, weight_sums + num_splits, 0);
-  std::fill(sums, sums + num_splits, 0);
-  std::fill(num_small_z, num_small_z + num_splits, 0);
-  std::fill(sums_z, sums_z + num_splits, 0);
-  std::fill(sums_z_squared, sums_z_squared + num_splits, 0);
-  std::fill(failure_count, failure_count + num_splits, 0);
+  std::fill(counter, counter + num_splits + 1, 0);
+  std::fill(weight_sums, weight_sums + num_splits + 1, 0);
+  std::fill(sums, sums + num_splits + 1, 0);
+  std::fill(num_small_z, num_small_z + num_splits + 1, 0);
+  std::fill(sums_z, sums_z + num_splits + 1, 0);
+  std::fill(sums_z_squared, sums_z_squared + num_splits + 1, 0);
+  std::fill(failure_count, failure_count + num_splits + 1, 0);
   size_t n_missing = 0;
   double weight_sum_missing = 0;
   double sum_missing = 0;
@@ -174,16 +187,16 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
   size_t num_failures_missing = 0;
 
   size_t split_index = 0;
-  for (size_t i = 0; i < num_samples - 1; i++) {
-    size_t sample = sorted_samples[i];
-    size_t next_sample = sorted_samples[i + 1];
-    double sample_value = data.get(sample, var);
-    double z = data.get_instrument(sample);
-    double sample_weight = data.get_weight(sample);
+  for (size_t i = 0; i < index.size(); i++) {
+    size_t j = index[i];
+    size_t sample = samples[node][j];
+    double sample_value = sorted_values[i];
+    double z = instruments[j];
+    double sample_weight = weights_by_sample[j];
 
     if (std::isnan(sample_value)) {
       weight_sum_missing += sample_weight;
-      sum_missing += sample_weight * responses_by_sample(sample, 0);
+      sum_missing += sample_weight * responses_by_sample(j, 0);
       ++n_missing;
 
       sum_z_missing += sample_weight * z;
@@ -195,8 +208,12 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
         num_failures_missing++;
       }
     } else {
+      // Move on to the bucket of this value (all comparisons with a leading NaN bucket are false)
+      while (possible_split_values[split_index] != sample_value) {
+        ++split_index;
+      }
       weight_sums[split_index] += sample_weight;
-      sums[split_index] += sample_weight * responses_by_sample(sample, 0);
+      sums[split_index] += sample_weight * responses_by_sample(j, 0);
       ++counter[split_index];
 
       sums_z[split_index] += sample_weight * z;
@@ -208,13 +225,25 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
         ++failure_count[split_index];
       }
     }
+  }
 
-    double next_sample_value = data.get(next_sample, var);
-    // if the next sample value is different, including the transition (..., NaN, Xij, ...)
-    // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
-      ++split_index;
-    }
+  // The samples that are zero in a sparse variable are not listed, so their bucket holds
+  // what remains of the node totals.
+  if (index.size() < num_samples) {
+    size_t zero_index = std::find(possible_split_values.begin(), possible_split_values.end(), 0.0) -
+        possible_split_values.begin();
+    size_t num_buckets = num_splits + 1;
+    counter[zero_index] = num_samples - index.size();
+    num_small_z[zero_index] = num_node_small_z - num_small_z_missing -
+        std::accumulate(num_small_z, num_small_z + num_buckets, size_t(0));
+    failure_count[zero_index] = num_failures_node - num_failures_missing -
+        std::accumulate(failure_count, failure_count + num_buckets, size_t(0));
+    weight_sums[zero_index] = weight_sum_node - weight_sum_missing -
+        std::accumulate(weight_sums, weight_sums + num_buckets, 0.0);
+    sums[zero_index] = sum_node - sum_missing - std::accumulate(sums, sums + num_buckets, 0.0);
+    sums_z[zero_index] = sum_node_z - sum_z_missing - std::accumulate(sums_z, sums_z + num_buckets, 0.0);
+    sums_z_squared[zero_index] = sum_node_z_squared - sum_z_squared_missing -
+        std::accumulate(sums_z_squared, sums_z_squared + num_buckets, 0.0);
   }
 
   size_t n_left = n_missing;
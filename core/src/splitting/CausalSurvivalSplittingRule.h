@@ -40,7 +40,8 @@ public:
   bool find_best_split(const Data& data,
                        size_t node,
                        const std::vector<size_t>& possible_split_vars,
-                       const Eigen::ArrayXXd& responses_by_sample,
+                       const RowMajorArrayXXd& responses_by_sample,
+                       const std::vector<double>& weights_by_sample,
                        const std::vector<std::vector<size_t>>& samples,
                        std::vector<size_t>& split_vars,
                        std::vector<double>& split_values,
@@ -60,13 +61,17 @@ private:
                              size_t num_failures_node,
                              double min_child_size,
                              size_t min_child_size_survival,
+                             const std::vector<double>& instruments,
                              double& best_value,
                              size_t& best_var,
                              double& best_decrease,
                              bool& best_send_missing_left,
-                             const Eigen::ArrayXXd& responses_by_sample,
+                             const RowMajorArrayXXd& responses_by_sample,
+                             const std::vector<double>& weights_by_sample,
                              const std::vector<std::vector<size_t>>& samples);
 
+  std::vector<size_t> sample_positions;
+
   size_t* counter;
   double* weight_sums;
   double* sums;
@@ -16,6 +16,7 @@
  #-------------------------------------------------------------------------------*/
 
 #include <algorithm>
+#include <numeric>
 
 #include "MultiCausalSplittingRule.h"
 
@@ -34,10 +35,10 @@ MultiCausalSplittingRule::MultiCausalSplittingRule(size_t max_num_unique_values,
     num_treatments(num_treatments) {
   this->counter = new size_t[max_num_unique_values];
   this->weight_sums = new double[max_num_unique_values];
-  this->sums = Eigen::ArrayXXd(max_num_unique_values, response_length);
+  this->sums = RowMajorArrayXXd(max_num_unique_values, response_length);
   this->num_small_w = Eigen::ArrayXXi(max_num_unique_values, num_treatments);
-  this->sums_w = Eigen::ArrayXXd(max_num_unique_values, num_treatments);
-  this->sums_w_squared = Eigen::ArrayXXd(max_num_unique_values, num_treatments);
+  this->sums_w = RowMajorArrayXXd(max_num_unique_values, num_treatments);
+  this->sums_w_squared = RowMajorArrayXXd(max_num_unique_values, num_treatments);
 }
 
 MultiCausalSplittingRule::~MultiCausalSplittingRule() {
@@ -52,7 +53,8 @@ MultiCausalSplittingRule::~MultiCausalSplittingRule() {
 bool MultiCausalSplittingRule::find_best_split(const Data& data,
                                                size_t node,
                                                const std::vector<size_t>& possible_split_vars,
-                                               const Eigen::ArrayXXd& responses_by_sample,
+                                               const RowMajorArrayXXd& responses_by_sample,
+                                               const std::vector<double>& weights_by_sample,
                                                const std::vector<std::vector<size_t>>& samples,
                                                std::vector<size_t>& split_vars,
                                                std::vector<double>& split_values,
@@ -65,13 +67,12 @@ bool MultiCausalSplittingRule::find_best_split(const Data& data,
   Eigen::ArrayXd sum_node_w = Eigen::ArrayXd::Zero(num_treatments);
   Eigen::ArrayXd sum_node_w_squared = Eigen::ArrayXd::Zero(num_treatments);
   // Allocate W-array and re-use to avoid expensive copy-inducing calls to `data.get_treatments`
-  Eigen::ArrayXXd treatments = Eigen::ArrayXXd(num_samples, num_treatments);
+  RowMajorArrayXXd treatments(num_samples, num_treatments);
   for (size_t i = 0; i < num_samples; i++) {
-    size_t sample = samples[node][i];
-    double sample_weight = data.get_weight(sample);
+    double sample_weight = weights_by_sample[i];
     weight_sum_node += sample_weight;
-    sum_node += sample_weight * responses_by_sample.row(sample);
-    treatments.row(i) = data.get_treatments(sample);
+    sum_node += sample_weight * responses_by_sample.row(i);
+    treatments.row(i) = data.get_treatments(samples[node][i]);
 
     sum_node_w += sample_weight * treatments.row(i);
     sum_node_w_squared += sample_weight * treatments.row(i).square();
@@ -92,11 +93,13 @@ bool MultiCausalSplittingRule::find_best_split(const Data& data,
   double best_decrease = 0.0;
   bool best_send_missing_left = true;
 
+  data.index_samples(samples[node], sample_positions);
+
   // For all possible split variables
   for (auto& var : possible_split_vars) {
     find_best_split_value(data, node, var, num_samples, weight_sum_node, sum_node, mean_w_node, num_node_small_w,
                           sum_node_w, sum_node_w_squared, min_child_size, treatments, best_value,
-                          best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+                          best_var, best_decrease, best_send_missing_left, responses_by_sample, weights_by_sample, samples);
   }
 
   // Stop if no good split found
@@ -122,16 +125,20 @@ void MultiCausalSplittingRule::find_best_split_value(const Data& data,
                                                      const Eigen::ArrayXd& sum_node_w,
                                                      const Eigen::ArrayXd& sum_node_w_squared,
                                                      const Eigen::ArrayXd& min_child_size,
-                                                     const Eigen::ArrayXXd& treatments,
+                                                     const RowMajorArrayXXd& treatments,
                                                      double& best_value,
                                                      size_t& best_var,
                                                      double& best_decrease,
                                                      bool& best_send_missing_left,
-                                                     const Eigen::ArrayXXd& responses_by_sample,
+                                                     const RowMajorArrayXXd& responses_by_sample,
+                                                     const std::vector<double>& weights_by_sample,
                                                      const std::vector<std::vector<size_t>>& samples) {
+  // index: the positions of the node samples in increasing order of their values. For a
+  // sparse variable, only the samples with a nonzero value are listed.
   std::vector<double> possible_split_values;
-  std::vector<size_t> sorted_samples;
-  std::vector<size_t> index = data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+  std::vector<double> sorted_values;
+  std::vector<size_t> index = data.get_split_values(possible_split_values, sorted_values, samples[node],
+                                                    sample_positions, var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -139,13 +146,14 @@ void MultiCausalSplittingRule::find_best_split_value(const Data& data,
   }
 
   size_t num_splits = possible_split_values.size() - 1;
-
-  std::fill(counter, counter + num_splits, 0);
-  std::fill(weight_sums, weight_sums + num_splits, 0);
-  sums.topRows(num_splits).setZero();
-  num_small_w.topRows(num_splits).setZero();
-  sums_w.topRows(num_splits).setZero();
-  sums_w_squared.topRows(num_splits).setZero();
+  size_t num_buckets = num_splits + 1;
+
+  std::fill(counter, counter + num_buckets, 0);
+  std::fill(weight_sums, weight_sums + num_buckets, 0);
+  sums.topRows(num_buckets).setZero();
+  num_small_w.topRows(num_buckets).setZero();
+  sums_w.topRows(num_buckets).setZero();
+  sums_w_squared.topRows(num_buckets).setZero();
   size_t n_missing = 0;
   double weight_sum_missing = 0;
   Eigen::ArrayXd sum_missing = Eigen::ArrayXd::Zero(response_length);
@@ -154,37 +162,48 @@ void MultiCausalSplittingRule::find_best_split_value(const Data& data,
   Eigen::ArrayXi num_small_w_missing = Eigen::ArrayXi::Zero(num_treatments);
 
   size_t split_index = 0;
-  for (size_t i = 0; i < num_samples - 1; i++) {
-    size_t sample = sorted_samples[i];
-    size_t next_sample = sorted_samples[i + 1];
+  for (size_t i = 0; i < index.size(); i++) {
     size_t sort_index = index[i];
-    double sample_value = data.get(sample, var);
-    double sample_weight = data.get_weight(sample);
+    double sample_value = sorted_values[i];
+    double sample_weight = weights_by_sample[sort_index];
 
     if (std::isnan(sample_value)) {
       weight_sum_missing += sample_weight;
-      sum_missing += sample_weight * responses_by_sample.row(sample);
+      sum_missing += sample_weight * responses_by_sample.row(sort_index);
       ++n_missing;
 
       sum_w_missing += sample_weight * treatments.row(sort_index);
       sum_w_squared_missing += sample_weight * treatments.row(sort_index).square();
       num_small_w_missing += (treatments.row(sort_index).transpose() < mean_node_w).cast<int>();
     } else {
+      // Move on to the bucket of this value (all comparisons with a leading NaN bucket are false)
+      while (possible_split_values[split_index] != sample_value) {
+        ++split_index;
+      }
       weight_sums[split_index] += sample_weight;
-      sums.row(split_index) += sample_weight * responses_by_sample.row(sample);
+      sums.row(split_index) += sample_weight * responses_by_sample.row(sort_index);
       ++counter[split_index];
 
       sums_w.row(split_index) += sample_weight * treatments.row(sort_index);
       sums_w_squared.row(split_index) += sample_weight * treatments.row(sort_index).square();
       num_small_w.row(split_index) += (treatments.row(sort_index).transpose() < mean_node_w).cast<int>();
     }
+  }
 
-    double next_sample_value = data.get(next_sample, var);
-    // if the next sample value is different, including the transition (..., NaN, Xij, ...)
-    // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
-      ++split_index;
-    }
+  // The samples that are zero in a sparse variable are not listed, so their bucket holds
+  // what remains of the node totals.
+  if (index.size() < num_samples) {
+    size_t zero_index = std::find(possible_split_values.begin(), possible_split_values.end(), 0.0) -
+        possible_split_values.begin();
+    counter[zero_index] = num_samples - index.size();
+    weight_sums[zero_index] = weight_sum_node - weight_sum_missing -
+        std::accumulate(weight_sums, weight_sums + num_buckets, 0.0);
+    sums.row(zero_index) = (sum_node - sum_missing).transpose() - sums.topRows(num_buckets).colwise().sum();
+    num_small_w.row(zero_index) = (num_node_small_w - num_small_w_missing).transpose() -
+        num_small_w.topRows(num_buckets).colwise().sum();
+    sums_w.row(zero_index) = (sum_node_w - sum_w_missing).transpose() - sums_w.topRows(num_buckets).colwise().sum();
+    sums_w_squared.row(zero_index) = (sum_node_w_squared - sum_w_squared_missing).transpose() -
+        sums_w_squared.topRows(num_buckets).colwise().sum();
   }
 
   size_t n_left = n_missing;
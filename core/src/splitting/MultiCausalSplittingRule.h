@@ -53,7 +53,8 @@ public:
   bool find_best_split(const Data& data,
                        size_t node,
                        const std::vector<size_t>& possible_split_vars,
-                       const Eigen::ArrayXXd& responses_by_sample,
+                       const RowMajorArrayXXd& responses_by_sample,
+                       const std::vector<double>& weights_by_sample,
                        const std::vector<std::vector<size_t>>& samples,
                        std::vector<size_t>& split_vars,
                        std::vector<double>& split_values,
@@ -71,20 +72,23 @@ private:
                              const Eigen::ArrayXd& sum_node_w,
                              const Eigen::ArrayXd& sum_node_w_squared,
                              const Eigen::ArrayXd& min_child_size,
-                             const Eigen::ArrayXXd& treatments,
+                             const RowMajorArrayXXd& treatments,
                              double& best_value,
                              size_t& best_var,
                              double& best_decrease,
                              bool& best_send_missing_left,
-                             const Eigen::ArrayXXd& responses_by_sample,
+                             const RowMajorArrayXXd& responses_by_sample,
+                             const std::vector<double>& weights_by_sample,
                              const std::vector<std::vector<size_t>>& samples);
 
+  std::vector<size_t> sample_positions;
+
   size_t* counter;
   double* weight_sums;
-  Eigen::ArrayXXd sums;
+  RowMajorArrayXXd sums;
   Eigen::ArrayXXi num_small_w;
-  Eigen::ArrayXXd sums_w;
-  Eigen::ArrayXXd sums_w_squared;
+  RowMajorArrayXXd sums_w;
+  RowMajorArrayXXd sums_w_squared;
 
   uint min_node_size;
   double alpha;
@@ -16,6 +16,7 @@
  #-------------------------------------------------------------------------------*/
 
 #include <algorithm>
+#include <numeric>
 
 #include "MultiRegressionSplittingRule.h"
 
@@ -29,7 +30,7 @@ MultiRegressionSplittingRule::MultiRegressionSplittingRule(size_t max_num_unique
     imbalance_penalty(imbalance_penalty),
     num_outcomes(num_outcomes) {
   this->counter = new size_t[max_num_unique_values];
-  this->sums = Eigen::ArrayXXd(max_num_unique_values, num_outcomes);
+  this->sums = RowMajorArrayXXd(max_num_unique_values, num_outcomes);
   this->weight_sums = new double[max_num_unique_values];
 }
 
@@ -45,7 +46,8 @@ MultiRegressionSplittingRule::~MultiRegressionSplittingRule() {
 bool MultiRegressionSplittingRule::find_best_split(const Data& data,
                                                    size_t node,
                                                    const std::vector<size_t>& possible_split_vars,
-                                                   const Eigen::ArrayXXd& responses_by_sample,
+                                                   const RowMajorArrayXXd& responses_by_sample,
+                                                   const std::vector<double>& weights_by_sample,
                                                    const std::vector<std::vector<size_t>>& samples,
                                                    std::vector<size_t>& split_vars,
                                                    std::vector<double>& split_values,
@@ -57,10 +59,10 @@ bool MultiRegressionSplittingRule::find_best_split(const Data& data,
   // Precompute the sum of outcomes in this node.
   Eigen::ArrayXd sum_node = Eigen::ArrayXd::Zero(num_outcomes);
   double weight_sum_node = 0.0;
-  for (auto& sample : samples[node]) {
-    double sample_weight = data.get_weight(sample);
+  for (size_t i = 0; i < size_node; i++) {
+    double sample_weight = weights_by_sample[i];
     weight_sum_node += sample_weight;
-    sum_node += sample_weight * responses_by_sample.row(sample);
+    sum_node += sample_weight * responses_by_sample.row(i);
   }
 
   // Initialize the variables to track the best split variable.
@@ -69,10 +71,12 @@ bool MultiRegressionSplittingRule::find_best_split(const Data& data,
   double best_decrease = 0.0;
   bool best_send_missing_left = true;
 
+  data.index_samples(samples[node], sample_positions);
+
   // For all possible split variables
   for (auto& var : possible_split_vars) {
     find_best_split_value(data, node, var, weight_sum_node, sum_node, size_node, min_child_size,
-                          best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+                          best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, weights_by_sample, samples);
   }
 
   // Stop if no good split found
@@ -95,12 +99,15 @@ void MultiRegressionSplittingRule::find_best_split_value(const Data& data,
                                                     size_t min_child_size,
                                                     double& best_value, size_t& best_var,
                                                     double& best_decrease, bool& best_send_missing_left,
-                                                    const Eigen::ArrayXXd& responses_by_sample,
+                                                    const RowMajorArrayXXd& responses_by_sample,
+                                                    const std::vector<double>& weights_by_sample,
                                                     const std::vector<std::vector<size_t>>& samples) {
-  // sorted_samples: the node samples in increasing order (may contain duplicated Xij). Length: size_node
+  // index: the positions of the node samples in increasing order of their values (may contain
+  // duplicated Xij). For a sparse variable, only the samples with a nonzero value are listed.
   std::vector<double> possible_split_values;
-  std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+  std::vector<double> sorted_values;
+  std::vector<size_t> index = data.get_split_values(possible_split_values, sorted_values, samples[node],
+                                                    sample_positions, var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -108,37 +115,45 @@ void MultiRegressionSplittingRule::find_best_split_value(const Data& data,
   }
 
   size_t num_splits = possible_split_values.size() - 1; // -1: we do not split at the last value
-  std::fill(weight_sums, weight_sums + num_splits, 0);
-  std::fill(counter, counter + num_splits, 0);
-  sums.topRows(num_splits).setZero(); // Sets the first num_splits rows to zeros.
+  std::fill(weight_sums, weight_sums + num_splits + 1, 0);
+  std::fill(counter, counter + num_splits + 1, 0);
+  sums.topRows(num_splits + 1).setZero(); // Sets the first num_splits + 1 rows to zeros.
   size_t n_missing = 0;
   double weight_sum_missing = 0;
   Eigen::ArrayXd sum_missing = Eigen::ArrayXd::Zero(num_outcomes);
 
   // Fill counter and sums buckets
   size_t split_index = 0;
-  for (size_t i = 0; i < size_node - 1; i++) {
-    size_t sample = sorted_samples[i];
-    size_t next_sample = sorted_samples[i + 1];
-    double sample_value = data.get(sample, var);
-    double sample_weight = data.get_weight(sample);
+  for (size_t i = 0; i < index.size(); i++) {
+    size_t j = index[i];
+    double sample_value = sorted_values[i];
+    double sample_weight = weights_by_sample[j];
 
     if (std::isnan(sample_value)) {
       weight_sum_missing += sample_weight;
-      sum_missing += sample_weight * responses_by_sample.row(sample);
+      sum_missing += sample_weight * responses_by_sample.row(j);
       ++n_missing;
     } else {
+      // Move on to the bucket of this value (all comparisons with a leading NaN bucket are false)
+      while (possible_split_values[split_index] != sample_value) {
+        ++split_index;
+      }
       weight_sums[split_index] += sample_weight;
-      sums.row(split_index) += sample_weight * responses_by_sample.row(sample);
+      sums.row(split_index) += sample_weight * responses_by_sample.row(j);
       ++counter[split_index];
     }
+  }
 
-    double next_sample_value = data.get(next_sample, var);
-    // if the next sample value is different, including the transition (..., NaN, Xij, ...)
-    // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
-      ++split_index;
-    }
+  // The samples that are zero in a sparse variable are not listed, so their bucket holds
+  // what remains of the node totals.
+  if (index.size() < size_node) {
+    size_t zero_index = std::find(possible_split_values.begin(), possible_split_values.end(), 0.0) -
+        possible_split_values.begin();
+    size_t num_buckets = num_splits + 1;
+    counter[zero_index] = size_node - index.size();
+    weight_sums[zero_index] = weight_sum_node - weight_sum_missing -
+        std::accumulate(weight_sums, weight_sums + num_buckets, 0.0);
+    sums.row(zero_index) = (sum_node - sum_missing).transpose() - sums.topRows(num_buckets).colwise().sum();
   }
 
   size_t n_left = n_missing;
@@ -41,7 +41,8 @@ public:
   bool find_best_split(const Data& data,
                        size_t node,
                        const std::vector<size_t>& possible_split_vars,
-                       const Eigen::ArrayXXd& responses_by_sample,
+                       const RowMajorArrayXXd& responses_by_sample,
+                       const std::vector<double>& weights_by_sample,
                        const std::vector<std::vector<size_t>>& samples,
                        std::vector<size_t>& split_vars,
                        std::vector<double>& split_values,
@@ -59,11 +60,14 @@ private:
                              size_t& best_var,
                              double& best_decrease,
                              bool& best_send_missing_left,
-                             const Eigen::ArrayXXd& responses_by_sample,
+                             const RowMajorArrayXXd& responses_by_sample,
+                             const std::vector<double>& weights_by_sample,
                              const std::vector<std::vector<size_t>>& samples);
 
+  std::vector<size_t> sample_positions;
+
   size_t* counter;
-  Eigen::ArrayXXd sums;
+  RowMajorArrayXXd sums;
   double* weight_sums;
 
   double alpha;
@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 
 #include "ProbabilitySplittingRule.h"
 
@@ -47,7 +48,8 @@ ProbabilitySplittingRule::~ProbabilitySplittingRule() {
 bool ProbabilitySplittingRule::find_best_split(const Data& data,
                                                size_t node,
                                                const std::vector<size_t>& possible_split_vars,
-                                               const Eigen::ArrayXXd& responses_by_sample,
+                                               const RowMajorArrayXXd& responses_by_sample,
+                                               const std::vector<double>& weights_by_sample,
                                                const std::vector<std::vector<size_t>>& samples,
                                                std::vector<size_t>& split_vars,
                                                std::vector<double>& split_values,
@@ -57,9 +59,8 @@ bool ProbabilitySplittingRule::find_best_split(const Data& data,
 
   double* class_counts = new double[num_classes]();
   for (size_t i = 0; i < size_node; ++i) {
-    size_t sample = samples[node][i];
-    uint sample_class = (uint) std::round(responses_by_sample(sample, 0));
-    double sample_weight = data.get_weight(sample);
+    uint sample_class = (uint) std::round(responses_by_sample(i, 0));
+    double sample_weight = weights_by_sample[i];
     class_counts[sample_class] += sample_weight;
   }
 
@@ -69,10 +70,12 @@ bool ProbabilitySplittingRule::find_best_split(const Data& data,
   double best_decrease = 0.0;
   bool best_send_missing_left = true;
 
+  data.index_samples(samples[node], sample_positions);
+
   // For all possible split variables
   for (size_t var : possible_split_vars) {
     find_best_split_value(data, node, var, num_classes, class_counts, size_node, min_child_size,
-                          best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+                          best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, weights_by_sample, samples);
   }
 
   delete[] class_counts;
@@ -100,11 +103,15 @@ void ProbabilitySplittingRule::find_best_split_value(const Data& data,
                                                      size_t& best_var,
                                                      double& best_decrease,
                                                      bool& best_send_missing_left,
-                                                     const Eigen::ArrayXXd& responses_by_sample,
+                                                     const RowMajorArrayXXd& responses_by_sample,
+                                                     const std::vector<double>& weights_by_sample,
                                                      const std::vector<std::vector<size_t>>& samples) {
+  // index: the positions of the node samples in increasing order of their values. For a
+  // sparse variable, only the samples with a nonzero value are listed.
   std::vector<double> possible_split_values;
-  std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+  std::vector<double> sorted_values;
+  std::vector<size_t> index = data.get_split_values(possible_split_values, sorted_values, samples[node],
+                                                    sample_positions, var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -112,33 +119,49 @@ void ProbabilitySplittingRule::find_best_split_value(const Data& data,
   }
 
   size_t num_splits = possible_split_values.size() - 1;
+  size_t num_buckets = num_splits + 1;
 
-  std::fill(counter_per_class, counter_per_class + num_splits * num_classes, 0);
-  std::fill(counter, counter + num_splits, 0);
+  std::fill(counter_per_class, counter_per_class + num_buckets * num_classes, 0);
+  std::fill(counter, counter + num_buckets, 0);
   size_t n_missing = 0;
   double* class_counts_missing = new double[num_classes]();
 
   size_t split_index = 0;
-  for (size_t i = 0; i < size_node - 1; i++) {
-    size_t sample = sorted_samples[i];
-    size_t next_sample = sorted_samples[i + 1];
-    double sample_value = data.get(sample, var);
-    uint sample_class = static_cast<uint>(responses_by_sample(sample, 0));
-    double sample_weight = data.get_weight(sample);
+  for (size_t i = 0; i < index.size(); i++) {
+    size_t j = index[i];
+    double sample_value = sorted_values[i];
+    uint sample_class = static_cast<uint>(responses_by_sample(j, 0));
+    double sample_weight = weights_by_sample[j];
 
     if (std::isnan(sample_value)) {
       class_counts_missing[sample_class] += sample_weight;
       ++n_missing;
     } else {
+      // Move on to the bucket of this value (all comparisons with a leading NaN bucket are false)
+      while (possible_split_values[split_index] != sample_value) {
+        ++split_index;
+      }
       ++counter[split_index];
       counter_per_class[split_index * num_classes + sample_class] += sample_weight;
     }
+  }
 
-    double next_sample_value = data.get(next_sample, var);
-    // if the next sample value is different, including the transition (..., NaN, Xij, ...)
-    // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
-      ++split_index;
+  // The samples that are zero in a sparse variable are not listed, so their bucket holds
+  // what remains of the node totals.
+  if (index.size() < size_node) {
+    size_t zero_index = std::find(possible_split_values.begin(), possible_split_values.end(), 0.0) -
+        possible_split_values.begin();
+    counter[zero_index] = size_node - index.size();
+    double* zero_class_counts = counter_per_class + zero_index * num_classes;
+    for (size_t cls = 0; cls < num_classes; ++cls) {
+      zero_class_counts[cls] = class_counts[cls] - class_counts_missing[cls];
+    }
+    for (size_t bucket = 0; bucket < num_buckets; ++bucket) {
+      if (bucket != zero_index) {
+        for (size_t cls = 0; cls < num_classes; ++cls) {
+          zero_class_counts[cls] -= counter_per_class[bucket * num_classes + cls];
+        }
+      }
     }
   }
 
@@ -37,7 +37,8 @@ public:
   bool find_best_split(const Data& data,
                        size_t node,
                        const std::vector<size_t>& possible_split_vars,
-                       const Eigen::ArrayXXd& responses_by_sample,
+                       const RowMajorArrayXXd& responses_by_sample,
+                       const std::vector<double>& weights_by_sample,
                        const std::vector<std::vector<size_t>>& samples,
                        std::vector<size_t>& split_vars,
                        std::vector<double>& split_values,
@@ -52,7 +53,8 @@ private:
                              size_t& best_var,
                              double& best_decrease,
                              bool& best_send_missing_left,
-                             const Eigen::ArrayXXd& responses_by_sample,
+                             const RowMajorArrayXXd& responses_by_sample,
+                             const std::vector<double>& weights_by_sample,
                              const std::vector<std::vector<size_t>>& samples);
 
   size_t num_classes;
@@ -60,6 +62,8 @@ private:
   double alpha;
   double imbalance_penalty;
 
+  std::vector<size_t> sample_positions;
+
   size_t* counter;
   double* counter_per_class;
 
@@ -16,6 +16,7 @@
  #-------------------------------------------------------------------------------*/
 
 #include <algorithm>
+#include <numeric>
 
 #include "RegressionSplittingRule.h"
 
@@ -46,7 +47,8 @@ RegressionSplittingRule::~RegressionSplittingRule() {
 bool RegressionSplittingRule::find_best_split(const Data& data,
                                               size_t node,
                                               const std::vector<size_t>& possible_split_vars,
-                                              const Eigen::ArrayXXd& responses_by_sample,
+                                              const RowMajorArrayXXd& responses_by_sample,
+                                              const std::vector<double>& weights_by_sample,
                                               const std::vector<std::vector<size_t>>& samples,
                                               std::vector<size_t>& split_vars,
                                               std::vector<double>& split_values,
@@ -58,10 +60,10 @@ bool RegressionSplittingRule::find_best_split(const Data& data,
   // Precompute the sum of outcomes in this node.
   double sum_node = 0.0;
   double weight_sum_node = 0.0;
-  for (auto& sample : samples[node]) {
-    double sample_weight = data.get_weight(sample);
+  for (size_t i = 0; i < size_node; i++) {
+    double sample_weight = weights_by_sample[i];
     weight_sum_node += sample_weight;
-    sum_node += sample_weight * responses_by_sample(sample, 0);
+    sum_node += sample_weight * responses_by_sample(i, 0);
   }
 
   // Initialize the variables to track the best split variable.
@@ -70,10 +72,12 @@ bool RegressionSplittingRule::find_best_split(const Data& data,
   double best_decrease = 0.0;
   bool best_send_missing_left = true;
 
+  data.index_samples(samples[node], sample_positions);
+
   // For all possible split variables
   for (auto& var : possible_split_vars) {
     find_best_split_value(data, node, var, weight_sum_node, sum_node, size_node, min_child_size,
-                          best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+                          best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, weights_by_sample, samples);
   }
 
   // Stop if no good split found
@@ -96,12 +100,15 @@ void RegressionSplittingRule::find_best_split_value(const Data& data,
                                                     size_t min_child_size,
                                                     double& best_value, size_t& best_var,
                                                     double& best_decrease, bool& best_send_missing_left,
-                                                    const Eigen::ArrayXXd& responses_by_sample,
+                                                    const RowMajorArrayXXd& responses_by_sample,
+                                                    const std::vector<double>& weights_by_sample,
                                                     const std::vector<std::vector<size_t>>& samples) {
-  // sorted_samples: the node samples in increasing order (may contain duplicated Xij). Length: size_node
+  // index: the positions of the node samples in increasing order of their values (may contain
+  // duplicated Xij). For a sparse variable, only the samples with a nonzero value are listed.
   std::vector<double> possible_split_values;
-  std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+  std::vector<double> sorted_values;
+  std::vector<size_t> index = data.get_split_values(possible_split_values, sorted_values, samples[node],
+                                                    sample_positions, var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -109,38 +116,46 @@ void RegressionSplittingRule::find_best_split_value(const Data& data,
   }
 
   size_t num_splits = possible_split_values.size() - 1; // -1: we do not split at the last value
-  std::fill(weight_sums, weight_sums + num_splits, 0);
-  std::fill(counter, counter + num_splits, 0);
-  std::fill(sums, sums + num_splits, 0);
+  std::fill(weight_sums, weight_sums + num_splits + 1, 0);
+  std::fill(counter, counter + num_splits + 1, 0);
+  std::fill(sums, sums + num_splits + 1, 0);
   size_t n_missing = 0;
   double weight_sum_missing = 0;
   double sum_missing = 0;
 
   // Fill counter and sums buckets
   size_t split_index = 0;
-  for (size_t i = 0; i < size_node - 1; i++) {
-    size_t sample = sorted_samples[i];
-    size_t next_sample = sorted_samples[i + 1];
-    double sample_value = data.get(sample, var);
-    double response = responses_by_sample(sample, 0);
-    double sample_weight = data.get_weight(sample);
+  for (size_t i = 0; i < index.size(); i++) {
+    size_t j = index[i];
+    double sample_value = sorted_values[i];
+    double response = responses_by_sample(j, 0);
+    double sample_weight = weights_by_sample[j];
 
     if (std::isnan(sample_value)) {
       weight_sum_missing += sample_weight;
       sum_missing += sample_weight * response;
       ++n_missing;
     } else {
+      // Move on to the bucket of this value (all comparisons with a leading NaN bucket are false)
+      while (possible_split_values[split_index] != sample_value) {
+        ++split_index;
+      }
       weight_sums[split_index] += sample_weight;
       sums[split_index] += sample_weight * response;
       ++counter[split_index];
     }
+  }
 
-    double next_sample_value = data.get(next_sample, var);
-    // if the next sample value is different, including the transition (..., NaN, Xij, ...)
-    // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
-      ++split_index;
-    }
+  // The samples that are zero in a sparse variable are not listed, so their bucket holds
+  // what remains of the node totals.
+  if (index.size() < size_node) {
+    size_t zero_index = std::find(possible_split_values.begin(), possible_split_values.end(), 0.0) -
+        possible_split_values.begin();
+    size_t num_buckets = num_splits + 1;
+    counter[zero_index] = size_node - index.size();
+    weight_sums[zero_index] = weight_sum_node - weight_sum_missing -
+        std::accumulate(weight_sums, weight_sums + num_buckets, 0.0);
+    sums[zero_index] = sum_node - sum_missing - std::accumulate(sums, sums + num_buckets, 0.0);
   }
 
   size_t n_left = n_missing;
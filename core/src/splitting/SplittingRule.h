@@ -22,6 +22,7 @@
 
 #include "Eigen/Dense"
 #include "commons/Data.h"
+#include "relabeling/RelabelingStrategy.h"
 
 namespace grf {
 
@@ -37,7 +38,9 @@ public:
    * @param data: the data matrix containing all test samples.
    * @param node: the node id in the tree.
    * @param possible_split_vars: a vector of valid covariate IDs.
-   * @param responses_by_sample: the response for each sample.
+   * @param responses_by_sample: the response for each sample at the node, where row i
+   *   holds the response of samples[node][i].
+   * @param weights_by_sample: the weight of each sample at the node, in the same order.
    * @param samples: a vector of samples at the given node.
    * @param split_vars: the output of the method, the best split variable, stored at node.
    * @param split_values: the output of the method, the best split value, stored at node.
@@ -47,7 +50,8 @@ public:
   virtual bool find_best_split(const Data& data,
                                size_t node,
                                const std::vector<size_t>& possible_split_vars,
-                               const Eigen::ArrayXXd& responses_by_sample,
+                               const RowMajorArrayXXd& responses_by_sample,
+                               const std::vector<double>& weights_by_sample,
                                const std::vector<std::vector<size_t>>& samples,
                                std::vector<size_t>& split_vars,
                                std::vector<double>& split_values,
@@ -16,6 +16,7 @@
  #-------------------------------------------------------------------------------*/
 
 #include <algorithm>
+#include <numeric>
 
 #include "SurvivalSplittingRule.h"
 
@@ -28,7 +29,8 @@ SurvivalSplittingRule::SurvivalSplittingRule(double alpha):
 bool SurvivalSplittingRule::find_best_split(const Data& data,
                                             size_t node,
                                             const std::vector<size_t>& possible_split_vars,
-                                            const Eigen::ArrayXXd& responses_by_sample,
+                                            const RowMajorArrayXXd& responses_by_sample,
+                                            const std::vector<double>& weights_by_sample,
                                             const std::vector<std::vector<size_t>>& samples_by_node,
                                             std::vector<size_t>& split_vars,
                                             std::vector<double>& split_values,
@@ -58,7 +60,7 @@ bool SurvivalSplittingRule::find_best_split(const Data& data,
 
 void SurvivalSplittingRule::find_best_split_internal(const Data& data,
                                                      const std::vector<size_t>& possible_split_vars,
-                                                     const Eigen::ArrayXXd& responses_by_sample,
+                                                     const RowMajorArrayXXd& responses_by_sample,
                                                      const std::vector<size_t>& samples,
                                                      double& best_value,
                                                      size_t& best_var,
@@ -69,9 +71,9 @@ void SurvivalSplittingRule::find_best_split_internal(const Data& data,
 
   // Get the failure values t1, ..., tm in this node
   std::vector<double> failure_values;
-  for (auto& sample : samples) {
-    if (data.is_failure(sample)) {
-      failure_values.push_back(responses_by_sample(sample, 0));
+  for (size_t i = 0; i < size_node; i++) {
+    if (data.is_failure(samples[i])) {
+      failure_values.push_back(responses_by_sample(i, 0));
     }
   }
 
@@ -97,19 +99,19 @@ void SurvivalSplittingRule::find_best_split_internal(const Data& data,
   std::vector<double> at_risk(num_failures + 1);
   at_risk[0] = static_cast<double>(size_node);
 
-  // allocating an N-sized (full data set size) array is faster than a hash table
-  std::vector<size_t> relabeled_failures(data.get_num_rows());
+  // The relabeled failure time of each sample, by position within this node
+  std::vector<size_t> relabeled_failures(size_node);
 
   std::vector<double> numerator_weights(num_failures + 1);
   std::vector<double> denominator_weights(num_failures + 1);
 
   // Relabel the failure values to range from 0 to the number of failures in this node
-  for (auto& sample : samples) {
-    double failure_value = responses_by_sample(sample, 0);
+  for (size_t i = 0; i < size_node; i++) {
+    double failure_value = responses_by_sample(i, 0);
     size_t new_failure_value = std::upper_bound(failure_values.begin(), failure_values.end(),
                                                 failure_value) - failure_values.begin();
-    relabeled_failures[sample] = new_failure_value;
-    if (data.is_failure(sample)) {
+    relabeled_failures[i] = new_failure_value;
+    if (data.is_failure(samples[i])) {
       ++count_failure[new_failure_value];
     } else {
       ++count_censor[new_failure_value];
@@ -131,10 +133,12 @@ void SurvivalSplittingRule::find_best_split_internal(const Data& data,
     denominator_weights[time] = (Yk - dk) / (Yk - 1) * dk / (Yk * Yk);
   }
 
+  data.index_samples(samples, sample_positions);
+
   for (auto& var : possible_split_vars) {
     find_best_split_value(data, var, size_node, min_child_size, num_failures_node, num_failures,
                           best_value, best_var, best_logrank, best_send_missing_left, samples, relabeled_failures,
-                          count_failure, at_risk, numerator_weights, denominator_weights);
+                          count_failure, count_censor, at_risk, numerator_weights, denominator_weights);
   }
 }
 
@@ -151,16 +155,19 @@ void SurvivalSplittingRule::find_best_split_value(const Data& data,
                                                   const std::vector<size_t>& samples,
                                                   const std::vector<size_t>& relabeled_failures,
                                                   const std::vector<double>& count_failure,
+                                                  const std::vector<double>& count_censor,
                                                   const std::vector<double>& at_risk,
                                                   const std::vector<double>& numerator_weights,
                                                   const std::vector<double>& denominator_weights) {
   // possible_split_values contains all the unique split values for this variable in increasing order
-  // sorted_samples contains the samples in this node in increasing order
+  // index contains the positions of the samples in this node in increasing order of their values
   // if there are missing values, these are placed first
   // (if all Xij's are continuous, these two vectors have the same length)
+  // For a sparse variable, only the samples with a nonzero value are listed in index.
   std::vector<double> possible_split_values;
-  std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples, var);
+  std::vector<double> sorted_values;
+  std::vector<size_t> index = data.get_split_values(possible_split_values, sorted_values, samples,
+                                                    sample_positions, var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -173,20 +180,38 @@ void SurvivalSplittingRule::find_best_split_value(const Data& data,
   size_t n_missing = 0;
   size_t num_failures_missing = 0;
 
-  // Loop through all samples to scan for missing values
-  for (size_t i = 0; i < size_node - 1; i++) {
-    size_t sample = sorted_samples[i];
-    double sample_value = data.get(sample, var);
-    size_t sample_time = relabeled_failures[sample];
+  // Scan for missing values, which are placed first
+  while (n_missing < index.size() && std::isnan(sorted_values[n_missing])) {
+    size_t j = index[n_missing];
+    if (data.is_failure(samples[j])) {
+      ++left_count_failure[relabeled_failures[j]];
+      ++num_failures_missing;
+    } else {
+      ++left_count_censor[relabeled_failures[j]];
+    }
+    ++n_missing;
+  }
 
-    if (std::isnan(sample_value)) {
-      if (data.is_failure(sample)) {
-        ++left_count_failure[sample_time];
-        ++num_failures_missing;
+  // The samples that are zero in a sparse variable are not listed, so their counts at each
+  // failure time are what remains of the node counts.
+  size_t num_zeros = size_node - index.size();
+  size_t zero_index = possible_split_values.size();
+  size_t num_failures_zero = 0;
+  std::vector<double> zero_count_failure;
+  std::vector<double> zero_count_censor;
+  if (num_zeros > 0) {
+    zero_index = std::find(possible_split_values.begin(), possible_split_values.end(), 0.0) -
+        possible_split_values.begin();
+    num_failures_zero = num_failures_node;
+    zero_count_failure = count_failure;
+    zero_count_censor = count_censor;
+    for (size_t j : index) {
+      if (data.is_failure(samples[j])) {
+        --zero_count_failure[relabeled_failures[j]];
+        --num_failures_zero;
       } else {
-        ++left_count_censor[sample_time];
+        --zero_count_censor[relabeled_failures[j]];
       }
-      ++n_missing;
     }
   }
 
@@ -194,7 +219,6 @@ void SurvivalSplittingRule::find_best_split_value(const Data& data,
   size_t n_left = n_missing;
   size_t num_failures_left = num_failures_missing;
   size_t split_index = 0;
-  size_t start_sample = n_missing > 0 ? n_missing - 1 : 0;
 
   for (bool send_left : {true, false}) {
     if (!send_left) {
@@ -209,38 +233,35 @@ void SurvivalSplittingRule::find_best_split_value(const Data& data,
      num_failures_left = 0;
      // Not necessary to evaluate splitting on NaN when sending right.
      split_index = 1;
-     start_sample = n_missing;
     }
 
-    for (size_t i = start_sample; i < size_node - 1; i++) {
-      size_t sample = sorted_samples[i];
-      size_t next_sample = sorted_samples[i + 1];
-      double sample_value = data.get(sample, var);
-      double next_sample_value = data.get(next_sample, var);
-      size_t sample_time = relabeled_failures[sample];
-
-      // If there are missing values, we evaluate splitting on NaN when send_left is true
-      // and i = n_missing - 1, which is why we need to check for missing below.
-      bool split_on_missing = std::isnan(sample_value);
-
-      if (!split_on_missing) {
-        ++n_left;
+    // Move the samples of each value to the left child in turn, and evaluate the split after them.
+    // If there are missing values, we evaluate splitting on NaN when send_left is true and
+    // split_index = 0, whose samples are already in the left child.
+    size_t next_sample = n_missing;
+    for (; split_index < num_splits; split_index++) {
+      if (split_index == zero_index) {
+        for (size_t time = 0; time < num_failures + 1; time++) {
+          left_count_failure[time] += zero_count_failure[time];
+          left_count_censor[time] += zero_count_censor[time];
+        }
+        n_left += num_zeros;
+        num_failures_left += num_failures_zero;
       }
-
-      if (!split_on_missing) {
-        if (data.is_failure(sample)) {
-          ++left_count_failure[sample_time];
+      while (next_sample < index.size() && sorted_values[next_sample] == possible_split_values[split_index]) {
+        size_t j = index[next_sample];
+        if (data.is_failure(samples[j])) {
+          ++left_count_failure[relabeled_failures[j]];
           ++num_failures_left;
         } else {
-          ++left_count_censor[sample_time];
+          ++left_count_censor[relabeled_failures[j]];
         }
+        ++n_left;
+        ++next_sample;
       }
 
       // Skip this split if one child is too small (i.e. too few failures)
       if (num_failures_left < min_child_size) {
-        if (sample_value != next_sample_value) {
-          ++split_index;
-        }
         continue;
       }
 
@@ -250,21 +271,13 @@ void SurvivalSplittingRule::find_best_split_value(const Data& data,
         break;
       }
 
-      // If the next sample value is different we can evaluate a split here
-      if (sample_value != next_sample_value) {
-        double logrank = compute_logrank(num_failures, n_left, cum_sums, left_count_failure, left_count_censor,
-                                         at_risk, numerator_weights, denominator_weights);
-        if (logrank > best_logrank) {
-          best_value = possible_split_values[split_index];
-          best_var = var;
-          best_logrank = logrank;
-          best_send_missing_left = send_left;
-        }
-        ++split_index;
-      }
-
-      if (split_index == num_splits) {
-        break;
+      double logrank = compute_logrank(num_failures, n_left, cum_sums, left_count_failure, left_count_censor,
+                                       at_risk, numerator_weights, denominator_weights);
+      if (logrank > best_logrank) {
+        best_value = possible_split_values[split_index];
+        best_var = var;
+        best_logrank = logrank;
+        best_send_missing_left = send_left;
       }
     }
   }
@@ -33,7 +33,8 @@ public:
   bool find_best_split(const Data& data,
                        size_t node,
                        const std::vector<size_t>& possible_split_vars,
-                       const Eigen::ArrayXXd& responses_by_sample,
+                       const RowMajorArrayXXd& responses_by_sample,
+                       const std::vector<double>& weights_by_sample,
                        const std::vector<std::vector<size_t>>& samples_by_node,
                        std::vector<size_t>& split_vars,
                        std::vector<double>& split_values,
@@ -45,7 +46,7 @@ public:
   */
  void find_best_split_internal(const Data& data,
                                const std::vector<size_t>& possible_split_vars,
-                               const Eigen::ArrayXXd& responses_by_sample,
+                               const RowMajorArrayXXd& responses_by_sample,
                                const std::vector<size_t>& samples,
                                double& best_value,
                                size_t& best_var,
@@ -66,6 +67,7 @@ private:
                              const std::vector<size_t>& samples,
                              const std::vector<size_t>& relabeled_failures,
                              const std::vector<double>& count_failure,
+                             const std::vector<double>& count_censor,
                              const std::vector<double>& at_risk,
                              const std::vector<double>& numerator_weights,
                              const std::vector<double>& denominator_weights);
@@ -79,6 +81,8 @@ private:
                                 const std::vector<double>& numerator_weights,
                                 const std::vector<double>& denominator_weights);
 
+  std::vector<size_t> sample_positions;
+
   double alpha;
 
   DISALLOW_COPY_AND_ASSIGN(SurvivalSplittingRule);
@@ -16,6 +16,7 @@
  #-------------------------------------------------------------------------------*/
 
 #include <iterator>
+#include <utility>
 #include "sampling/RandomSampler.h"
 
 #include "tree/Tree.h"
@@ -24,21 +25,21 @@
 namespace grf {
 
 Tree::Tree(size_t root_node,
-           const std::vector<std::vector<size_t>>& child_nodes,
-           const std::vector<std::vector<size_t>>& leaf_samples,
-           const std::vector<size_t>& split_vars,
-           const std::vector<double>& split_values,
+           std::vector<std::vector<size_t>> child_nodes,
+           std::vector<std::vector<size_t>> leaf_samples,
+           std::vector<size_t> split_vars,
+           std::vector<double> split_values,
            const std::vector<size_t>& drawn_samples,
-           const std::vector<bool>& send_missing_left,
-           const PredictionValues& prediction_values) :
+           std::vector<bool> send_missing_left,
+           PredictionValues prediction_values) :
     root_node(root_node),
-    child_nodes(child_nodes),
-    leaf_samples(leaf_samples),
-    split_vars(split_vars),
-    split_values(split_values),
+    child_nodes(std::move(child_nodes)),
+    leaf_samples(std::move(leaf_samples)),
+    split_vars(std::move(split_vars)),
+    split_values(std::move(split_values)),
     drawn_samples(drawn_samples),
-    send_missing_left(send_missing_left),
-    prediction_values(prediction_values) {}
+    send_missing_left(std::move(send_missing_left)),
+    prediction_values(std::move(prediction_values)) {}
 
 size_t Tree::get_root_node() const {
   return root_node;
@@ -60,7 +61,15 @@ const std::vector<double>& Tree::get_split_values() const  {
   return split_values;
 }
 
-const std::vector<size_t>& Tree::get_drawn_samples() const  {
+std::vector<size_t> Tree::get_drawn_samples() const  {
+  return drawn_samples.get_indices();
+}
+
+bool Tree::is_drawn(size_t sample) const {
+  return drawn_samples.contains(sample);
+}
+
+const Bitmap& Tree::get_drawn_sample_bitmap() const {
   return drawn_samples;
 }
 
@@ -84,6 +93,15 @@ std::vector<size_t> Tree::find_leaf_nodes(const Data& data,
   return prediction_leaf_nodes;
 }
 
+void Tree::find_leaf_nodes(const Data& data,
+                           const std::vector<size_t>& samples,
+                           std::vector<size_t>& leaf_nodes) const {
+  leaf_nodes.resize(samples.size());
+  for (size_t i = 0; i < samples.size(); i++) {
+    leaf_nodes[i] = find_leaf_node(data, samples[i]);
+  }
+}
+
 std::vector<size_t> Tree::find_leaf_nodes(const Data& data,
                                           const std::vector<bool>& valid_samples) const  {
   size_t num_samples = data.get_num_rows();
@@ -102,12 +120,41 @@ std::vector<size_t> Tree::find_leaf_nodes(const Data& data,
   return prediction_leaf_nodes;
 }
 
-void Tree::set_leaf_samples(const std::vector<std::vector<size_t>>& leaf_samples) {
-  this->leaf_samples = leaf_samples;
+std::vector<size_t> Tree::find_oob_leaf_nodes(const Data& data) const {
+  size_t num_samples = data.get_num_rows();
+
+  std::vector<size_t> prediction_leaf_nodes;
+  prediction_leaf_nodes.resize(num_samples);
+
+  for (size_t sample = 0; sample < num_samples; sample++) {
+    if (drawn_samples.contains(sample)) {
+      continue;
+    }
+
+    size_t node = find_leaf_node(data, sample);
+    prediction_leaf_nodes[sample] = node;
+  }
+  return prediction_leaf_nodes;
+}
+
+void Tree::set_leaf_samples(std::vector<std::vector<size_t>> leaf_samples) {
+  this->leaf_samples = std::move(leaf_samples);
+}
+
+bool Tree::has_leaf_samples() const {
+  return !leaf_samples.empty();
+}
+
+void Tree::drop_leaf_samples() {
+  std::vector<std::vector<size_t>>().swap(leaf_samples);
+}
+
+void Tree::set_prediction_values(PredictionValues prediction_values) {
+  this->prediction_values = std::move(prediction_values);
 }
 
-void Tree::set_prediction_values(const PredictionValues& prediction_values) {
-  this->prediction_values = prediction_values;
+void Tree::set_drawn_samples(Bitmap drawn_samples) {
+  this->drawn_samples = std::move(drawn_samples);
 }
 
 
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "commons/globals.h"
+#include "commons/Bitmap.h"
 #include "commons/Data.h"
 #include "sampling/RandomSampler.h"
 #include "prediction/PredictionValues.h"
@@ -30,14 +31,18 @@ namespace grf {
 
 class Tree {
 public:
+  /**
+   * The tree takes its arguments by value, so that a caller which no longer needs them
+   * (such as TreeTrainer) can hand over their storage with std::move instead of copying it.
+   */
   Tree(size_t root_node,
-       const std::vector<std::vector<size_t>>& child_nodes,
-       const std::vector<std::vector<size_t>>& leaf_samples,
-       const std::vector<size_t>& split_vars,
-       const std::vector<double>& split_values,
+       std::vector<std::vector<size_t>> child_nodes,
+       std::vector<std::vector<size_t>> leaf_samples,
+       std::vector<size_t> split_vars,
+       std::vector<double> split_values,
        const std::vector<size_t>& drawn_samples,
-       const std::vector<bool>& send_missing_left,
-       const PredictionValues& prediction_values);
+       std::vector<bool> send_missing_left,
+       PredictionValues prediction_values);
 
   /**
    * Given test data and a list of sample IDs, recurses down the tree to find
@@ -52,6 +57,20 @@ public:
   std::vector<size_t> find_leaf_nodes(const Data& data,
                                       const std::vector<size_t>& samples) const;
 
+  /**
+   * Given test data and a list of sample IDs, finds the leaf node IDs of those samples
+   * and writes them into a compact buffer supplied by the caller.
+   *
+   * @param data: the data matrix containing all test samples.
+   * @param samples: a list of sample IDs whose leaf nodes should be calculated.
+   * @param leaf_nodes: the output buffer. It is resized to the number of requested samples,
+   * and entry i will contain the node ID of samples[i]. Callers finding leaves for many trees
+   * can pass the same buffer each time, so that its memory is reused.
+   */
+  void find_leaf_nodes(const Data& data,
+                       const std::vector<size_t>& samples,
+                       std::vector<size_t>& leaf_nodes) const;
+
   /**
    * Given test data and a vector indicating which samples to consider, recurses
    * down the tree to find the leaf node IDs that those samples belong in.
@@ -66,6 +85,25 @@ public:
    */
   std::vector<size_t> find_leaf_nodes(const Data& data,
                                       const std::vector<bool>& valid_samples) const;
+
+  /**
+   * Finds the leaf node IDs of all samples that were not drawn in creating this tree,
+   * testing membership against the tree's drawn samples directly.
+   *
+   * @param data: the training data the tree was grown on.
+   * @return The resulting node IDs for each sample ID. As above, this vector's length will be
+   * equal to the total number of samples, and the entries for drawn samples will be 0.
+   */
+  std::vector<size_t> find_oob_leaf_nodes(const Data& data) const;
+
+  /**
+   * Recurses down the tree to find the leaf node ID of a single test sample. This lets
+   * callers predicting for only a few samples visit each tree once per sample, without
+   * allocating any per-tree buffers.
+   */
+  size_t find_leaf_node(const Data& data,
+                        size_t sample) const;
+
   /**
    * Removes all empty leaf nodes.
    *
@@ -105,11 +143,22 @@ public:
   const std::vector<double>& get_split_values() const;
 
   /**
-   * The sample IDs that were not drawn in creating this tree. For honest trees,
-   * this excludes both samples that went into growing the tree, as well as samples
-   * used to repopulate the leaves.
+   * The sample IDs that were drawn in creating this tree, in increasing order. For
+   * honest trees, this includes both samples that went into growing the tree, as well
+   * as samples used to repopulate the leaves.
+   *
+   * The samples are stored as a bitmap, so this list is created on every call. Use
+   * Tree::is_drawn to check membership of individual samples.
    */
-  const std::vector<size_t>& get_drawn_samples() const;
+  std::vector<size_t> get_drawn_samples() const;
+
+  /**
+   * Returns true if the given sample was drawn in creating this tree, so that it
+   * cannot be used for out-of-bag prediction.
+   */
+  bool is_drawn(size_t sample) const;
+
+  const Bitmap& get_drawn_sample_bitmap() const;
 
   /**
    * The NaN direction for each node. Left: true, Right: false.
@@ -134,17 +183,34 @@ public:
    * Sets the contents of this tree's leaf nodes. Please see
    * Tree::get_leaf_samples for a description of this variable.
    */
-  void set_leaf_samples(const std::vector<std::vector<size_t>>& leaf_samples);
+  void set_leaf_samples(std::vector<std::vector<size_t>> leaf_samples);
+
+  /**
+   * Whether this tree still holds the samples in each of its leaves. Trees without
+   * leaf samples can only be used for predictions through their prediction values.
+   */
+  bool has_leaf_samples() const;
+
+  /**
+   * Frees the samples of each leaf, keeping only what is needed to predict from
+   * the precomputed prediction values: the tree structure, the drawn samples used
+   * for OOB prediction, and the prediction values themselves.
+   */
+  void drop_leaf_samples();
 
   /**
    * Sets the contents of this tree's prediction values. Please see
    * Tree::get_prediction_values for a description of this variable.
    */
-  void set_prediction_values(const PredictionValues& prediction_values);
+  void set_prediction_values(PredictionValues prediction_values);
+
+  /**
+   * Sets the samples that were drawn in creating this tree. Please see
+   * Tree::get_drawn_samples for a description of this variable.
+   */
+  void set_drawn_samples(Bitmap drawn_samples);
 
 private:
-  size_t find_leaf_node(const Data& data,
-                        size_t sample) const;
   void prune_node(size_t& node);
   bool is_empty_leaf(size_t node) const;
 
@@ -153,7 +219,7 @@ private:
   std::vector<std::vector<size_t>> leaf_samples;
   std::vector<size_t> split_vars;
   std::vector<double> split_values;
-  std::vector<size_t> drawn_samples;
+  Bitmap drawn_samples;
   std::vector<bool> send_missing_left;
 
   PredictionValues prediction_values;
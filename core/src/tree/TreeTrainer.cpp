@@ -63,7 +63,10 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
 
   size_t num_open_nodes = 1;
   size_t i = 0;
-  Eigen::ArrayXXd responses_by_sample(data.get_num_rows(), relabeling_strategy->get_response_length());
+  // The responses and weights are only needed for the samples of the node being split, so
+  // they are stored by position within that node, and sized for the root which holds them all.
+  RowMajorArrayXXd responses_by_sample(nodes[0].size(), relabeling_strategy->get_response_length());
+  std::vector<double> weights_by_sample(nodes[0].size());
   while (num_open_nodes > 0) {
     bool is_leaf_node = split_node(i,
                                    data,
@@ -75,6 +78,7 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
                                    split_values,
                                    send_missing_left,
                                    responses_by_sample,
+                                   weights_by_sample,
                                    options);
     if (is_leaf_node) {
       --num_open_nodes;
@@ -88,36 +92,50 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
   std::vector<size_t> drawn_samples;
   sampler.get_samples_in_clusters(clusters, drawn_samples);
 
-  std::unique_ptr<Tree> tree(new Tree(0, child_nodes, nodes,
-      split_vars, split_values, drawn_samples, send_missing_left, PredictionValues()));
+  std::unique_ptr<Tree> tree(new Tree(0, std::move(child_nodes), std::move(nodes),
+      std::move(split_vars), std::move(split_values), drawn_samples, std::move(send_missing_left),
+      PredictionValues()));
 
   if (!new_leaf_samples.empty()) {
     repopulate_leaf_nodes(tree, data, new_leaf_samples, options.get_honesty_prune_leaves());
   }
 
-  PredictionValues prediction_values;
   if (prediction_strategy != nullptr) {
-    prediction_values = prediction_strategy->precompute_prediction_values(tree->get_leaf_samples(), data);
+    tree->set_prediction_values(prediction_strategy->precompute_prediction_values(tree->get_leaf_samples(), data));
   }
-  tree->set_prediction_values(prediction_values);
 
   return tree;
 }
 
+const OptimizedPredictionStrategy* TreeTrainer::get_prediction_strategy() const {
+  return prediction_strategy.get();
+}
+
 void TreeTrainer::repopulate_leaf_nodes(const std::unique_ptr<Tree>& tree,
                                         const Data& data,
                                         const std::vector<size_t>& leaf_samples,
                                         const bool honesty_prune_leaves) const {
   size_t num_nodes = tree->get_leaf_samples().size();
-  std::vector<std::vector<size_t>> new_leaf_nodes(num_nodes);
 
-  std::vector<size_t> leaf_nodes = tree->find_leaf_nodes(data, leaf_samples);
+  // Only the repopulating samples are traversed, so the leaf lookup is proportional
+  // to their number rather than to the number of rows in the data.
+  std::vector<size_t> leaf_nodes;
+  tree->find_leaf_nodes(data, leaf_samples, leaf_nodes);
 
-  for (auto& sample : leaf_samples) {
-    size_t leaf_node = leaf_nodes[sample];
-    new_leaf_nodes[leaf_node].push_back(sample);
+  // Count the samples in each leaf first, so every list is allocated once at its final size.
+  std::vector<size_t> leaf_sizes(num_nodes, 0);
+  for (size_t leaf_node : leaf_nodes) {
+    leaf_sizes[leaf_node]++;
   }
-  tree->set_leaf_samples(new_leaf_nodes);
+
+  std::vector<std::vector<size_t>> new_leaf_nodes(num_nodes);
+  for (size_t node = 0; node < num_nodes; node++) {
+    new_leaf_nodes[node].reserve(leaf_sizes[node]);
+  }
+  for (size_t i = 0; i < leaf_samples.size(); i++) {
+    new_leaf_nodes[leaf_nodes[i]].push_back(leaf_samples[i]);
+  }
+  tree->set_leaf_samples(std::move(new_leaf_nodes));
   if (honesty_prune_leaves) {
     tree->honesty_prune_leaves();
   }
@@ -148,7 +166,8 @@ bool TreeTrainer::split_node(size_t node,
                              std::vector<size_t>& split_vars,
                              std::vector<double>& split_values,
                              std::vector<bool>& send_missing_left,
-                             Eigen::ArrayXXd& responses_by_sample,
+                             RowMajorArrayXXd& responses_by_sample,
+                             std::vector<double>& weights_by_sample,
                              const TreeOptions& options) const {
 
   std::vector<size_t> possible_split_vars;
@@ -163,6 +182,7 @@ bool TreeTrainer::split_node(size_t node,
                                   split_values,
                                   send_missing_left,
                                   responses_by_sample,
+                                  weights_by_sample,
                                   options.get_min_node_size());
   if (stop) {
     return true;
@@ -207,7 +227,8 @@ bool TreeTrainer::split_node_internal(size_t node,
                                       std::vector<size_t>& split_vars,
                                       std::vector<double>& split_values,
                                       std::vector<bool>& send_missing_left,
-                                      Eigen::ArrayXXd& responses_by_sample,
+                                      RowMajorArrayXXd& responses_by_sample,
+                                      std::vector<double>& weights_by_sample,
                                       uint min_node_size) const {
   // Check node size, stop if maximum reached
   if (samples[node].size() <= min_node_size) {
@@ -216,11 +237,17 @@ bool TreeTrainer::split_node_internal(size_t node,
   }
 
   bool stop = relabeling_strategy->relabel(samples[node], data, responses_by_sample);
+  if (!stop) {
+    for (size_t i = 0; i < samples[node].size(); i++) {
+      weights_by_sample[i] = data.get_weight(samples[node][i]);
+    }
+  }
 
   if (stop || splitting_rule->find_best_split(data,
                                               node,
                                               possible_split_vars,
                                               responses_by_sample,
+                                              weights_by_sample,
                                               samples,
                                               split_vars,
                                               split_values,
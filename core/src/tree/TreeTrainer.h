@@ -42,6 +42,12 @@ public:
                               const std::vector<size_t>& clusters,
                               const TreeOptions& options) const;
 
+  /**
+   * The strategy used to precompute the prediction values of each leaf, or
+   * nullptr if trees are trained without precomputed prediction values.
+   */
+  const OptimizedPredictionStrategy* get_prediction_strategy() const;
+
 private:
   void create_empty_node(std::vector<std::vector<size_t>>& child_nodes,
                          std::vector<std::vector<size_t>>& samples,
@@ -68,7 +74,8 @@ private:
                   std::vector<size_t>& split_vars,
                   std::vector<double>& split_values,
                   std::vector<bool>& send_missing_left,
-                  Eigen::ArrayXXd& responses_by_sample,
+                  RowMajorArrayXXd& responses_by_sample,
+                  std::vector<double>& weights_by_sample,
                   const TreeOptions& tree_options) const;
 
   bool split_node_internal(size_t node,
@@ -79,7 +86,8 @@ private:
                            std::vector<size_t>& split_vars,
                            std::vector<double>& split_values,
                            std::vector<bool>& send_missing_left,
-                           Eigen::ArrayXXd& responses_by_sample,
+                           RowMajorArrayXXd& responses_by_sample,
+                           std::vector<double>& weights_by_sample,
                            uint min_node_size) const ;
 
   std::set<size_t> disallowed_split_variables;
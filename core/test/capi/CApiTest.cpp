@@ -0,0 +1,134 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cstdio>
+#include <string>
+
+#include "grf_c.h"
+#include "commons/utility.h"
+#include "forest/ForestPredictor.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestSerializer.h"
+#include "forest/ForestTrainer.h"
+#include "forest/ForestTrainers.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("forests loaded through the C interface predict like the C++ interface", "[capi, forest]") {
+  auto data_vec = load_data("test/forest/resources/causal_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  data.set_treatment_index(11);
+  data.set_instrument_index(11);
+  size_t num_rows = data.get_num_rows();
+
+  ForestTrainer trainer = instrumental_trainer(0, true);
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options(true, 2));
+  std::vector<Prediction> expected = instrumental_predictor(4).predict(forest, data, data, true);
+
+  std::string file_name = "capi_test.grf";
+  ForestSerializer().save(forest, file_name);
+
+  grf_forest* c_forest = nullptr;
+  REQUIRE(grf_forest_load(file_name.c_str(), &c_forest) == GRF_OK);
+  std::remove(file_name.c_str());
+  REQUIRE(grf_forest_num_trees(c_forest) == forest.get_trees().size());
+  REQUIRE(grf_forest_num_variables(c_forest) == 10);
+  REQUIRE(grf_forest_ci_group_size(c_forest) == 2);
+
+  grf_predictor* c_predictor = nullptr;
+  REQUIRE(grf_predictor_create(GRF_INSTRUMENTAL, 4, 1, 1, &c_predictor) == GRF_OK);
+  REQUIRE(grf_predictor_prediction_length(c_predictor) == 1);
+
+  // Predict the whole data set in one batch, and the first rows in a micro-batch.
+  std::vector<double> predictions(num_rows);
+  std::vector<double> variance_estimates(num_rows);
+  REQUIRE(grf_predict(c_predictor, c_forest, data_vec.first.data(), num_rows, data.get_num_cols(),
+                      predictions.data(), variance_estimates.data()) == GRF_OK);
+  for (size_t i = 0; i < num_rows; i++) {
+    REQUIRE(equal_doubles(predictions[i], expected[i].get_predictions()[0], 1e-10));
+    REQUIRE(equal_doubles(variance_estimates[i], expected[i].get_variance_estimates()[0], 1e-10));
+  }
+
+  size_t batch_size = 3;
+  std::vector<double> batch(batch_size * 10);
+  for (size_t row = 0; row < batch_size; row++) {
+    for (size_t col = 0; col < 10; col++) {
+      batch[row + col * batch_size] = data.get(row, col);
+    }
+  }
+  std::vector<double> batch_predictions(batch_size);
+  REQUIRE(grf_predict(c_predictor, c_forest, batch.data(), batch_size, 10,
+                      batch_predictions.data(), nullptr) == GRF_OK);
+  for (size_t i = 0; i < batch_size; i++) {
+    REQUIRE(equal_doubles(batch_predictions[i], expected[i].get_predictions()[0], 1e-10));
+  }
+
+  // Too few covariates are reported as an error.
+  REQUIRE(grf_predict(c_predictor, c_forest, batch.data(), batch_size, 9,
+                      batch_predictions.data(), nullptr) == GRF_ERROR);
+  REQUIRE(std::string(grf_last_error()).find("columns") != std::string::npos);
+
+  grf_predictor_free(c_predictor);
+  grf_forest_free(c_forest);
+}
+
+TEST_CASE("predictors that do not match the forest are rejected", "[capi, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  size_t num_rows = data.get_num_rows();
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+
+  std::string file_name = "capi_mismatch_test.grf";
+  ForestSerializer().save(forest, file_name);
+  grf_forest* c_forest = nullptr;
+  REQUIRE(grf_forest_load(file_name.c_str(), &c_forest) == GRF_OK);
+  std::remove(file_name.c_str());
+
+  // A multi-causal predictor reads more values from each leaf than a regression forest holds.
+  grf_predictor* c_predictor = nullptr;
+  REQUIRE(grf_predictor_create(GRF_MULTI_CAUSAL, 1, 1, 3, &c_predictor) == GRF_OK);
+  std::vector<double> predictions(num_rows * grf_predictor_prediction_length(c_predictor));
+  REQUIRE(grf_predict(c_predictor, c_forest, data_vec.first.data(), num_rows, data.get_num_cols(),
+                      predictions.data(), nullptr) == GRF_ERROR);
+  REQUIRE(std::string(grf_last_error()).find("prediction values") != std::string::npos);
+  grf_predictor_free(c_predictor);
+
+  REQUIRE(grf_predictor_create(GRF_REGRESSION, 1, 1, 1, &c_predictor) == GRF_OK);
+  REQUIRE(grf_predict(c_predictor, c_forest, data_vec.first.data(), num_rows, data.get_num_cols(),
+                      predictions.data(), nullptr) == GRF_OK);
+  grf_predictor_free(c_predictor);
+  grf_forest_free(c_forest);
+}
+
+TEST_CASE("C interface failures are reported through the last error", "[capi]") {
+  grf_forest* c_forest = nullptr;
+  REQUIRE(grf_forest_load("test/forest/resources/does_not_exist.grf", &c_forest) == GRF_ERROR);
+  REQUIRE(c_forest == nullptr);
+  REQUIRE(std::string(grf_last_error()).size() > 0);
+
+  grf_predictor* c_predictor = nullptr;
+  REQUIRE(grf_predictor_create(static_cast<grf_forest_type>(42), 1, 1, 1, &c_predictor) == GRF_ERROR);
+  REQUIRE(c_predictor == nullptr);
+  REQUIRE(grf_api_version() == GRF_C_API_VERSION);
+}
@@ -0,0 +1,94 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "CommandLine.h"
+#include "Commands.h"
+
+using namespace grf;
+
+TEST_CASE("options are read with and without an equals sign", "[cli]") {
+  CommandLine command_line({"--data", "train.csv", "--num-trees=50", "--alpha", "0.1", "forest.grf"},
+                           COMMAND_FLAGS);
+
+  REQUIRE(command_line.has("data"));
+  REQUIRE_FALSE(command_line.has("forest"));
+  REQUIRE(command_line.get_string("data") == "train.csv");
+  REQUIRE(command_line.get_size("num-trees") == 50);
+  REQUIRE(command_line.get_double("alpha", 0.05) == 0.1);
+  REQUIRE(command_line.get_size("seed", 42) == 42);
+  REQUIRE(command_line.get_string("format", "csv") == "csv");
+  REQUIRE(command_line.get_positional() == std::vector<std::string>({"forest.grf"}));
+}
+
+TEST_CASE("boolean flags are read with and without a value", "[cli]") {
+  CommandLine command_line({"--variance", "--honesty", "false", "--oob=0", "--stabilize-splits", "1",
+                            "--errors", "forest.grf", "--store-leaf-samples=true"},
+                           COMMAND_FLAGS);
+
+  REQUIRE(command_line.get_bool("variance", false));
+  REQUIRE_FALSE(command_line.get_bool("honesty", true));
+  REQUIRE_FALSE(command_line.get_bool("oob", true));
+  REQUIRE(command_line.get_bool("stabilize-splits", false));
+  REQUIRE(command_line.get_bool("store-leaf-samples", false));
+  REQUIRE(command_line.get_bool("equalize-cluster-weights", true));
+
+  // A flag only takes the next argument as its value if it is a boolean.
+  REQUIRE(command_line.get_bool("errors", false));
+  REQUIRE(command_line.get_positional() == std::vector<std::string>({"forest.grf"}));
+  command_line.check_all_used();
+}
+
+TEST_CASE("invalid option values are rejected", "[cli]") {
+  CommandLine command_line({"--num-trees", "-5", "--mtry", "3.5", "--alpha", "abc", "--honesty=yes"},
+                           COMMAND_FLAGS);
+
+  REQUIRE_THROWS_AS(command_line.get_size("num-trees"), const std::runtime_error&);
+  REQUIRE_THROWS_AS(command_line.get_size("mtry", 1), const std::runtime_error&);
+  REQUIRE_THROWS_AS(command_line.get_double("alpha", 0.05), const std::runtime_error&);
+  REQUIRE_THROWS_AS(command_line.get_bool("honesty", true), const std::runtime_error&);
+  REQUIRE_THROWS_AS(command_line.get_string("data"), const std::runtime_error&);
+}
+
+TEST_CASE("malformed command lines are rejected", "[cli]") {
+  REQUIRE_THROWS_AS(CommandLine({"--data"}, COMMAND_FLAGS), const std::runtime_error&);
+  REQUIRE_THROWS_AS(CommandLine({"--seed", "1", "--seed=2"}, COMMAND_FLAGS), const std::runtime_error&);
+  REQUIRE_THROWS_AS(CommandLine({"--variance", "--variance=false"}, COMMAND_FLAGS), const std::runtime_error&);
+}
+
+TEST_CASE("options that are not read are reported", "[cli]") {
+  CommandLine command_line({"--data", "train.csv", "--num-tres", "50"}, COMMAND_FLAGS);
+  command_line.get_string("data");
+  REQUIRE_THROWS_AS(command_line.check_all_used(), const std::runtime_error&);
+
+  command_line.get_size("num-tres");
+  command_line.check_all_used();
+}
+
+TEST_CASE("comma separated lists are read", "[cli]") {
+  CommandLine command_line({"--quantiles", "0.1,0.5,0.9", "--outcome=3", "--treatment", "1,,2"},
+                           COMMAND_FLAGS);
+
+  REQUIRE(command_line.get_doubles("quantiles") == std::vector<double>({0.1, 0.5, 0.9}));
+  REQUIRE(command_line.get_sizes("outcome") == std::vector<size_t>({3}));
+  REQUIRE_THROWS_AS(command_line.get_sizes("treatment"), const std::runtime_error&);
+}
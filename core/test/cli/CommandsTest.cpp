@@ -0,0 +1,117 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "CommandLine.h"
+#include "Commands.h"
+#include "commons/MatrixFile.h"
+
+using namespace grf;
+
+namespace {
+
+const std::string DATA_FILE = "test/forest/resources/gaussian_data.csv";
+
+CommandLine parse(const std::vector<std::string>& arguments) {
+  return CommandLine(arguments, COMMAND_FLAGS);
+}
+
+void train(const std::string& forest_file, const std::string& outcome, const std::string& seed) {
+  train_command(parse({"--data", DATA_FILE, "--forest", forest_file, "--outcome", outcome,
+                       "--num-trees", "50", "--honesty", "false", "--seed", seed, "--num-threads", "1"}));
+}
+
+std::vector<double> predict(const std::string& forest_file, bool oob_prediction, const std::string& option) {
+  std::string output_file = "cli_test_predictions.csv";
+  std::vector<std::string> arguments = {"--forest", forest_file, "--data", DATA_FILE,
+                                        "--output", output_file, "--num-threads", "1"};
+  if (!option.empty()) {
+    arguments.push_back(option);
+  }
+  predict_command(parse(arguments), oob_prediction);
+  auto matrix = load_matrix(output_file);
+  std::remove(output_file.c_str());
+
+  REQUIRE(matrix.second[0] == 500);
+  return matrix.first;
+}
+
+} // namespace
+
+TEST_CASE("forests round trip through train, predict and merge", "[cli]") {
+  train("cli_test_forest_1.grf", "10", "1");
+  train("cli_test_forest_2.grf", "10", "2");
+  merge_command(parse({"--output", "cli_test_merged.grf", "cli_test_forest_1.grf", "cli_test_forest_2.grf"}));
+
+  std::vector<double> predictions_1 = predict("cli_test_forest_1.grf", false, "");
+  std::vector<double> predictions_2 = predict("cli_test_forest_2.grf", false, "");
+  std::vector<double> merged_predictions = predict("cli_test_merged.grf", false, "");
+  REQUIRE(merged_predictions.size() == 500);
+
+  // Every tree contributes to the prediction for new data, so the merged forest
+  // averages the predictions of the two equally large forests.
+  for (size_t row = 0; row < 500; row++) {
+    REQUIRE(merged_predictions[row] == Approx((predictions_1[row] + predictions_2[row]) / 2).margin(1e-10));
+  }
+
+  // The variance estimates and error estimates follow the predictions as extra columns.
+  std::vector<double> oob_predictions = predict("cli_test_merged.grf", true, "--errors");
+  REQUIRE(oob_predictions.size() == 3 * 500);
+  for (double value : oob_predictions) {
+    REQUIRE(std::isfinite(value));
+  }
+  std::vector<double> variance_predictions = predict("cli_test_merged.grf", false, "--variance");
+  REQUIRE(variance_predictions.size() == 2 * 500);
+  for (size_t row = 0; row < 500; row++) {
+    REQUIRE(variance_predictions[row] == merged_predictions[row]);
+    REQUIRE(variance_predictions[500 + row] >= 0);
+  }
+
+  std::remove("cli_test_forest_1.grf");
+  std::remove("cli_test_forest_2.grf");
+  std::remove("cli_test_merged.grf");
+}
+
+TEST_CASE("forests trained on different columns are not merged", "[cli]") {
+  train("cli_test_forest_1.grf", "10", "1");
+  train("cli_test_forest_2.grf", "9", "1");
+
+  REQUIRE_THROWS_AS(merge_command(parse({"--output", "cli_test_merged.grf",
+                                         "cli_test_forest_1.grf", "cli_test_forest_2.grf"})),
+                    const std::runtime_error&);
+  REQUIRE_THROWS_AS(merge_command(parse({"--output", "cli_test_merged.grf"})), const std::runtime_error&);
+
+  std::remove("cli_test_forest_1.grf");
+  std::remove("cli_test_forest_2.grf");
+}
+
+TEST_CASE("invalid training columns and options are rejected", "[cli]") {
+  REQUIRE_THROWS_AS(train("cli_test_forest.grf", "11", "1"), const std::runtime_error&);
+  REQUIRE_THROWS_AS(train_command(parse({"--data", DATA_FILE, "--forest", "cli_test_forest.grf",
+                                         "--outcome", "10", "--num-tres", "50"})),
+                    const std::runtime_error&);
+  REQUIRE_THROWS_AS(train_command(parse({"--data", DATA_FILE, "--forest", "cli_test_forest.grf",
+                                         "--outcome", "10", "--type", "causal"})),
+                    const std::runtime_error&);
+  std::remove("cli_test_forest.grf");
+}
@@ -0,0 +1,49 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "catch.hpp"
+#include "commons/Bitmap.h"
+
+using namespace grf;
+
+TEST_CASE("bitmaps contain exactly the given indices", "[bitmap]") {
+  std::vector<size_t> indices = {130, 0, 5, 63, 64, 200};
+  Bitmap bitmap(indices);
+
+  REQUIRE(bitmap.count() == 6);
+  REQUIRE(bitmap.get_indices() == std::vector<size_t>({0, 5, 63, 64, 130, 200}));
+  REQUIRE(bitmap.contains(63));
+  REQUIRE(bitmap.contains(64));
+  REQUIRE(!bitmap.contains(1));
+  REQUIRE(!bitmap.contains(199));
+  REQUIRE(!bitmap.contains(100000));
+  REQUIRE(bitmap.get_words().size() == 4);
+}
+
+TEST_CASE("bitmaps round trip through their words", "[bitmap]") {
+  Bitmap bitmap(std::vector<size_t>({3, 70, 71}));
+  REQUIRE(Bitmap::from_words(bitmap.get_words()) == bitmap);
+
+  std::vector<uint64_t> words = bitmap.get_words();
+  words.push_back(0);
+  REQUIRE(Bitmap::from_words(words) == bitmap);
+
+  Bitmap empty_bitmap;
+  REQUIRE(empty_bitmap.count() == 0);
+  REQUIRE(!empty_bitmap.contains(0));
+  REQUIRE(Bitmap(std::vector<size_t>()) == empty_bitmap);
+}
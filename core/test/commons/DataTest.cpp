@@ -0,0 +1,65 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+#include <vector>
+
+#include "catch.hpp"
+#include "commons/Data.h"
+
+using namespace grf;
+
+namespace {
+
+// Wraps two sparse columns of three rows, with an outcome column. The Data refers to the
+// given row indices and offsets, which must outlive it.
+Data sparse_data(const std::vector<int>& row_indices, const std::vector<int>& column_offsets) {
+  static const std::vector<double> values = {1, 2, 3, 4};
+  static const std::vector<double> outcome = {0, 1, 2};
+  return Data(values.data(), row_indices.data(), column_offsets.data(), 2, {outcome.data()}, 3);
+}
+
+} // namespace
+
+TEST_CASE("sparse columns are read through the index", "[data]") {
+  std::vector<int> row_indices = {0, 2, 1, 2};
+  std::vector<int> column_offsets = {0, 2, 4};
+  Data data = sparse_data(row_indices, column_offsets);
+  REQUIRE(data.get(0, 0) == 1);
+  REQUIRE(data.get(1, 0) == 0);
+  REQUIRE(data.get(2, 0) == 2);
+  REQUIRE(data.get(0, 1) == 0);
+  REQUIRE(data.get(1, 1) == 3);
+  REQUIRE(data.get(2, 1) == 4);
+}
+
+TEST_CASE("sparse row indices out of range are rejected", "[data]") {
+  REQUIRE_THROWS_AS(sparse_data({0, 3, 1, 2}, {0, 2, 4}), const std::runtime_error&);
+  REQUIRE_THROWS_AS(sparse_data({-1, 2, 1, 2}, {0, 2, 4}), const std::runtime_error&);
+}
+
+TEST_CASE("sparse row indices must increase within each column", "[data]") {
+  REQUIRE_THROWS_AS(sparse_data({2, 0, 1, 2}, {0, 2, 4}), const std::runtime_error&);
+  REQUIRE_THROWS_AS(sparse_data({0, 2, 1, 1}, {0, 2, 4}), const std::runtime_error&);
+  // Rows may restart at the beginning of the next column.
+  REQUIRE_NOTHROW(sparse_data({1, 2, 0, 1}, {0, 2, 4}));
+}
+
+TEST_CASE("sparse column offsets must be monotone", "[data]") {
+  REQUIRE_THROWS_AS(sparse_data({0, 1, 2, 2}, {0, 3, 2}), const std::runtime_error&);
+  REQUIRE_THROWS_AS(sparse_data({0, 2, 1, 2}, {-1, 2, 4}), const std::runtime_error&);
+}
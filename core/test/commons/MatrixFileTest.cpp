@@ -0,0 +1,228 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "catch.hpp"
+#include "commons/MatrixFile.h"
+
+using namespace grf;
+
+namespace {
+
+void write_file(const std::string& file_name, const std::string& contents) {
+  std::ofstream file(file_name, std::ios::binary);
+  file << contents;
+}
+
+} // namespace
+
+TEST_CASE("text matrices are read in column-major order", "[matrix_file]") {
+  std::string file_name = "matrix_file_test.csv";
+  write_file(file_name, "x1,x2,y\n1, 2.5,-3\r\n4,NA,6e-1\n\n7,,9\n");
+  auto matrix = load_matrix(file_name);
+  std::remove(file_name.c_str());
+
+  REQUIRE(matrix.second == std::vector<size_t>({3, 3}));
+  const std::vector<double>& values = matrix.first;
+  REQUIRE(values[0] == 1);
+  REQUIRE(values[1] == 4);
+  REQUIRE(values[2] == 7);
+  REQUIRE(values[3] == 2.5);
+  REQUIRE(std::isnan(values[4]));
+  REQUIRE(std::isnan(values[5]));
+  REQUIRE(values[6] == -3);
+  REQUIRE(values[7] == 0.6);
+  REQUIRE(values[8] == 9);
+}
+
+TEST_CASE("whitespace delimited matrices are read", "[matrix_file]") {
+  std::string file_name = "matrix_file_test.txt";
+  write_file(file_name, "1 2\t3\n 4  NaN 6 \n");
+  auto matrix = load_text_matrix(file_name);
+  std::remove(file_name.c_str());
+
+  REQUIRE(matrix.second == std::vector<size_t>({2, 3}));
+  REQUIRE(matrix.first[2] == 2);
+  REQUIRE(std::isnan(matrix.first[3]));
+}
+
+TEST_CASE("malformed text matrices are rejected", "[matrix_file]") {
+  std::string file_name = "matrix_file_test.csv";
+  write_file(file_name, "1,2,3\n4,5\n");
+  REQUIRE_THROWS(load_text_matrix(file_name));
+  write_file(file_name, "1,2\n3,abc\n");
+  REQUIRE_THROWS(load_text_matrix(file_name));
+  write_file(file_name, "1,2,x\n3,4,5\n");
+  REQUIRE_THROWS(load_text_matrix(file_name));
+  write_file(file_name, "\n1.5 2x\n3 4\n");
+  REQUIRE_THROWS(load_text_matrix(file_name));
+  std::remove(file_name.c_str());
+
+  REQUIRE_THROWS(load_matrix("test/commons/does_not_exist.csv"));
+}
+
+TEST_CASE("matrices round trip through binary and text files", "[matrix_file]") {
+  std::vector<double> values = {0.1, -2, 1e-300, NAN, 3.0 / 7, 12345678.9};
+
+  std::string binary_file_name = "matrix_file_test.grfm";
+  save_binary_matrix(values, 3, 2, binary_file_name);
+  auto binary_matrix = load_matrix(binary_file_name);
+  std::remove(binary_file_name.c_str());
+
+  std::string text_file_name = "matrix_file_test.csv";
+  save_text_matrix(values, 3, 2, text_file_name);
+  auto text_matrix = load_matrix(text_file_name);
+  std::remove(text_file_name.c_str());
+
+  for (const auto& matrix : {binary_matrix, text_matrix}) {
+    REQUIRE(matrix.second == std::vector<size_t>({3, 2}));
+    for (size_t i = 0; i < values.size(); i++) {
+      if (std::isnan(values[i])) {
+        REQUIRE(std::isnan(matrix.first[i]));
+      } else {
+        REQUIRE(matrix.first[i] == values[i]);
+      }
+    }
+  }
+}
+
+TEST_CASE("large text matrices are parsed in parallel chunks", "[matrix_file]") {
+  // Enough rows for the file to be split into several chunks, with blank lines
+  // and missing values spread throughout.
+  size_t num_rows = 300000;
+  std::string contents = "a,b,c\n";
+  for (size_t row = 0; row < num_rows; row++) {
+    contents += std::to_string(row) + "," + (row % 7 == 0 ? "NA" : std::to_string(row * 0.5)) + ",-1\n";
+    if (row % 1000 == 0) {
+      contents += "\n";
+    }
+  }
+  std::string file_name = "matrix_file_test.csv";
+  write_file(file_name, contents);
+  auto matrix = load_text_matrix(file_name, 4);
+
+  REQUIRE(matrix.second == std::vector<size_t>({num_rows, 3}));
+  size_t num_mismatches = 0;
+  for (size_t row = 0; row < num_rows; row++) {
+    double expected_b = row % 7 == 0 ? NAN : std::stod(std::to_string(row * 0.5));
+    bool b_matches = std::isnan(expected_b) ? std::isnan(matrix.first[num_rows + row])
+                                            : matrix.first[num_rows + row] == expected_b;
+    if (matrix.first[row] != row || !b_matches || matrix.first[2 * num_rows + row] != -1) {
+      num_mismatches++;
+    }
+  }
+  REQUIRE(num_mismatches == 0);
+
+  // Errors report the line number within the whole file.
+  write_file(file_name, contents + "1,2\n");
+  std::string message;
+  try {
+    load_text_matrix(file_name, 4);
+  } catch (const std::runtime_error& e) {
+    message = e.what();
+  }
+  std::remove(file_name.c_str());
+  REQUIRE(message == "Line " + std::to_string(1 + num_rows + num_rows / 1000 + 1) + " of " + file_name +
+                     " has 2 values, but expected 3.");
+}
+
+TEST_CASE("binary matrices are memory mapped with page aligned columns", "[matrix_file]") {
+  size_t num_rows = 1000;
+  size_t num_cols = 3;
+  std::vector<double> values(num_rows * num_cols);
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = i * 0.25;
+  }
+  std::string file_name = "matrix_file_test.grfm";
+  save_binary_matrix(values, num_rows, num_cols, {"x", "y", "w"}, file_name);
+
+  {
+    MappedMatrix matrix(file_name);
+    Data data = matrix.get_data();
+    REQUIRE(matrix.get_column_names() == std::vector<std::string>({"x", "y", "w"}));
+    REQUIRE(data.get_num_rows() == num_rows);
+    REQUIRE(data.get_num_cols() == num_cols);
+    for (size_t col = 0; col < num_cols; col++) {
+      for (size_t row = 0; row < num_rows; row++) {
+        REQUIRE(data.get(row, col) == values[col * num_rows + row]);
+      }
+    }
+  }
+
+  // Each column of 8000 bytes is padded to two pages, after a one page header.
+  std::ifstream file(file_name, std::ios::binary | std::ios::ate);
+  REQUIRE(file.tellg() == 4096 + 3 * 8192);
+  double first_value_of_second_column;
+  file.seekg(4096 + 8192);
+  file.read(reinterpret_cast<char*>(&first_value_of_second_column), sizeof(double));
+  REQUIRE(first_value_of_second_column == values[num_rows]);
+  file.close();
+
+  REQUIRE(load_column_names(file_name) == std::vector<std::string>({"x", "y", "w"}));
+  REQUIRE(load_binary_matrix(file_name).first == values);
+  std::remove(file_name.c_str());
+}
+
+TEST_CASE("text column names are read from the header", "[matrix_file]") {
+  std::string file_name = "matrix_file_test.csv";
+  write_file(file_name, "\n x1 , y,\"w\"\n1,2,3\n");
+  REQUIRE(load_column_names(file_name) == std::vector<std::string>({"x1", "y", "\"w\""}));
+  write_file(file_name, "1,2,3\n");
+  REQUIRE(load_column_names(file_name).empty());
+  write_file(file_name, "x,,NA\n1,2,3\n");
+  REQUIRE(load_text_matrix(file_name).second == std::vector<size_t>({1, 3}));
+  write_file(file_name, "1,2,x\n1,2,3\n");
+  REQUIRE(load_column_names(file_name).empty());
+  std::remove(file_name.c_str());
+}
+
+TEST_CASE("leading columns can be stored and mapped as floats", "[matrix_file]") {
+  size_t num_rows = 5;
+  std::vector<double> values = {0.1, 0.2, 0.3, 0.4, 0.5,
+                                1e10, -1, 2, NAN, 1.0 / 3,
+                                0.1, 0.2, 0.3, 0.4, 0.5};
+  std::string file_name = "matrix_file_test.grfm";
+  save_binary_matrix(values, num_rows, 3, {}, 2, file_name);
+
+  auto loaded = load_binary_matrix(file_name);
+  {
+    MappedMatrix matrix(file_name);
+    Data data = matrix.get_data();
+    REQUIRE(matrix.get_num_float_cols() == 2);
+    REQUIRE(data.get_num_float_cols() == 2);
+    for (size_t col = 0; col < 3; col++) {
+      for (size_t row = 0; row < num_rows; row++) {
+        double value = values[col * num_rows + row];
+        // The float columns hold the values rounded to single precision.
+        double expected = col < 2 ? static_cast<float>(value) : value;
+        if (std::isnan(expected)) {
+          REQUIRE(std::isnan(data.get(row, col)));
+          REQUIRE(std::isnan(loaded.first[col * num_rows + row]));
+        } else {
+          REQUIRE(data.get(row, col) == expected);
+          REQUIRE(loaded.first[col * num_rows + row] == expected);
+        }
+      }
+    }
+  }
+  std::remove(file_name.c_str());
+}
@@ -0,0 +1,266 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+
+#include "commons/utility.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestSerializer.h"
+#include "forest/ForestTrainers.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("serialized forests round trip", "[forest, serialization]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = ForestTestUtilities::default_options(true, 2);
+  Forest forest = trainer.train(data, options);
+
+  ForestSerializer serializer;
+  std::stringstream stream;
+  serializer.write(forest, stream);
+  Forest read_forest = serializer.read(stream);
+
+  REQUIRE(read_forest.get_num_variables() == forest.get_num_variables());
+  REQUIRE(read_forest.get_ci_group_size() == forest.get_ci_group_size());
+  REQUIRE(read_forest.get_trees().size() == forest.get_trees().size());
+  for (size_t t = 0; t < forest.get_trees().size(); t++) {
+    ForestTestUtilities::check_trees_equal(*forest.get_trees()[t], *read_forest.get_trees()[t]);
+  }
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, true);
+  std::vector<Prediction> read_predictions = predictor.predict_oob(read_forest, data, true);
+  for (size_t i = 0; i < predictions.size(); i++) {
+    REQUIRE(predictions[i].get_predictions() == read_predictions[i].get_predictions());
+    REQUIRE(predictions[i].get_variance_estimates() == read_predictions[i].get_variance_estimates());
+  }
+}
+
+TEST_CASE("serialized forests with missing values and no prediction values round trip", "[forest, serialization]") {
+  auto data_vec = load_data("test/forest/resources/quantile_data_MIA.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = quantile_trainer({0.1, 0.5, 0.9});
+  ForestOptions options = ForestTestUtilities::default_honest_options();
+  Forest forest = trainer.train(data, options);
+
+  ForestSerializer serializer;
+  std::stringstream stream;
+  serializer.write(forest, stream);
+  Forest read_forest = serializer.read(stream);
+
+  REQUIRE(read_forest.get_trees().size() == forest.get_trees().size());
+  for (size_t t = 0; t < forest.get_trees().size(); t++) {
+    ForestTestUtilities::check_trees_equal(*forest.get_trees()[t], *read_forest.get_trees()[t]);
+  }
+}
+
+TEST_CASE("forest metadata round trips", "[forest, serialization]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  Forest forest = regression_trainer().train(data, ForestTestUtilities::default_options());
+
+  ForestMetadata metadata;
+  metadata["type"] = "regression";
+  metadata["outcome_index"] = "10";
+  metadata["note"] = "a = b";
+
+  ForestSerializer serializer;
+  std::stringstream stream;
+  serializer.write(forest, metadata, stream);
+  ForestMetadata read_metadata;
+  Forest read_forest = serializer.read(stream, read_metadata);
+
+  REQUIRE(read_metadata == metadata);
+  REQUIRE(read_forest.get_trees().size() == forest.get_trees().size());
+
+  // Forests written without metadata read back with none.
+  std::stringstream plain_stream;
+  serializer.write(forest, plain_stream);
+  serializer.read(plain_stream, read_metadata);
+  REQUIRE(read_metadata.empty());
+
+  ForestMetadata invalid_metadata;
+  invalid_metadata["bad=key"] = "value";
+  std::stringstream invalid_stream;
+  REQUIRE_THROWS(serializer.write(forest, invalid_metadata, invalid_stream));
+}
+
+TEST_CASE("reading an invalid forest stream fails", "[forest, serialization]") {
+  ForestSerializer serializer;
+
+  std::stringstream bad_header("not a forest");
+  REQUIRE_THROWS(serializer.read(bad_header));
+
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  Forest forest = regression_trainer().train(data, ForestTestUtilities::default_options());
+
+  std::stringstream stream;
+  serializer.write(forest, stream);
+  std::string contents = stream.str();
+  std::stringstream truncated(contents.substr(0, contents.size() / 2));
+  REQUIRE_THROWS(serializer.read(truncated));
+
+  std::string other_version = contents;
+  other_version[4] = 2;
+  std::stringstream other_version_stream(other_version);
+  REQUIRE_THROWS(serializer.read(other_version_stream));
+}
+
+namespace {
+
+void write_value_at(std::string& contents, size_t offset, uint64_t value) {
+  for (size_t i = 0; i < 8; i++) {
+    contents[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+  }
+}
+
+void require_read_fails(const std::string& contents) {
+  ForestSerializer serializer;
+  std::stringstream stream(contents);
+  REQUIRE_THROWS_AS(serializer.read(stream), const std::runtime_error&);
+}
+
+/**
+ * A stream buffer that cannot seek, like a pipe.
+ */
+class UnseekableBuffer : public std::streambuf {
+public:
+  UnseekableBuffer(std::string& contents) {
+    setg(&contents[0], &contents[0], &contents[0] + contents.size());
+  }
+};
+
+} // namespace
+
+TEST_CASE("reading a corrupt forest stream fails without allocating", "[forest, serialization]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  Forest forest = regression_trainer().train(data, ForestTestUtilities::default_options());
+
+  ForestSerializer serializer;
+  std::stringstream stream;
+  serializer.write(forest, stream);
+  std::string contents = stream.str();
+
+  // The header takes 32 bytes, followed by the (empty) metadata size. The first
+  // tree then starts with its root node and num_nodes.
+  size_t num_trees_offset = 24;
+  size_t tree_offset = 40;
+  size_t num_nodes = forest.get_trees()[0]->get_child_nodes()[0].size();
+  REQUIRE(num_nodes > 1);
+  size_t children_offset = tree_offset + 16;
+  size_t split_vars_offset = children_offset + 16 * num_nodes;
+
+  std::string huge_num_trees = contents;
+  write_value_at(huge_num_trees, num_trees_offset, uint64_t(1) << 60);
+  require_read_fails(huge_num_trees);
+
+  std::string huge_num_nodes = contents;
+  write_value_at(huge_num_nodes, tree_offset + 8, uint64_t(1) << 60);
+  require_read_fails(huge_num_nodes);
+
+  std::string bad_root = contents;
+  write_value_at(bad_root, tree_offset, num_nodes);
+  require_read_fails(bad_root);
+
+  std::string bad_child = contents;
+  write_value_at(bad_child, children_offset + 8 * num_nodes, num_nodes + 5);
+  require_read_fails(bad_child);
+
+  // A child pointing back at its own node would send traversal into a cycle.
+  size_t root_node = forest.get_trees()[0]->get_root_node();
+  std::string cyclic_child = contents;
+  write_value_at(cyclic_child, children_offset + 8 * root_node, root_node);
+  require_read_fails(cyclic_child);
+
+  std::string bad_split_var = contents;
+  write_value_at(bad_split_var, split_vars_offset, forest.get_num_variables());
+  require_read_fails(bad_split_var);
+
+  // The leaf sample offsets follow the split values, the send_missing_left bytes
+  // and num_leaf_sample_nodes.
+  size_t leaf_samples_offset = split_vars_offset + 16 * num_nodes + num_nodes + 8;
+  std::string huge_leaf_offsets = contents;
+  write_value_at(huge_leaf_offsets, leaf_samples_offset + 8 * num_nodes, uint64_t(1) << 60);
+  require_read_fails(huge_leaf_offsets);
+
+  std::string bad_leaf_sample = contents;
+  write_value_at(bad_leaf_sample, leaf_samples_offset + 8 * (num_nodes + 1), data.get_num_rows() + 64);
+  require_read_fails(bad_leaf_sample);
+
+  // Streams that cannot seek are read in bounded chunks, so a huge count fails at the end of the stream.
+  UnseekableBuffer buffer(huge_num_nodes);
+  std::istream unseekable(&buffer);
+  REQUIRE_THROWS_AS(serializer.read(unseekable), const std::runtime_error&);
+
+  std::string unseekable_contents = contents;
+  UnseekableBuffer valid_buffer(unseekable_contents);
+  std::istream valid_unseekable(&valid_buffer);
+  Forest read_forest = serializer.read(valid_unseekable);
+  REQUIRE(read_forest.get_trees().size() == forest.get_trees().size());
+}
+
+TEST_CASE("forests saved to disk can be loaded", "[forest, serialization]") {
+  auto data_vec = load_data("test/forest/resources/causal_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  data.set_treatment_index(11);
+  data.set_instrument_index(11);
+
+  ForestTrainer trainer = instrumental_trainer(0, true);
+  ForestOptions options = ForestTestUtilities::default_options(true, 2);
+  Forest forest = trainer.train(data, options);
+
+  ForestSerializer serializer;
+  std::string file_name = "forest_serializer_test.grf";
+  serializer.save(forest, file_name);
+  Forest loaded_forest = serializer.load(file_name);
+  std::remove(file_name.c_str());
+
+  REQUIRE(loaded_forest.get_trees().size() == forest.get_trees().size());
+  for (size_t t = 0; t < forest.get_trees().size(); t++) {
+    ForestTestUtilities::check_trees_equal(*forest.get_trees()[t], *loaded_forest.get_trees()[t]);
+  }
+
+  ForestPredictor predictor = instrumental_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, true);
+  std::vector<Prediction> loaded_predictions = predictor.predict_oob(loaded_forest, data, true);
+  for (size_t i = 0; i < predictions.size(); i++) {
+    REQUIRE(predictions[i].get_predictions() == loaded_predictions[i].get_predictions());
+    REQUIRE(predictions[i].get_variance_estimates() == loaded_predictions[i].get_variance_estimates());
+  }
+}
+
+TEST_CASE("loading a missing forest file fails", "[forest, serialization]") {
+  ForestSerializer serializer;
+  REQUIRE_THROWS(serializer.load("test/forest/resources/does_not_exist.grf"));
+}
@@ -15,11 +15,15 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <cmath>
+#include <sstream>
 #include <stdexcept>
 
+#include "Eigen/Sparse"
 #include "commons/utility.h"
 #include "forest/ForestPredictor.h"
 #include "forest/ForestPredictors.h"
+#include "forest/ForestSerializer.h"
 #include "forest/ForestTrainer.h"
 #include "forest/ForestTrainers.h"
 #include "utilities/ForestTestUtilities.h"
@@ -109,3 +113,382 @@ TEST_CASE("forests with different ci_group_size cannot be merged", "[regression,
     // Expected exception.
   }
 }
+
+TEST_CASE("forests with different num_variables cannot be merged", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = ForestTestUtilities::default_options();
+
+  std::vector<Forest> forests;
+  forests.push_back(trainer.train(data, options));
+
+  Data fewer_columns(data_vec.first.data(), data.get_num_rows(), data.get_num_cols() - 1);
+  fewer_columns.set_outcome_index(9);
+  forests.push_back(trainer.train(fewer_columns, options));
+
+  try {
+    Forest big_forest = Forest::merge(forests);
+    FAIL();
+  } catch (const std::runtime_error&) {
+    // Expected exception.
+  }
+
+  // A rejected merge leaves the input forests untouched.
+  REQUIRE(forests[0].get_trees().size() == 50);
+  REQUIRE(forests[1].get_trees().size() == 50);
+}
+
+TEST_CASE("forests without leaf samples predict through prediction values", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = ForestTestUtilities::default_options(true, 2);
+  Forest forest = trainer.train(data, options);
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, true);
+
+  std::stringstream full_stream;
+  ForestSerializer().write(forest, full_stream);
+
+  forest.drop_leaf_samples();
+  REQUIRE(!forest.has_leaf_samples());
+
+  std::stringstream lean_stream;
+  ForestSerializer().write(forest, lean_stream);
+  REQUIRE(lean_stream.str().size() < full_stream.str().size());
+
+  Forest read_forest = ForestSerializer().read(lean_stream);
+  REQUIRE(!read_forest.has_leaf_samples());
+
+  std::vector<Prediction> lean_predictions = predictor.predict_oob(read_forest, data, true);
+  for (size_t i = 0; i < predictions.size(); i++) {
+    REQUIRE(predictions[i].get_predictions() == lean_predictions[i].get_predictions());
+    REQUIRE(predictions[i].get_variance_estimates() == lean_predictions[i].get_variance_estimates());
+  }
+
+  std::vector<double> lambdas = {0.1};
+  std::vector<size_t> linear_correction_variables = {1, 2};
+  ForestPredictor ll_predictor = ll_regression_predictor(4, lambdas, false, linear_correction_variables);
+  REQUIRE_THROWS(ll_predictor.predict_oob(read_forest, data, false));
+}
+
+TEST_CASE("forests can be trained without leaf samples", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options(true, 2));
+  Forest lean_forest = trainer.train(data, ForestTestUtilities::default_options(true, 2, false));
+  REQUIRE(!lean_forest.has_leaf_samples());
+
+  forest.drop_leaf_samples();
+  std::stringstream stream;
+  ForestSerializer().write(forest, stream);
+  std::stringstream lean_stream;
+  ForestSerializer().write(lean_forest, lean_stream);
+  REQUIRE(stream.str() == lean_stream.str());
+
+  ForestTrainer quantile = quantile_trainer({0.5});
+  REQUIRE_THROWS_AS(quantile.train(data, ForestTestUtilities::default_options(true, 1, false)),
+                    const std::runtime_error&);
+}
+
+TEST_CASE("leaf samples are kept when there are no prediction values", "[quantile, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = quantile_trainer({0.5});
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+
+  REQUIRE_THROWS(forest.drop_leaf_samples());
+  REQUIRE(forest.has_leaf_samples());
+}
+
+TEST_CASE("predictions written into columnar buffers match prediction objects", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  size_t num_samples = data.get_num_rows();
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options(false, 2));
+  ForestPredictor predictor = regression_predictor(4);
+  REQUIRE(predictor.get_prediction_length() == 1);
+  REQUIRE(predictor.supports_error_estimates());
+
+  std::vector<Prediction> expected = predictor.predict_oob(forest, data, true);
+
+  std::vector<double> predictions(num_samples);
+  std::vector<double> variance_estimates(num_samples);
+  std::vector<double> error_estimates(num_samples);
+  std::vector<double> excess_error_estimates(num_samples);
+  PredictionOutput output(num_samples, 1, predictions.data(), variance_estimates.data(),
+                          error_estimates.data(), excess_error_estimates.data());
+  predictor.predict_oob(forest, data, output);
+
+  for (size_t i = 0; i < num_samples; i++) {
+    REQUIRE(equal_doubles(predictions[i], expected[i].get_predictions()[0], 1e-10));
+    REQUIRE(equal_doubles(variance_estimates[i], expected[i].get_variance_estimates()[0], 1e-10));
+    REQUIRE(equal_doubles(error_estimates[i], expected[i].get_error_estimates()[0], 1e-10));
+    REQUIRE(equal_doubles(excess_error_estimates[i], expected[i].get_excess_error_estimates()[0], 1e-10));
+  }
+
+  // Error estimates are only available out-of-bag.
+  REQUIRE_THROWS(predictor.predict(forest, data, data, output));
+}
+
+TEST_CASE("columnar prediction buffers are laid out column by column", "[quantile, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  size_t num_samples = data.get_num_rows();
+
+  std::vector<double> quantiles = {0.25, 0.5, 0.75};
+  ForestTrainer trainer = quantile_trainer(quantiles);
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+  ForestPredictor predictor = quantile_predictor(4, quantiles);
+  REQUIRE(predictor.get_prediction_length() == quantiles.size());
+  REQUIRE_FALSE(predictor.supports_error_estimates());
+
+  std::vector<Prediction> expected = predictor.predict(forest, data, data, false);
+
+  std::vector<double> predictions(num_samples * quantiles.size());
+  PredictionOutput output(num_samples, quantiles.size(), predictions.data(), nullptr, nullptr, nullptr);
+  predictor.predict(forest, data, data, output);
+
+  for (size_t i = 0; i < num_samples; i++) {
+    for (size_t j = 0; j < quantiles.size(); j++) {
+      REQUIRE(equal_doubles(predictions[i + j * num_samples], expected[i].get_predictions()[j], 1e-10));
+    }
+  }
+
+  PredictionOutput wrong_length(num_samples, 1, predictions.data(), nullptr, nullptr, nullptr);
+  REQUIRE_THROWS(predictor.predict(forest, data, data, wrong_length));
+}
+
+TEST_CASE("micro-batch predictions match batch predictions", "[regression, quantile, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  // Copy the first rows into a small column-major test matrix.
+  size_t num_cols = data.get_num_cols();
+  size_t batch_size = 7;
+  std::vector<double> batch_vec(batch_size * num_cols);
+  for (size_t row = 0; row < batch_size; row++) {
+    for (size_t col = 0; col < num_cols; col++) {
+      batch_vec[row + col * batch_size] = data.get(row, col);
+    }
+  }
+  Data batch(batch_vec, batch_size, num_cols);
+
+  PredictionScratch scratch;
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options(false, 2));
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> expected = predictor.predict(forest, data, batch, true);
+
+  std::vector<double> predictions(batch_size);
+  std::vector<double> variance_estimates(batch_size);
+  PredictionOutput output(batch_size, 1, predictions.data(), variance_estimates.data(), nullptr, nullptr);
+  predictor.predict_micro_batch(forest, data, batch, output, scratch);
+  for (size_t i = 0; i < batch_size; i++) {
+    REQUIRE(equal_doubles(predictions[i], expected[i].get_predictions()[0], 1e-10));
+    REQUIRE(equal_doubles(variance_estimates[i], expected[i].get_variance_estimates()[0], 1e-10));
+  }
+
+  // The same scratch can be reused with a predictor using a default prediction strategy.
+  std::vector<double> quantiles = {0.1, 0.9};
+  ForestTrainer quantile_forest_trainer = quantile_trainer(quantiles);
+  Forest quantile_forest = quantile_forest_trainer.train(data, ForestTestUtilities::default_options());
+  ForestPredictor quantile_forest_predictor = quantile_predictor(4, quantiles);
+  std::vector<Prediction> expected_quantiles = quantile_forest_predictor.predict(quantile_forest, data, batch, false);
+
+  std::vector<double> quantile_predictions(batch_size * quantiles.size());
+  PredictionOutput quantile_output(batch_size, quantiles.size(), quantile_predictions.data(), nullptr, nullptr, nullptr);
+  quantile_forest_predictor.predict_micro_batch(quantile_forest, data, batch, quantile_output, scratch);
+  for (size_t i = 0; i < batch_size; i++) {
+    for (size_t j = 0; j < quantiles.size(); j++) {
+      REQUIRE(equal_doubles(quantile_predictions[i + j * batch_size], expected_quantiles[i].get_predictions()[j], 1e-10));
+    }
+  }
+}
+
+TEST_CASE("forests on float covariates match forests on the same values as doubles", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  size_t num_rows = data_vec.second[0];
+  size_t num_covariates = data_vec.second[1] - 1;
+
+  // Store the covariates as floats and the outcome as a double, and build the same
+  // values in plain double storage for comparison.
+  std::vector<float> float_covariates(num_rows * num_covariates);
+  std::vector<double> double_values(data_vec.first);
+  for (size_t i = 0; i < float_covariates.size(); i++) {
+    float_covariates[i] = static_cast<float>(data_vec.first[i]);
+    double_values[i] = float_covariates[i];
+  }
+  const double* outcome = data_vec.first.data() + num_rows * num_covariates;
+
+  Data float_data(float_covariates.data(), num_covariates, num_rows, outcome, num_rows, num_rows, num_covariates + 1);
+  float_data.set_outcome_index(num_covariates);
+  Data double_data(double_values, num_rows, num_covariates + 1);
+  double_data.set_outcome_index(num_covariates);
+  REQUIRE(float_data.get_num_float_cols() == num_covariates);
+
+  ForestTrainer trainer = regression_trainer();
+  Forest float_forest = trainer.train(float_data, ForestTestUtilities::default_options(false, 2));
+  Forest double_forest = trainer.train(double_data, ForestTestUtilities::default_options(false, 2));
+
+  std::stringstream float_stream;
+  std::stringstream double_stream;
+  ForestSerializer().write(float_forest, float_stream);
+  ForestSerializer().write(double_forest, double_stream);
+  REQUIRE(float_stream.str() == double_stream.str());
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> float_predictions = predictor.predict(float_forest, float_data, float_data, true);
+  std::vector<Prediction> double_predictions = predictor.predict(float_forest, double_data, double_data, true);
+  for (size_t i = 0; i < num_rows; i++) {
+    REQUIRE(float_predictions[i].get_predictions() == double_predictions[i].get_predictions());
+    REQUIRE(float_predictions[i].get_variance_estimates() == double_predictions[i].get_variance_estimates());
+  }
+}
+
+TEST_CASE("forests on separately stored columns match forests on one contiguous array", "[causal, forest]") {
+  auto data_vec = load_data("test/forest/resources/causal_data.csv");
+  size_t num_rows = data_vec.second[0];
+  size_t num_cols = data_vec.second[1];
+  Data contiguous_data(data_vec);
+  contiguous_data.set_outcome_index(10);
+  contiguous_data.set_treatment_index(11);
+  contiguous_data.set_instrument_index(11);
+
+  // Keep the covariates in place, and attach copies of the outcome and treatment
+  // columns, as the callers would with separately owned response vectors.
+  std::vector<double> outcome(data_vec.first.begin() + 10 * num_rows, data_vec.first.begin() + 11 * num_rows);
+  std::vector<double> treatment(data_vec.first.begin() + 11 * num_rows, data_vec.first.begin() + 12 * num_rows);
+  std::vector<const double*> columns;
+  for (size_t col = 0; col < 10; col++) {
+    columns.push_back(data_vec.first.data() + col * num_rows);
+  }
+  columns.push_back(outcome.data());
+  columns.push_back(treatment.data());
+  Data column_data(columns, num_rows);
+  column_data.set_outcome_index(10);
+  column_data.set_treatment_index(11);
+  column_data.set_instrument_index(11);
+  REQUIRE(column_data.get_num_cols() == num_cols);
+
+  std::vector<size_t> samples = {4, 2, 7, 2, 0};
+  for (size_t col = 0; col < num_cols; col++) {
+    std::vector<double> contiguous_values;
+    std::vector<double> column_values;
+    std::vector<size_t> contiguous_sorted;
+    std::vector<size_t> column_sorted;
+    contiguous_data.get_all_values(contiguous_values, contiguous_sorted, samples, col);
+    column_data.get_all_values(column_values, column_sorted, samples, col);
+    REQUIRE(contiguous_values == column_values);
+    REQUIRE(contiguous_sorted == column_sorted);
+  }
+
+  ForestTrainer trainer = instrumental_trainer(0, false);
+  Forest contiguous_forest = trainer.train(contiguous_data, ForestTestUtilities::default_options(false, 2));
+  Forest column_forest = trainer.train(column_data, ForestTestUtilities::default_options(false, 2));
+
+  std::stringstream contiguous_stream;
+  std::stringstream column_stream;
+  ForestSerializer().write(contiguous_forest, contiguous_stream);
+  ForestSerializer().write(column_forest, column_stream);
+  REQUIRE(contiguous_stream.str() == column_stream.str());
+
+  std::vector<const double*> null_columns = {data_vec.first.data(), nullptr};
+  bool threw = false;
+  try {
+    Data invalid_data(null_columns, num_rows);
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  REQUIRE(threw);
+}
+
+TEST_CASE("forests on sparse covariates match forests on the same values as dense columns", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  size_t num_rows = data_vec.second[0];
+  size_t num_covariates = data_vec.second[1] - 1;
+
+  // Zero out most of the covariates, and mark a few entries as missing.
+  std::vector<double> dense_values(data_vec.first);
+  for (size_t i = 0; i < num_rows * num_covariates; i++) {
+    if (std::abs(dense_values[i]) < 1) {
+      dense_values[i] = 0;
+    } else if (i % 97 == 0) {
+      dense_values[i] = NAN;
+    }
+  }
+  // The splitting rules derive the sums over the zeros of a sparse column from the node totals,
+  // which rounds differently than summing them, and can break ties between equally good splits
+  // the other way. Outcomes in multiples of 1/8 make all these sums exact.
+  for (size_t i = num_rows * num_covariates; i < dense_values.size(); i++) {
+    dense_values[i] = std::round(dense_values[i] * 8) / 8;
+  }
+  Eigen::Map<const Eigen::MatrixXd> covariates(dense_values.data(), num_rows, num_covariates);
+  Eigen::SparseMatrix<double> sparse_covariates = covariates.sparseView();
+  sparse_covariates.makeCompressed();
+  REQUIRE(static_cast<size_t>(sparse_covariates.nonZeros()) < num_rows * num_covariates / 2);
+
+  std::vector<const double*> outcome = {dense_values.data() + num_rows * num_covariates};
+  Data sparse_data(sparse_covariates.valuePtr(), sparse_covariates.innerIndexPtr(),
+                   sparse_covariates.outerIndexPtr(), num_covariates, outcome, num_rows);
+  sparse_data.set_outcome_index(num_covariates);
+  Data dense_data(dense_values, num_rows, num_covariates + 1);
+  dense_data.set_outcome_index(num_covariates);
+  REQUIRE(sparse_data.get_num_cols() == num_covariates + 1);
+  REQUIRE(sparse_data.get_num_sparse_cols() == num_covariates);
+
+  std::vector<size_t> samples;
+  for (size_t sample = 0; sample < num_rows; sample += 3) {
+    samples.push_back(sample);
+  }
+  for (size_t col = 0; col < num_covariates + 1; col++) {
+    for (size_t row = 0; row < num_rows; row++) {
+      double dense_value = dense_data.get(row, col);
+      double sparse_value = sparse_data.get(row, col);
+      REQUIRE((dense_value == sparse_value || (std::isnan(dense_value) && std::isnan(sparse_value))));
+    }
+    std::vector<double> dense_all_values;
+    std::vector<double> sparse_all_values;
+    std::vector<size_t> dense_sorted;
+    std::vector<size_t> sparse_sorted;
+    dense_data.get_all_values(dense_all_values, dense_sorted, samples, col);
+    sparse_data.get_all_values(sparse_all_values, sparse_sorted, samples, col);
+    REQUIRE(dense_sorted == sparse_sorted);
+    REQUIRE(dense_all_values.size() == sparse_all_values.size());
+  }
+
+  ForestTrainer trainer = regression_trainer();
+  Forest sparse_forest = trainer.train(sparse_data, ForestTestUtilities::default_options(false, 2));
+  Forest dense_forest = trainer.train(dense_data, ForestTestUtilities::default_options(false, 2));
+
+  std::stringstream sparse_stream;
+  std::stringstream dense_stream;
+  ForestSerializer().write(sparse_forest, sparse_stream);
+  ForestSerializer().write(dense_forest, dense_stream);
+  REQUIRE(sparse_stream.str() == dense_stream.str());
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> sparse_predictions = predictor.predict(sparse_forest, sparse_data, sparse_data, true);
+  std::vector<Prediction> dense_predictions = predictor.predict(sparse_forest, dense_data, dense_data, true);
+  for (size_t i = 0; i < num_rows; i++) {
+    REQUIRE(sparse_predictions[i].get_predictions() == dense_predictions[i].get_predictions());
+    REQUIRE(sparse_predictions[i].get_variance_estimates() == dense_predictions[i].get_variance_estimates());
+  }
+}
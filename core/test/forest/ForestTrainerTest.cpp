@@ -0,0 +1,277 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+
+#include "commons/utility.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/RegressionPredictionStrategy.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+ForestOptions options_with_threads(size_t ci_group_size, uint num_threads, uint num_trees = 50) {
+  std::vector<size_t> empty_clusters;
+  return ForestOptions(num_trees, ci_group_size, 0.35, 3, 1, true, 0.5, true, 0.0, 0.0,
+                       num_threads, 42, empty_clusters, 0);
+}
+
+void check_forests_equal(const Forest& first, const Forest& second) {
+  REQUIRE(first.get_num_variables() == second.get_num_variables());
+  REQUIRE(first.get_ci_group_size() == second.get_ci_group_size());
+  REQUIRE(first.get_trees().size() == second.get_trees().size());
+  for (size_t t = 0; t < first.get_trees().size(); t++) {
+    ForestTestUtilities::check_trees_equal(*first.get_trees()[t], *second.get_trees()[t]);
+  }
+}
+
+void check_predictions_equal(const std::vector<Prediction>& expected_predictions,
+                             const std::vector<Prediction>& predictions) {
+  REQUIRE(predictions.size() == expected_predictions.size());
+  for (size_t i = 0; i < predictions.size(); i++) {
+    double expected = expected_predictions[i].get_predictions()[0];
+    double actual = predictions[i].get_predictions()[0];
+    if (std::isnan(expected)) {
+      REQUIRE(std::isnan(actual));
+    } else {
+      REQUIRE(equal_doubles(expected, actual, 1e-10));
+    }
+  }
+}
+
+TEST_CASE("forests do not depend on the number of threads", "[forest, training]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  Forest single_threaded = trainer.train(data, options_with_threads(2, 1));
+  Forest multi_threaded = trainer.train(data, options_with_threads(2, 3));
+
+  check_forests_equal(single_threaded, multi_threaded);
+}
+
+TEST_CASE("forests trained in shards merge into the full forest", "[forest, training]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, options_with_threads(2, 4));
+
+  std::vector<Forest> shards;
+  shards.push_back(trainer.train(data, options_with_threads(2, 1), 0, 12));
+  shards.push_back(trainer.train(data, options_with_threads(2, 2), 12, 30));
+  shards.push_back(trainer.train(data, options_with_threads(2, 4), 30, 50));
+  REQUIRE(shards[1].get_trees().size() == 18);
+
+  Forest merged_forest = Forest::merge(shards);
+  check_forests_equal(forest, merged_forest);
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, true);
+  std::vector<Prediction> merged_predictions = predictor.predict_oob(merged_forest, data, true);
+  for (size_t i = 0; i < predictions.size(); i++) {
+    REQUIRE(predictions[i].get_predictions() == merged_predictions[i].get_predictions());
+    REQUIRE(predictions[i].get_variance_estimates() == merged_predictions[i].get_variance_estimates());
+  }
+}
+
+TEST_CASE("tree ranges must be aligned to ci groups", "[forest, training]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = options_with_threads(2, 4);
+
+  REQUIRE_THROWS(trainer.train(data, options, 1, 10));
+  REQUIRE_THROWS(trainer.train(data, options, 0, 9));
+  REQUIRE_THROWS(trainer.train(data, options, 10, 4));
+  REQUIRE(trainer.train(data, options, 10, 10).get_trees().empty());
+
+  // Full forests only contain whole ci groups.
+  std::vector<size_t> empty_clusters;
+  ForestOptions unaligned_options(7, 3, 0.35, 3, 1, true, 0.5, true, 0.0, 0.0, 4, 42, empty_clusters, 0);
+  REQUIRE(trainer.train(data, unaligned_options).get_trees().size() == 6);
+}
+
+TEST_CASE("grown forests match forests trained directly", "[forest, training]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, options_with_threads(2, 4, 20));
+  trainer.grow(forest, data, options_with_threads(2, 3, 50));
+  REQUIRE(forest.get_trees().size() == 50);
+
+  Forest expected_forest = trainer.train(data, options_with_threads(2, 4, 50));
+  check_forests_equal(expected_forest, forest);
+
+  // Growing to a smaller size leaves the forest unchanged.
+  trainer.grow(forest, data, options_with_threads(2, 4, 30));
+  REQUIRE(forest.get_trees().size() == 50);
+
+  REQUIRE_THROWS(trainer.grow(forest, data, options_with_threads(1, 4, 60)));
+}
+
+TEST_CASE("OOB predictions are updated as forests grow", "[forest, training]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  RegressionPredictionStrategy strategy;
+  ForestPredictor predictor = regression_predictor(4);
+
+  Forest forest = trainer.train(data, options_with_threads(1, 4, 20));
+  OOBPredictionAccumulator oob_accumulator(data.get_num_rows(), strategy.prediction_value_length());
+  oob_accumulator.add_trees(forest, 0, data, 4);
+
+  trainer.grow(forest, data, options_with_threads(1, 4, 60), oob_accumulator);
+  REQUIRE(forest.get_trees().size() == 60);
+
+  check_predictions_equal(predictor.predict_oob(forest, data, false),
+                          oob_accumulator.get_predictions(strategy));
+}
+
+TEST_CASE("OOB predictions can be computed during training", "[forest, training]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  RegressionPredictionStrategy strategy;
+  ForestPredictor predictor = regression_predictor(4);
+
+  OOBPredictionAccumulator oob_accumulator(data.get_num_rows(), strategy.prediction_value_length());
+  Forest forest = trainer.train(data, options_with_threads(2, 3), oob_accumulator);
+
+  check_forests_equal(trainer.train(data, options_with_threads(2, 3)), forest);
+  check_predictions_equal(predictor.predict_oob(forest, data, false),
+                          oob_accumulator.get_predictions(strategy));
+}
+
+TEST_CASE("OOB error estimates can be computed during training", "[forest, training]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  RegressionPredictionStrategy strategy;
+  ForestPredictor predictor = regression_predictor(4);
+
+  OOBPredictionAccumulator oob_accumulator(data.get_num_rows(), strategy.prediction_value_length(), true);
+  Forest forest = trainer.train(data, options_with_threads(1, 4, 50), oob_accumulator);
+
+  size_t num_samples = data.get_num_rows();
+  std::vector<double> predictions(num_samples);
+  std::vector<double> errors(num_samples);
+  std::vector<double> excess_errors(num_samples);
+  PredictionOutput output(num_samples, 1, predictions.data(), nullptr, errors.data(), excess_errors.data());
+  oob_accumulator.predict(strategy, data, output);
+
+  std::vector<Prediction> expected_predictions = predictor.predict_oob(forest, data, false);
+  for (size_t sample = 0; sample < num_samples; sample++) {
+    const Prediction& expected = expected_predictions[sample];
+    REQUIRE(equal_doubles(expected.get_predictions()[0], predictions[sample], 1e-10));
+    REQUIRE(equal_doubles(expected.get_error_estimates()[0], errors[sample], 1e-8));
+    REQUIRE(equal_doubles(expected.get_excess_error_estimates()[0], excess_errors[sample], 1e-8));
+  }
+
+  // Error estimates require the accumulated leaf value products.
+  OOBPredictionAccumulator sums_only(num_samples, strategy.prediction_value_length());
+  REQUIRE_THROWS_AS(sums_only.predict(strategy, data, output), const std::runtime_error&);
+}
+
+TEST_CASE("OOB error estimates during training are accurate for outcomes with a large offset", "[forest, training]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  size_t num_samples = data.get_num_rows();
+  for (size_t sample = 0; sample < num_samples; sample++) {
+    set_data(data_vec, sample, 10, data.get_outcome(sample) + 1e8);
+  }
+  Data offset_data(data_vec);
+  offset_data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  RegressionPredictionStrategy strategy;
+  ForestPredictor predictor = regression_predictor(4);
+
+  OOBPredictionAccumulator oob_accumulator(num_samples, strategy.prediction_value_length(), true);
+  Forest forest = trainer.train(offset_data, options_with_threads(1, 4, 50), oob_accumulator);
+
+  std::vector<double> predictions(num_samples);
+  std::vector<double> errors(num_samples);
+  std::vector<double> excess_errors(num_samples);
+  PredictionOutput output(num_samples, 1, predictions.data(), nullptr, errors.data(), excess_errors.data());
+  oob_accumulator.predict(strategy, offset_data, output);
+
+  // The excess errors are of the order of the outcome variance, 16 orders of magnitude
+  // below the squared leaf values.
+  std::vector<Prediction> expected_predictions = predictor.predict_oob(forest, offset_data, false);
+  for (size_t sample = 0; sample < num_samples; sample++) {
+    double expected = expected_predictions[sample].get_excess_error_estimates()[0];
+    if (std::isnan(expected)) {
+      REQUIRE(std::isnan(excess_errors[sample]));
+    } else {
+      REQUIRE(equal_doubles(expected, excess_errors[sample], 1e-6 * std::abs(expected)));
+    }
+  }
+}
+
+TEST_CASE("training until convergence stops early", "[forest, training]") {
+  auto data_vec = load_data("test/forest/resources/causal_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = options_with_threads(2, 4, 400);
+
+  Forest forest = trainer.train_until_converged(data, options, 19, 5e-2);
+  size_t num_trees = forest.get_trees().size();
+  REQUIRE(num_trees < 400);
+  REQUIRE(num_trees % 20 == 0);
+
+  // The converged forest holds the first trees of the full forest.
+  Forest expected_forest = trainer.train(data, options, 0, num_trees);
+  check_forests_equal(expected_forest, forest);
+
+  // A stricter tolerance requires more trees.
+  Forest strict_forest = trainer.train_until_converged(data, options, 20, 2e-2);
+  REQUIRE(strict_forest.get_trees().size() > num_trees);
+
+  Forest full_forest = trainer.train_until_converged(data, options_with_threads(2, 4, 60), 20, 0.0);
+  REQUIRE(full_forest.get_trees().size() == 60);
+}
+
+TEST_CASE("training until convergence requires precomputed prediction values", "[forest, training]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = quantile_trainer({0.5});
+  ForestOptions options = options_with_threads(1, 4, 50);
+
+  REQUIRE_THROWS(trainer.train_until_converged(data, options, 10, 1e-2));
+  REQUIRE_THROWS(regression_trainer().train_until_converged(data, options, 0, 1e-2));
+}
@@ -15,6 +15,8 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <cmath>
+
 #include "commons/Data.h"
 #include "commons/utility.h"
 #include "prediction/InstrumentalPredictionStrategy.h"
@@ -49,7 +51,7 @@ TEST_CASE("instrumental variance estimates are positive", "[regression, predicti
 
   InstrumentalPredictionStrategy prediction_strategy;
   std::vector<double> variance = prediction_strategy.compute_variance(
-      averages, PredictionValues(leaf_values, 5), 2);
+      averages, LeafValueMoments(PredictionValues(leaf_values, 7), 2));
 
   REQUIRE(variance.size() == 1);
   REQUIRE(variance[0] > 0);
@@ -66,13 +68,9 @@ TEST_CASE("scaling outcome scales instrumental variance", "[instrumental, predic
 
   InstrumentalPredictionStrategy prediction_strategy;
   std::vector<double> first_variance = prediction_strategy.compute_variance(
-      averages,
-      PredictionValues(leaf_values, 5),
-      2);
+      averages, LeafValueMoments(PredictionValues(leaf_values, 7), 2));
   std::vector<double> second_variance = prediction_strategy.compute_variance(
-      scaled_average,
-      PredictionValues(scaled_leaf_values, 5),
-      2);
+      scaled_average, LeafValueMoments(PredictionValues(scaled_leaf_values, 7), 2));
 
   REQUIRE(first_variance.size() == 1);
   REQUIRE(second_variance.size() == 1);
@@ -102,10 +100,61 @@ TEST_CASE("monte carlo errors are nonzero", "[instrumental, prediction]") {
   auto errors = prediction_strategy.compute_error(
     sample,
     average,
-    PredictionValues(leaf_values, 3),
+    PredictionValues(leaf_values, 7),
     data);
 
   double mc_error = errors[0].second;
 
   REQUIRE(mc_error > 0);
 }
+
+TEST_CASE("streamed instrumental errors approximate the exact jackknife", "[instrumental, prediction]") {
+  std::vector<double> center = {2.0, 1.0, 1.5, 3.0, 2.5, 1.5, 1.0};
+  std::vector<std::vector<double>> deviations = {
+    {2, 1, 1, 2, 1, 2, 0}, {4, 2, 2, 4, 2, 1, 0}, {-4, -3, 5, -6, -1, 0, 0},
+    {2, 0, 1, 4, 1, 0, 0}, {2, 0, 1, 4, 1, 3, 0}, {2, 0, 1, 3, 4, 1, 0},
+    {-3, 1, -2, -1, 0, -2, 0}, {1, -2, 0, 2, -3, 1, 0}
+  };
+
+  // Leaf values close to each other, so that the first-order expansion is accurate.
+  size_t num_types = center.size();
+  std::vector<std::vector<double>> leaf_values;
+  std::vector<double> average(num_types, 0.0);
+  for (const std::vector<double>& deviation : deviations) {
+    std::vector<double> values(num_types);
+    for (size_t type = 0; type < num_types; type++) {
+      values[type] = center[type] + 0.01 * deviation[type];
+      average[type] += values[type] / deviations.size();
+    }
+    leaf_values.push_back(values);
+  }
+  std::vector<double> centered_products(num_types * num_types, 0.0);
+  for (const std::vector<double>& values : leaf_values) {
+    for (size_t i = 0; i < num_types; i++) {
+      for (size_t j = 0; j < num_types; j++) {
+        centered_products[i * num_types + j] += (values[i] - average[i]) * (values[j] - average[j]);
+      }
+    }
+  }
+
+  std::vector<double> outcomes = {6.4, 1.0, 1.4, 1.0, 0.0, 1.6,
+                                  1.4, 2.0, 2.4, 2.0, 1.0, 5.5};
+  Data data(outcomes, 2, 6);
+  data.set_outcome_index(0);
+  data.set_instrument_index(1);
+  data.set_treatment_index(1);
+  InstrumentalPredictionStrategy prediction_strategy;
+
+  auto exact = prediction_strategy.compute_error(
+      0, average, PredictionValues(leaf_values, num_types), data);
+  auto streamed = prediction_strategy.compute_error(
+      0, average, centered_products, deviations.size(), data);
+
+  REQUIRE(exact[0].second > 0);
+  REQUIRE(equal_doubles(exact[0].second, streamed[0].second, 1e-2 * exact[0].second));
+  REQUIRE(equal_doubles(exact[0].first, streamed[0].first, 1e-2 * exact[0].second));
+
+  // Too few trees do not give an error estimate.
+  auto few_trees = prediction_strategy.compute_error(0, average, centered_products, 5, data);
+  REQUIRE(std::isnan(few_trees[0].first));
+}
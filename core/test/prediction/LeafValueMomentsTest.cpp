@@ -0,0 +1,102 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <random>
+
+#include "catch.hpp"
+#include "commons/utility.h"
+#include "prediction/LeafValueMoments.h"
+
+using namespace grf;
+
+TEST_CASE("leaf value moments match direct per-group sums", "[prediction, unit]") {
+  // Second moments are accumulated for 3 types, and the leaf values are kept for 9.
+  for (size_t num_types : {3, 9}) {
+    size_t ci_group_size = 2;
+    size_t num_trees = 41;
+
+    std::mt19937_64 random_number_generator(42);
+    std::normal_distribution<double> normal(100.0, 5.0);
+
+    // Make a few trees empty, so that their groups are excluded.
+    std::vector<std::vector<double>> values(num_trees);
+    for (size_t tree = 0; tree < num_trees; tree++) {
+      if (tree % 7 == 3) {
+        continue;
+      }
+      for (size_t type = 0; type < num_types; type++) {
+        values[tree].push_back(normal(random_number_generator));
+      }
+    }
+    PredictionValues leaf_values(values, num_types);
+    LeafValueMoments moments(leaf_values, ci_group_size);
+
+    std::vector<double> coefficients(num_types);
+    for (size_t type = 0; type < num_types; type++) {
+      coefficients[type] = (type % 2 == 0 ? 0.5 : -0.25) / (type + 1);
+    }
+
+    double num_good_groups = 0;
+    double sum_of_squares = 0;
+    double sum_of_group_squares = 0;
+    for (size_t group = 0; group < num_trees / ci_group_size; group++) {
+      bool good_group = true;
+      for (size_t j = 0; j < ci_group_size; j++) {
+        good_group = good_group && !leaf_values.empty(group * ci_group_size + j);
+      }
+      if (!good_group) {
+        continue;
+      }
+
+      num_good_groups++;
+      double group_score = 0;
+      for (size_t j = 0; j < ci_group_size; j++) {
+        double score = 0;
+        for (size_t type = 0; type < num_types; type++) {
+          score += coefficients[type] * leaf_values.get(group * ci_group_size + j, type);
+        }
+        sum_of_squares += score * score;
+        group_score += score;
+      }
+      group_score /= ci_group_size;
+      sum_of_group_squares += group_score * group_score;
+    }
+
+    REQUIRE(moments.get_num_good_groups() == num_good_groups);
+    REQUIRE(equal_doubles(moments.get_sum_of_squares(coefficients), sum_of_squares, 1e-8 * sum_of_squares));
+    REQUIRE(equal_doubles(moments.get_sum_of_group_squares(coefficients), sum_of_group_squares,
+                          1e-8 * sum_of_group_squares));
+  }
+}
+
+TEST_CASE("cleared leaf value moments start from scratch", "[prediction, unit]") {
+  LeafValueMoments moments(1, 2);
+  double first = 1.0;
+  double second = 3.0;
+
+  moments.add(&first);
+  moments.add(&second);
+  REQUIRE(moments.get_num_good_groups() == 1);
+  REQUIRE(equal_doubles(moments.get_sum_of_squares({1.0}), 10.0, 1e-12));
+  REQUIRE(equal_doubles(moments.get_sum_of_group_squares({1.0}), 4.0, 1e-12));
+
+  moments.clear();
+  moments.add(&second);
+  moments.add_empty();
+  REQUIRE(moments.get_num_good_groups() == 0);
+  REQUIRE(moments.get_sum_of_squares({1.0}) == 0);
+}
@@ -192,8 +192,8 @@ TEST_CASE("multi causal variance estimates with one continuous treatment is iden
     if (prediction_values.empty(i)) {
       REQUIRE(multi_prediction_values.empty(i));
     } else {
-      std::vector<double> prediction = prediction_strategy.compute_variance(prediction_values.get_values(i), prediction_values, 2);
-      std::vector<double> prediction_multi = multi_prediction_strategy.compute_variance(multi_prediction_values.get_values(i), multi_prediction_values, 2);
+      std::vector<double> prediction = prediction_strategy.compute_variance(prediction_values.get_values(i), LeafValueMoments(prediction_values, 2));
+      std::vector<double> prediction_multi = multi_prediction_strategy.compute_variance(multi_prediction_values.get_values(i), LeafValueMoments(multi_prediction_values, 2));
       REQUIRE(prediction.size() == prediction_multi.size());
       REQUIRE(equal_doubles(prediction[0], prediction_multi[0], 1e-5));
     }
@@ -240,8 +240,8 @@ TEST_CASE("sample weighted multi causal variance estimates with one continuous t
     if (prediction_values.empty(i)) {
       REQUIRE(multi_prediction_values.empty(i));
     } else {
-      std::vector<double> prediction = prediction_strategy.compute_variance(prediction_values.get_values(i), prediction_values, 2);
-      std::vector<double> prediction_multi = multi_prediction_strategy.compute_variance(multi_prediction_values.get_values(i), multi_prediction_values, 2);
+      std::vector<double> prediction = prediction_strategy.compute_variance(prediction_values.get_values(i), LeafValueMoments(prediction_values, 2));
+      std::vector<double> prediction_multi = multi_prediction_strategy.compute_variance(multi_prediction_values.get_values(i), LeafValueMoments(multi_prediction_values, 2));
       REQUIRE(prediction.size() == prediction_multi.size());
       REQUIRE(equal_doubles(prediction[0], prediction_multi[0], 1e-5));
     }
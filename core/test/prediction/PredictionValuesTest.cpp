@@ -0,0 +1,48 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "catch.hpp"
+#include "prediction/PredictionValues.h"
+
+using namespace grf;
+
+TEST_CASE("prediction values are stored contiguously by leaf", "[prediction, unit]") {
+  std::vector<std::vector<double>> values = {{}, {1, 2, 3}, {}, {4, 5, 6}};
+  PredictionValues prediction_values(values, 3);
+
+  REQUIRE(prediction_values.get_num_nodes() == 4);
+  REQUIRE(prediction_values.get_num_types() == 3);
+  REQUIRE(prediction_values.get_slots() ==
+          std::vector<size_t>({PredictionValues::EMPTY_SLOT, 0, PredictionValues::EMPTY_SLOT, 1}));
+  REQUIRE(prediction_values.get_flat_values() == std::vector<double>({1, 2, 3, 4, 5, 6}));
+
+  REQUIRE(prediction_values.empty(0));
+  REQUIRE(!prediction_values.empty(1));
+  REQUIRE(prediction_values.get(3, 1) == 5);
+  REQUIRE(prediction_values.get_data(3) == prediction_values.get_data(1) + 3);
+  REQUIRE(prediction_values.get_values(2).empty());
+  REQUIRE(prediction_values.get_all_values() == values);
+
+  PredictionValues flat_prediction_values(prediction_values.get_slots(),
+                                          prediction_values.get_flat_values(), 3);
+  REQUIRE(flat_prediction_values.get_all_values() == values);
+}
+
+TEST_CASE("prediction values reject inconsistent lengths", "[prediction, unit]") {
+  REQUIRE_THROWS(PredictionValues({{1, 2}, {3}}, 2));
+  REQUIRE_THROWS(PredictionValues({0, 2}, {1, 2, 3, 4}, 2));
+}
@@ -0,0 +1,77 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+
+#include "commons/utility.h"
+#include "prediction/RidgePathSolver.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+Eigen::MatrixXd random_gram_matrix(size_t dim) {
+  Eigen::MatrixXd X = Eigen::MatrixXd::Random(4 * dim, dim);
+  X.col(0).setOnes();
+  return X.transpose() * X / (4 * dim);
+}
+
+Eigen::VectorXd ridge_solve(const Eigen::MatrixXd& M,
+                            const Eigen::VectorXd& rhs,
+                            const std::vector<size_t>& unpenalized_indices,
+                            bool weight_penalty,
+                            double lambda) {
+  Eigen::MatrixXd penalized = M;
+  double normalization = M.trace() / M.rows();
+  for (size_t j = 0; j < (size_t) M.rows(); j++) {
+    if (std::find(unpenalized_indices.begin(), unpenalized_indices.end(), j) != unpenalized_indices.end()) {
+      continue;
+    }
+    penalized(j, j) += weight_penalty ? lambda * M(j, j) : lambda * normalization;
+  }
+  return penalized.ldlt().solve(rhs);
+}
+
+TEST_CASE("ridge path solver matches a direct solve with the standard penalty", "[local linear], [prediction]") {
+  Eigen::MatrixXd M = random_gram_matrix(5);
+  Eigen::VectorXd rhs = Eigen::VectorXd::Random(5);
+  std::vector<size_t> unpenalized = {0};
+
+  RidgePathSolver solver(M, unpenalized, false);
+  for (double lambda : {0.0, 0.01, 0.1, 1.0, 10.0}) {
+    Eigen::VectorXd expected = ridge_solve(M, rhs, unpenalized, false, lambda);
+    Eigen::VectorXd actual = solver.solve(rhs, lambda);
+    for (size_t j = 0; j < 5; j++) {
+      REQUIRE(equal_doubles(expected(j), actual(j), 1e-8));
+    }
+  }
+}
+
+TEST_CASE("ridge path solver matches a direct solve with the covariance penalty", "[local linear], [prediction]") {
+  Eigen::MatrixXd M = random_gram_matrix(7);
+  Eigen::VectorXd rhs = Eigen::VectorXd::Random(7);
+  std::vector<size_t> unpenalized = {0, 3};
+
+  RidgePathSolver solver(M, unpenalized, true);
+  for (double lambda : {0.0, 0.01, 0.1, 1.0, 10.0}) {
+    Eigen::VectorXd expected = ridge_solve(M, rhs, unpenalized, true, lambda);
+    Eigen::VectorXd actual = solver.solve(rhs, lambda);
+    for (size_t j = 0; j < 7; j++) {
+      REQUIRE(equal_doubles(expected(j), actual(j), 1e-8));
+    }
+  }
+}
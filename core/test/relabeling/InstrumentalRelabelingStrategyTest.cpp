@@ -24,7 +24,7 @@ using namespace grf;
 
 std::vector<double> get_relabeled_outcomes(
   std::vector<double> observations, size_t num_samples, bool use_sample_weights=false) {
-  Data data(observations, num_samples, 3);
+  Data data(observations, num_samples, observations.size() / num_samples);
   data.set_outcome_index(0);
   data.set_treatment_index(1);
   data.set_instrument_index(2);
@@ -39,7 +39,7 @@ std::vector<double> get_relabeled_outcomes(
 
   std::unique_ptr<RelabelingStrategy> relabeling_strategy(new InstrumentalRelabelingStrategy());
 
-  Eigen::ArrayXXd relabeled_observations(num_samples, 1);
+  RowMajorArrayXXd relabeled_observations(num_samples, 1);
   bool stop = relabeling_strategy->relabel(samples, data, relabeled_observations);
   if (stop) {
     return std::vector<double>();
@@ -47,8 +47,8 @@ std::vector<double> get_relabeled_outcomes(
 
   std::vector<double> relabeled_outcomes;
   relabeled_outcomes.reserve(samples.size());
-  for (auto& sample : samples) {
-    relabeled_outcomes.push_back(relabeled_observations(sample));
+  for (size_t i = 0; i < samples.size(); ++i) {
+    relabeled_outcomes.push_back(relabeled_observations(i));
   }
   return relabeled_outcomes;
 }
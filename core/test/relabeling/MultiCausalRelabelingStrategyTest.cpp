@@ -38,7 +38,7 @@ Eigen::ArrayXXd get_relabeled_outcomes(
 
   std::unique_ptr<RelabelingStrategy> relabeling_strategy(new MultiCausalRelabelingStrategy(num_treatments));
 
-  Eigen::ArrayXXd relabeled_observations(num_samples, num_treatments);
+  RowMajorArrayXXd relabeled_observations(num_samples, num_treatments);
   bool stop = relabeling_strategy->relabel(samples, data, relabeled_observations);
   if (stop) {
     return Eigen::ArrayXXd(0, 0);
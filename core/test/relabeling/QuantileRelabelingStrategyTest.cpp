@@ -34,13 +34,13 @@ TEST_CASE("simple quantile relabeling", "[quantile, relabeling]") {
 
   QuantileRelabelingStrategy relabeling_strategy({0.25, 0.5, 0.75});
 
-  Eigen::ArrayXXd relabeled_observations(data.get_num_rows(), 1);
+  RowMajorArrayXXd relabeled_observations(samples.size(), 1);
   bool stop = relabeling_strategy.relabel(samples, data, relabeled_observations);
   REQUIRE(stop == false);
 
   std::vector<double> relabeled_outcomes;
-  for (auto& sample : samples) {
-    relabeled_outcomes.push_back(relabeled_observations(sample));
+  for (size_t i = 0; i < samples.size(); ++i) {
+    relabeled_outcomes.push_back(relabeled_observations(i));
   }
 
   std::vector<double> expected_outcomes = {0, 0, 3, 1, 2, 1, 0, 2, 2, 3};
@@ -57,13 +57,13 @@ TEST_CASE("quantile relabeling subset of observations", "[quantile, relabeling]"
 
   QuantileRelabelingStrategy relabeling_strategy({0.5, 0.75});
 
-  Eigen::ArrayXXd relabeled_observations(data.get_num_rows(), 1);
+  RowMajorArrayXXd relabeled_observations(samples.size(), 1);
   bool stop = relabeling_strategy.relabel(samples, data, relabeled_observations);
   REQUIRE(stop == false);
 
   std::vector<double> relabeled_outcomes;
-  for (auto& sample : samples) {
-    relabeled_outcomes.push_back(relabeled_observations(sample));
+  for (size_t i = 0; i < samples.size(); ++i) {
+    relabeled_outcomes.push_back(relabeled_observations(i));
   }
 
   std::vector<double> expected_outcomes = {1, 0, 2, 0, 0};
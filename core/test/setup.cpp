@@ -1,2 +1,3 @@
 #define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#define CATCH_CONFIG_NO_POSIX_SIGNALS  // SIGSTKSZ is no longer a compile-time constant in recent glibc
 #include "catch.hpp"
\ No newline at end of file
@@ -37,12 +37,16 @@ std::vector<double> run_splits(const Data& data,
                                size_t num_features) {
   size_t node = 0;
   size_t size_node = data.get_num_rows();
-  Eigen::ArrayXXd responses_by_sample(size_node, data.get_num_outcomes());
+  RowMajorArrayXXd responses_by_sample(size_node, data.get_num_outcomes());
   std::vector<std::vector<size_t>> samples(1);
   for (size_t sample = 0; sample < size_node; ++sample) {
     samples[node].push_back(sample);
   }
   relabeling_strategy->relabel(samples[node], data, responses_by_sample);
+  std::vector<double> weights_by_sample(size_node);
+  for (size_t i = 0; i < size_node; ++i) {
+    weights_by_sample[i] = data.get_weight(samples[node][i]);
+  }
 
   std::vector<size_t> possible_split_vars;
   for (size_t j = 0; j < num_features; j++) {
@@ -56,6 +60,7 @@ std::vector<double> run_splits(const Data& data,
                                   node,
                                   possible_split_vars,
                                   responses_by_sample,
+                                  weights_by_sample,
                                   samples,
                                   split_vars,
                                   split_values,
@@ -15,13 +15,20 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <cmath>
+#include <functional>
+
+#include "Eigen/Sparse"
 #include "splitting/factory/InstrumentalSplittingRuleFactory.h"
+#include "splitting/factory/MultiCausalSplittingRuleFactory.h"
+#include "splitting/factory/MultiRegressionSplittingRuleFactory.h"
 #include "splitting/factory/ProbabilitySplittingRuleFactory.h"
 #include "splitting/factory/RegressionSplittingRuleFactory.h"
 #include "splitting/factory/SurvivalSplittingRuleFactory.h"
 #include "splitting/factory/CausalSurvivalSplittingRuleFactory.h"
 #include "relabeling/NoopRelabelingStrategy.h"
 #include "relabeling/InstrumentalRelabelingStrategy.h"
+#include "relabeling/MultiCausalRelabelingStrategy.h"
 #include "relabeling/QuantileRelabelingStrategy.h"
 #include "relabeling/CausalSurvivalRelabelingStrategy.h"
 
@@ -45,12 +52,16 @@ void run_one_split(const Data& data,
   std::iota(possible_split_vars.begin(), possible_split_vars.end(), 0);
   size_t node = 0;
   size_t size_node = data.get_num_rows();
-  Eigen::ArrayXXd responses_by_sample(size_node, 1);
+  RowMajorArrayXXd responses_by_sample(size_node, 1);
   std::vector<std::vector<size_t>> samples(1);
   for (size_t sample = 0; sample < size_node; ++sample) {
     samples[node].push_back(sample);
   }
   relabeling_strategy->relabel(samples[node], data, responses_by_sample);
+  std::vector<double> weights_by_sample(size_node);
+  for (size_t i = 0; i < size_node; ++i) {
+    weights_by_sample[i] = data.get_weight(samples[node][i]);
+  }
 
   std::vector<size_t> split_vars(1);
   std::vector<double> split_values(1);
@@ -60,6 +71,7 @@ void run_one_split(const Data& data,
                                  node,
                                  possible_split_vars,
                                  responses_by_sample,
+                                 weights_by_sample,
                                  samples,
                                  split_vars,
                                  split_values,
@@ -217,3 +229,94 @@ TEST_CASE("causal survival splitting on Xij then setting all values to the left
   REQUIRE(split_var == split_var_nan);
   REQUIRE(split_val == split_val_nan);
 }
+
+// Splits node zero on the covariates of `data_vec` with magnitude at least one, stored both
+// as dense columns and in compressed sparse column format, and checks that the splits match.
+void check_sparse_split(std::pair<std::vector<double>, std::vector<size_t>> data_vec,
+                        size_t num_features,
+                        const std::function<void(Data&)>& set_indices,
+                        const std::unique_ptr<SplittingRuleFactory>& splitting_rule_factory,
+                        const std::unique_ptr<RelabelingStrategy>& relabeling_strategy) {
+  size_t num_rows = data_vec.second[0];
+  size_t num_cols = data_vec.second[1];
+  for (size_t i = 0; i < num_rows * num_features; i++) {
+    if (std::abs(data_vec.first[i]) < 1) {
+      data_vec.first[i] = 0;
+    }
+  }
+  Eigen::Map<const Eigen::MatrixXd> covariates(data_vec.first.data(), num_rows, num_features);
+  Eigen::SparseMatrix<double> sparse_covariates = covariates.sparseView();
+  sparse_covariates.makeCompressed();
+  std::vector<const double*> columns;
+  for (size_t col = num_features; col < num_cols; col++) {
+    columns.push_back(data_vec.first.data() + col * num_rows);
+  }
+
+  Data dense_data(data_vec);
+  Data sparse_data(sparse_covariates.valuePtr(), sparse_covariates.innerIndexPtr(),
+                   sparse_covariates.outerIndexPtr(), num_features, columns, num_rows);
+  set_indices(dense_data);
+  set_indices(sparse_data);
+  REQUIRE(sparse_data.get_num_sparse_cols() == num_features);
+
+  TreeOptions options = ForestTestUtilities::default_options().get_tree_options();
+  size_t split_var, split_var_sparse;
+  double split_val, split_val_sparse;
+  run_one_split(dense_data, options, splitting_rule_factory, relabeling_strategy, num_features,
+                split_var, split_val);
+  run_one_split(sparse_data, options, splitting_rule_factory, relabeling_strategy, num_features,
+                split_var_sparse, split_val_sparse);
+  REQUIRE(split_var == split_var_sparse);
+  REQUIRE(split_val == split_val_sparse);
+}
+
+TEST_CASE("splitting on sparse covariates yields the same split as on dense covariates", "[sparse], [splitting]") {
+  auto regression_data = load_data("test/forest/resources/regression_data.csv");
+  auto set_regression_indices = [](Data& data) {
+    data.set_outcome_index(10);
+  };
+  check_sparse_split(regression_data, 10, set_regression_indices,
+                     std::unique_ptr<SplittingRuleFactory>(new RegressionSplittingRuleFactory()),
+                     std::unique_ptr<RelabelingStrategy>(new NoopRelabelingStrategy()));
+  check_sparse_split(regression_data, 10, set_regression_indices,
+                     std::unique_ptr<SplittingRuleFactory>(new MultiRegressionSplittingRuleFactory(1)),
+                     std::unique_ptr<RelabelingStrategy>(new NoopRelabelingStrategy()));
+
+  auto causal_data = load_data("test/forest/resources/causal_data.csv");
+  auto set_causal_indices = [](Data& data) {
+    data.set_outcome_index(10);
+    data.set_treatment_index(11);
+    data.set_instrument_index(11);
+  };
+  check_sparse_split(causal_data, 10, set_causal_indices,
+                     std::unique_ptr<SplittingRuleFactory>(new InstrumentalSplittingRuleFactory()),
+                     std::unique_ptr<RelabelingStrategy>(new InstrumentalRelabelingStrategy(0.0)));
+  check_sparse_split(causal_data, 10, set_causal_indices,
+                     std::unique_ptr<SplittingRuleFactory>(new MultiCausalSplittingRuleFactory(1, 1)),
+                     std::unique_ptr<RelabelingStrategy>(new MultiCausalRelabelingStrategy(1)));
+
+  std::vector<double> quantiles({0.25, 0.5, 0.75});
+  check_sparse_split(load_data("test/forest/resources/quantile_data.csv"), 10,
+                     [](Data& data) { data.set_outcome_index(10); },
+                     std::unique_ptr<SplittingRuleFactory>(new ProbabilitySplittingRuleFactory(quantiles.size() + 1)),
+                     std::unique_ptr<RelabelingStrategy>(new QuantileRelabelingStrategy(quantiles)));
+
+  check_sparse_split(load_data("test/forest/resources/survival_data_MIA.csv"), 5,
+                     [](Data& data) {
+                       data.set_outcome_index(5);
+                       data.set_censor_index(6);
+                     },
+                     std::unique_ptr<SplittingRuleFactory>(new SurvivalSplittingRuleFactory()),
+                     std::unique_ptr<RelabelingStrategy>(new NoopRelabelingStrategy()));
+
+  check_sparse_split(load_data("test/forest/resources/causal_survival_data.csv"), 5,
+                     [](Data& data) {
+                       data.set_treatment_index(5);
+                       data.set_instrument_index(5);
+                       data.set_censor_index(6);
+                       data.set_causal_survival_numerator_index(7);
+                       data.set_causal_survival_denominator_index(8);
+                     },
+                     std::unique_ptr<SplittingRuleFactory>(new CausalSurvivalSplittingRuleFactory()),
+                     std::unique_ptr<RelabelingStrategy>(new CausalSurvivalRelabelingStrategy()));
+}
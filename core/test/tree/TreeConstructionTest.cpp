@@ -0,0 +1,76 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "catch.hpp"
+#include "prediction/Prediction.h"
+#include "tree/Tree.h"
+
+using namespace grf;
+
+/*
+ * These tests check that building a tree hands over the storage of its arguments
+ * rather than copying it: a moved-from vector's buffer must end up inside the tree.
+ */
+TEST_CASE("trees take ownership of moved arguments", "[tree, unit]") {
+  std::vector<std::vector<size_t>> child_nodes = {{1, 0, 0}, {2, 0, 0}};
+  std::vector<std::vector<size_t>> leaf_samples = {{}, {0, 2}, {1, 3}};
+  std::vector<size_t> split_vars = {0, 0, 0};
+  std::vector<double> split_values = {0.5, 0, 0};
+  std::vector<double> values = {1.0, 2.0, 3.0, 4.0};
+
+  const size_t* left_children = child_nodes[0].data();
+  const size_t* leaf = leaf_samples[1].data();
+  const size_t* vars = split_vars.data();
+  const double* split_value_data = split_values.data();
+  const double* leaf_values = values.data();
+
+  Tree tree(0, std::move(child_nodes), std::move(leaf_samples), std::move(split_vars),
+            std::move(split_values), {0, 1, 2, 3}, {true, true, true},
+            PredictionValues({PredictionValues::EMPTY_SLOT, 0, 1}, std::move(values), 2));
+
+  REQUIRE(tree.get_child_nodes()[0].data() == left_children);
+  REQUIRE(tree.get_leaf_samples()[1].data() == leaf);
+  REQUIRE(tree.get_split_vars().data() == vars);
+  REQUIRE(tree.get_split_values().data() == split_value_data);
+  REQUIRE(tree.get_prediction_values().get_data(2) == leaf_values + 2);
+  REQUIRE(tree.get_prediction_values().get_num_nodes() == 3);
+}
+
+TEST_CASE("tree setters take ownership of moved arguments", "[tree, unit]") {
+  Tree tree(0, {{0}, {0}}, {{0}}, {0}, {0}, {0}, {true}, PredictionValues());
+
+  std::vector<std::vector<size_t>> leaf_samples = {{4, 5, 6}};
+  const size_t* leaf = leaf_samples[0].data();
+  tree.set_leaf_samples(std::move(leaf_samples));
+  REQUIRE(tree.get_leaf_samples()[0].data() == leaf);
+
+  std::vector<double> values = {7.0};
+  const double* leaf_values = values.data();
+  tree.set_prediction_values(PredictionValues({0}, std::move(values), 1));
+  REQUIRE(tree.get_prediction_values().get_data(0) == leaf_values);
+}
+
+TEST_CASE("predictions take ownership of moved estimates", "[prediction, unit]") {
+  std::vector<double> point_prediction = {1.0};
+  std::vector<double> variance = {2.0};
+  const double* point_prediction_data = point_prediction.data();
+  const double* variance_data = variance.data();
+
+  Prediction prediction(std::move(point_prediction), std::move(variance), {}, {});
+  REQUIRE(prediction.get_predictions().data() == point_prediction_data);
+  REQUIRE(prediction.get_variance_estimates().data() == variance_data);
+}
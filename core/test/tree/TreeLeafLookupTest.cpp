@@ -0,0 +1,52 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "catch.hpp"
+#include "tree/Tree.h"
+
+using namespace grf;
+
+TEST_CASE("leaf lookup into a compact buffer matches the sample-indexed lookup", "[tree, unit]") {
+  /*
+   * A tree with a single split on the first column at 0.5:
+   *
+   *       0
+   *      / \
+   *     1   2
+   */
+  std::vector<std::vector<size_t>> child_nodes = {{1, 0, 0}, {2, 0, 0}};
+  std::vector<std::vector<size_t>> leaf_samples = {{}, {0, 2}, {1, 3}};
+  Tree tree(0, child_nodes, leaf_samples, {0, 0, 0}, {0.5, 0, 0}, {0, 1, 2, 3}, {true, true, true},
+            PredictionValues());
+
+  std::vector<double> values = {0.1, 0.9, 0.2, 0.8, 0.7, 0.3};
+  Data data(values, 6, 1);
+
+  std::vector<size_t> samples = {5, 1, 4};
+  std::vector<size_t> leaf_nodes = {42, 42, 42, 42, 42, 42, 42};
+  tree.find_leaf_nodes(data, samples, leaf_nodes);
+
+  REQUIRE(leaf_nodes == std::vector<size_t>({1, 2, 2}));
+
+  std::vector<size_t> indexed_leaf_nodes = tree.find_leaf_nodes(data, samples);
+  for (size_t i = 0; i < samples.size(); i++) {
+    REQUIRE(leaf_nodes[i] == indexed_leaf_nodes[samples[i]]);
+  }
+
+  tree.find_leaf_nodes(data, std::vector<size_t>(), leaf_nodes);
+  REQUIRE(leaf_nodes.empty());
+}
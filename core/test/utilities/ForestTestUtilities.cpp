@@ -15,9 +15,12 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include "commons/utility.h"
 #include "utilities/ForestTestUtilities.h"
 #include "forest/ForestTrainer.h"
 
+#include "catch.hpp"
+
 ForestOptions ForestTestUtilities::default_options() {
   return default_options(false, 1);
 }
@@ -27,7 +30,8 @@ ForestOptions ForestTestUtilities::default_honest_options() {
 }
 
 ForestOptions ForestTestUtilities::default_options(bool honesty,
-                                                   size_t ci_group_size) {
+                                                   size_t ci_group_size,
+                                                   bool store_leaf_samples) {
   double honesty_fraction = 0.5;
   bool prune = true;
   uint num_trees = 50;
@@ -43,5 +47,21 @@ ForestOptions ForestTestUtilities::default_options(bool honesty,
 
   return ForestOptions(num_trees,
           ci_group_size, sample_fraction, mtry, min_node_size, honesty, honesty_fraction,
-      prune, alpha, imbalance_penalty, num_threads, seed, empty_clusters, samples_per_cluster);
+      prune, alpha, imbalance_penalty, num_threads, seed, empty_clusters, samples_per_cluster, store_leaf_samples);
+}
+
+void ForestTestUtilities::check_trees_equal(const Tree& first, const Tree& second) {
+  REQUIRE(first.get_root_node() == second.get_root_node());
+  REQUIRE(first.get_child_nodes() == second.get_child_nodes());
+  REQUIRE(first.get_leaf_samples() == second.get_leaf_samples());
+  REQUIRE(first.get_split_vars() == second.get_split_vars());
+  REQUIRE(first.get_split_values().size() == second.get_split_values().size());
+  for (size_t i = 0; i < first.get_split_values().size(); i++) {
+    REQUIRE(equal_doubles(first.get_split_values()[i], second.get_split_values()[i], 1e-15));
+  }
+  REQUIRE(first.get_drawn_samples() == second.get_drawn_samples());
+  REQUIRE(first.get_send_missing_left() == second.get_send_missing_left());
+  REQUIRE(first.get_prediction_values().get_num_nodes() == second.get_prediction_values().get_num_nodes());
+  REQUIRE(first.get_prediction_values().get_num_types() == second.get_prediction_values().get_num_types());
+  REQUIRE(first.get_prediction_values().get_all_values() == second.get_prediction_values().get_all_values());
 }
@@ -27,7 +27,9 @@ public:
   static ForestOptions default_options();
   static ForestOptions default_honest_options();
 
-  static ForestOptions default_options(bool honesty, size_t ci_group_size);
+  static ForestOptions default_options(bool honesty, size_t ci_group_size, bool store_leaf_samples = true);
+
+  static void check_trees_equal(const Tree& first, const Tree& second);
 };
 
 #endif //GRF_FORESTTESTUTILITIES_H
@@ -32,7 +32,8 @@ using namespace grf;
 // [[Rcpp::export]]
 Rcpp::NumericMatrix compute_split_frequencies(const Rcpp::List& forest_object,
                                               size_t max_depth) {
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   SplitFrequencyComputer computer;
   std::vector<std::vector<size_t>> split_frequencies = computer.compute(forest, max_depth);
@@ -51,12 +52,14 @@ Rcpp::NumericMatrix compute_split_frequencies(const Rcpp::List& forest_object,
 
 Eigen::SparseMatrix<double> compute_sample_weights(const Rcpp::List& forest_object,
                                                    const Rcpp::NumericMatrix& train_matrix,
+                                                   const Rcpp::NumericMatrix& response_matrix,
                                                    const Rcpp::NumericMatrix& test_matrix,
                                                    unsigned int num_threads,
                                                    bool oob_prediction) {
-  Data train_data = RcppUtilities::convert_data(train_matrix);
+  Data train_data = RcppUtilities::convert_data(train_matrix, response_matrix);
   Data data = RcppUtilities::convert_data(test_matrix);
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
   num_threads = ForestOptions::validate_num_threads(num_threads);
 
   TreeTraverser tree_traverser(num_threads);
@@ -91,29 +94,23 @@ Eigen::SparseMatrix<double> compute_sample_weights(const Rcpp::List& forest_obje
 // [[Rcpp::export]]
 Eigen::SparseMatrix<double> compute_weights(const Rcpp::List& forest_object,
                                             const Rcpp::NumericMatrix& train_matrix,
+                                            const Rcpp::NumericMatrix& response_matrix,
                                             const Rcpp::NumericMatrix& test_matrix,
                                             unsigned int num_threads) {
-  return compute_sample_weights(forest_object, train_matrix,
+  return compute_sample_weights(forest_object, train_matrix, response_matrix,
                                 test_matrix, num_threads, false);
 }
 
 // [[Rcpp::export]]
 Eigen::SparseMatrix<double> compute_weights_oob(const Rcpp::List& forest_object,
                                                 const Rcpp::NumericMatrix& train_matrix,
+                                                const Rcpp::NumericMatrix& response_matrix,
                                                 unsigned int num_threads) {
-  return compute_sample_weights(forest_object, train_matrix,
+  return compute_sample_weights(forest_object, train_matrix, response_matrix,
                                 train_matrix, num_threads, true);
 }
 
 // [[Rcpp::export]]
 Rcpp::List merge(const Rcpp::List& forest_objects) {
- std::vector<Forest> forests;
-
- for (auto& forest_obj : forest_objects) {
-   Forest deserialized_forest = RcppUtilities::deserialize_forest(forest_obj);
-   forests.push_back(std::move(deserialized_forest));
- }
-
-  Forest big_forest = Forest::merge(forests);
-  return RcppUtilities::serialize_forest(big_forest);
+  return RcppUtilities::merge_forest_objects(forest_objects);
 }
@@ -27,6 +27,7 @@ using namespace grf;
 
 // [[Rcpp::export]]
 Rcpp::List causal_train(const Rcpp::NumericMatrix& train_matrix,
+                        const Rcpp::NumericMatrix& response_matrix,
                         size_t outcome_index,
                         size_t treatment_index,
                         size_t sample_weight_index,
@@ -46,11 +47,12 @@ Rcpp::List causal_train(const Rcpp::NumericMatrix& train_matrix,
                         std::vector<size_t> clusters,
                         unsigned int samples_per_cluster,
                         bool compute_oob_predictions,
+                        bool store_leaf_samples,
                         unsigned int num_threads,
                         unsigned int seed) {
   ForestTrainer trainer = instrumental_trainer(reduced_form_weight, stabilize_splits);
 
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
   data.set_outcome_index(outcome_index);
   data.set_treatment_index(treatment_index);
   data.set_instrument_index(treatment_index);
@@ -59,15 +61,16 @@ Rcpp::List causal_train(const Rcpp::NumericMatrix& train_matrix,
   }
 
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-                        honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
-  Forest forest = trainer.train(data, options);
+                        honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster, store_leaf_samples);
 
-  std::vector<Prediction> predictions;
+  // The streamed OOB errors of the instrumental strategy only approximate its
+  // leave-one-tree-out jackknife, so the exact errors are computed from a second pass.
+  Forest forest = trainer.train(data, options);
+  Rcpp::List predictions;
   if (compute_oob_predictions) {
     ForestPredictor predictor = instrumental_predictor(num_threads);
-    predictions = predictor.predict_oob(forest, data, false);
+    predictions = RcppUtilities::predict_oob(predictor, forest, data, false);
   }
-
   return RcppUtilities::create_forest_object(forest, predictions);
 }
 
@@ -75,50 +78,49 @@ Rcpp::List causal_train(const Rcpp::NumericMatrix& train_matrix,
 // [[Rcpp::export]]
 Rcpp::List causal_predict(const Rcpp::List& forest_object,
                           const Rcpp::NumericMatrix& train_matrix,
+                          const Rcpp::NumericMatrix& response_matrix,
                           size_t outcome_index,
                           size_t treatment_index,
                           const Rcpp::NumericMatrix& test_matrix,
                           unsigned int num_threads,
                           bool estimate_variance) {
-  Data train_data = RcppUtilities::convert_data(train_matrix);
+  Data train_data = RcppUtilities::convert_data(train_matrix, response_matrix);
   train_data.set_outcome_index(outcome_index);
   train_data.set_treatment_index(treatment_index);
   train_data.set_instrument_index(treatment_index);
   Data data = RcppUtilities::convert_data(test_matrix);
 
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = instrumental_predictor(num_threads);
-  std::vector<Prediction> predictions = predictor.predict(forest, train_data, data, estimate_variance);
-  Rcpp::List result = RcppUtilities::create_prediction_object(predictions);
-
-  return result;
+  return RcppUtilities::predict(predictor, forest, train_data, data, estimate_variance);
 }
 
 // [[Rcpp::export]]
 Rcpp::List causal_predict_oob(const Rcpp::List& forest_object,
                               const Rcpp::NumericMatrix& train_matrix,
+                              const Rcpp::NumericMatrix& response_matrix,
                               size_t outcome_index,
                               size_t treatment_index,
                               unsigned int num_threads,
                               bool estimate_variance) {
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
   data.set_outcome_index(outcome_index);
   data.set_treatment_index(treatment_index);
   data.set_instrument_index(treatment_index);
 
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = instrumental_predictor(num_threads);
-  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, estimate_variance);
-  Rcpp::List result = RcppUtilities::create_prediction_object(predictions);
-
-  return result;
+  return RcppUtilities::predict_oob(predictor, forest, data, estimate_variance);
 }
 
 // [[Rcpp::export]]
 Rcpp::List ll_causal_predict(const Rcpp::List& forest_object,
                              const Rcpp::NumericMatrix& train_matrix,
+                             const Rcpp::NumericMatrix& response_matrix,
                              size_t outcome_index,
                              size_t treatment_index,
                              const Rcpp::NumericMatrix& test_matrix,
@@ -127,25 +129,24 @@ Rcpp::List ll_causal_predict(const Rcpp::List& forest_object,
                              std::vector<size_t> linear_correction_variables,
                              unsigned int num_threads,
                              bool estimate_variance) {
-  Data train_data = RcppUtilities::convert_data(train_matrix);
+  Data train_data = RcppUtilities::convert_data(train_matrix, response_matrix);
   train_data.set_outcome_index(outcome_index);
   train_data.set_treatment_index(treatment_index);
   train_data.set_instrument_index(treatment_index);
   Data data = RcppUtilities::convert_data(test_matrix);
 
-  Forest deserialized_forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = ll_causal_predictor(num_threads, ll_lambda, ll_weight_penalty,
                                                   linear_correction_variables);
-  std::vector<Prediction> predictions = predictor.predict(deserialized_forest, train_data, data, estimate_variance);
-  Rcpp::List result = RcppUtilities::create_prediction_object(predictions);
-
-  return result;
+  return RcppUtilities::predict(predictor, forest, train_data, data, estimate_variance);
 }
 
 // [[Rcpp::export]]
 Rcpp::List ll_causal_predict_oob(const Rcpp::List& forest_object,
                                  const Rcpp::NumericMatrix& train_matrix,
+                                 const Rcpp::NumericMatrix& response_matrix,
                                  size_t outcome_index,
                                  size_t treatment_index,
                                  std::vector<double> ll_lambda,
@@ -153,18 +154,16 @@ Rcpp::List ll_causal_predict_oob(const Rcpp::List& forest_object,
                                  std::vector<size_t> linear_correction_variables,
                                  unsigned int num_threads,
                                  bool estimate_variance) {
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
 
   data.set_outcome_index(outcome_index);
   data.set_treatment_index(treatment_index);
   data.set_instrument_index(treatment_index);
 
-  Forest deserialized_forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = ll_causal_predictor(num_threads, ll_lambda, ll_weight_penalty,
                                                   linear_correction_variables);
-  std::vector<Prediction> predictions = predictor.predict_oob(deserialized_forest, data, estimate_variance);
-  Rcpp::List result = RcppUtilities::create_prediction_object(predictions);
-
-  return result;
+  return RcppUtilities::predict_oob(predictor, forest, data, estimate_variance);
 }
@@ -27,6 +27,7 @@ using namespace grf;
 
 // [[Rcpp::export]]
 Rcpp::List causal_survival_train(const Rcpp::NumericMatrix& train_matrix,
+                                 const Rcpp::NumericMatrix& response_matrix,
                                  size_t causal_survival_numerator_index,
                                  size_t causal_survival_denominator_index,
                                  size_t treatment_index,
@@ -47,11 +48,12 @@ Rcpp::List causal_survival_train(const Rcpp::NumericMatrix& train_matrix,
                                  const std::vector<size_t>& clusters,
                                  unsigned int samples_per_cluster,
                                  bool compute_oob_predictions,
+                                 bool store_leaf_samples,
                                  unsigned int num_threads,
                                  unsigned int seed) {
   ForestTrainer trainer = causal_survival_trainer(stabilize_splits);
 
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
   data.set_causal_survival_numerator_index(causal_survival_numerator_index);
   data.set_causal_survival_denominator_index(causal_survival_denominator_index);
   data.set_treatment_index(treatment_index);
@@ -62,48 +64,38 @@ Rcpp::List causal_survival_train(const Rcpp::NumericMatrix& train_matrix,
   }
 
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
-  Forest forest = trainer.train(data, options);
-
-  std::vector<Prediction> predictions;
-  if (compute_oob_predictions) {
-    ForestPredictor predictor = causal_survival_predictor(num_threads);
-    predictions = predictor.predict_oob(forest, data, false);
-  }
-
-  return RcppUtilities::create_forest_object(forest, predictions);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster, store_leaf_samples);
+  return RcppUtilities::train(trainer, data, options, compute_oob_predictions);
 }
 
 // [[Rcpp::export]]
 Rcpp::List causal_survival_predict(const Rcpp::List& forest_object,
                                    const Rcpp::NumericMatrix& train_matrix,
+                                   const Rcpp::NumericMatrix& response_matrix,
                                    const Rcpp::NumericMatrix& test_matrix,
                                    unsigned int num_threads,
                                    bool estimate_variance) {
-  Data train_data = RcppUtilities::convert_data(train_matrix);
+  Data train_data = RcppUtilities::convert_data(train_matrix, response_matrix);
   Data data = RcppUtilities::convert_data(test_matrix);
 
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = causal_survival_predictor(num_threads);
-  std::vector<Prediction> predictions = predictor.predict(forest, train_data, data, estimate_variance);
-  Rcpp::List result = RcppUtilities::create_prediction_object(predictions);
-
-  return result;
+  return RcppUtilities::predict(predictor, forest, train_data, data, estimate_variance);
 }
 
 // [[Rcpp::export]]
 Rcpp::List causal_survival_predict_oob(const Rcpp::List& forest_object,
                                        const Rcpp::NumericMatrix& train_matrix,
+                                       const Rcpp::NumericMatrix& response_matrix,
                                        unsigned int num_threads,
                                        bool estimate_variance) {
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
 
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = causal_survival_predictor(num_threads);
-  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, estimate_variance);
-  Rcpp::List result = RcppUtilities::create_prediction_object(predictions);
-
-  return result;
+  return RcppUtilities::predict_oob(predictor, forest, data, estimate_variance);
 }
@@ -27,6 +27,7 @@ using namespace grf;
 
 // [[Rcpp::export]]
 Rcpp::List probability_train(const Rcpp::NumericMatrix& train_matrix,
+                             const Rcpp::NumericMatrix& response_matrix,
                              size_t outcome_index,
                              size_t sample_weight_index,
                              bool use_sample_weights,
@@ -44,63 +45,56 @@ Rcpp::List probability_train(const Rcpp::NumericMatrix& train_matrix,
                              const std::vector<size_t>& clusters,
                              unsigned int samples_per_cluster,
                              bool compute_oob_predictions,
+                             bool store_leaf_samples,
                              int num_threads,
                              unsigned int seed) {
   ForestTrainer trainer = probability_trainer(num_classes);
 
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
   data.set_outcome_index(outcome_index);
   if (use_sample_weights) {
     data.set_weight_index(sample_weight_index);
   }
 
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
-  Forest forest = trainer.train(data, options);
-
-  std::vector<Prediction> predictions;
-  if (compute_oob_predictions) {
-    ForestPredictor predictor = probability_predictor(num_threads, num_classes);
-    predictions = predictor.predict_oob(forest, data, false);
-  }
-
-  return RcppUtilities::create_forest_object(forest, predictions);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster, store_leaf_samples);
+  return RcppUtilities::train(trainer, data, options, compute_oob_predictions);
 }
 
 // [[Rcpp::export]]
 Rcpp::List probability_predict(const Rcpp::List& forest_object,
                                const Rcpp::NumericMatrix& train_matrix,
+                               const Rcpp::NumericMatrix& response_matrix,
                                size_t outcome_index,
                                size_t num_classes,
                                const Rcpp::NumericMatrix& test_matrix,
                                unsigned int num_threads,
                                bool estimate_variance) {
-  Data train_data = RcppUtilities::convert_data(train_matrix);
+  Data train_data = RcppUtilities::convert_data(train_matrix, response_matrix);
   Data data = RcppUtilities::convert_data(test_matrix);
   train_data.set_outcome_index(outcome_index);
 
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = probability_predictor(num_threads, num_classes);
-  std::vector<Prediction> predictions = predictor.predict(forest, train_data, data, estimate_variance);
-
-  return RcppUtilities::create_prediction_object(predictions);
+  return RcppUtilities::predict(predictor, forest, train_data, data, estimate_variance);
 }
 
 // [[Rcpp::export]]
 Rcpp::List probability_predict_oob(const Rcpp::List& forest_object,
                                    const Rcpp::NumericMatrix& train_matrix,
+                                   const Rcpp::NumericMatrix& response_matrix,
                                    size_t outcome_index,
                                    size_t num_classes,
                                    unsigned int num_threads,
                                    bool estimate_variance) {
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
   data.set_outcome_index(outcome_index);
 
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = probability_predictor(num_threads, num_classes);
-  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, estimate_variance);
-
-  return RcppUtilities::create_prediction_object(predictions);
+  return RcppUtilities::predict_oob(predictor, forest, data, estimate_variance);
 }
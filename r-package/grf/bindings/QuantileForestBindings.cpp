@@ -29,6 +29,7 @@ using namespace grf;
 Rcpp::List quantile_train(std::vector<double> quantiles,
                           bool regression_splitting,
                           const Rcpp::NumericMatrix& train_matrix,
+                          const Rcpp::NumericMatrix& response_matrix,
                           size_t outcome_index,
                           unsigned int mtry,
                           unsigned int num_trees,
@@ -49,17 +50,17 @@ Rcpp::List quantile_train(std::vector<double> quantiles,
       ? regression_trainer()
       : quantile_trainer(quantiles);
 
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
   data.set_outcome_index(outcome_index);
 
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
       honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
   Forest forest = trainer.train(data, options);
 
-  std::vector<Prediction> predictions;
+  Rcpp::List predictions;
   if (compute_oob_predictions) {
     ForestPredictor predictor = quantile_predictor(num_threads, quantiles);
-    predictions = predictor.predict_oob(forest, data, false);
+    predictions = RcppUtilities::predict_oob(predictor, forest, data, false);
   }
 
   return RcppUtilities::create_forest_object(forest, predictions);
@@ -69,36 +70,36 @@ Rcpp::List quantile_train(std::vector<double> quantiles,
 Rcpp::NumericMatrix quantile_predict(const Rcpp::List& forest_object,
                                      std::vector<double> quantiles,
                                      const Rcpp::NumericMatrix& train_matrix,
+                                     const Rcpp::NumericMatrix& response_matrix,
                                      size_t outcome_index,
                                      const Rcpp::NumericMatrix& test_matrix,
                                      unsigned int num_threads) {
-  Data train_data = RcppUtilities::convert_data(train_matrix);
+  Data train_data = RcppUtilities::convert_data(train_matrix, response_matrix);
   Data data = RcppUtilities::convert_data(test_matrix);
   train_data.set_outcome_index(outcome_index);
 
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = quantile_predictor(num_threads, quantiles);
-  std::vector<Prediction> predictions = predictor.predict(forest, train_data, data, false);
-  Rcpp::NumericMatrix result = RcppUtilities::create_prediction_matrix(predictions);
-
-  return result;
+  Rcpp::List result = RcppUtilities::predict(predictor, forest, train_data, data, false);
+  return result["predictions"];
 }
 
 // [[Rcpp::export]]
 Rcpp::NumericMatrix quantile_predict_oob(const Rcpp::List& forest_object,
                                          std::vector<double> quantiles,
                                          const Rcpp::NumericMatrix& train_matrix,
+                                         const Rcpp::NumericMatrix& response_matrix,
                                          size_t outcome_index,
                                          unsigned int num_threads) {
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
   data.set_outcome_index(outcome_index);
 
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = quantile_predictor(num_threads, quantiles);
-  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
-  Rcpp::NumericMatrix result = RcppUtilities::create_prediction_matrix(predictions);
-
-  return result;
+  Rcpp::List result = RcppUtilities::predict_oob(predictor, forest, data, false);
+  return result["predictions"];
 }
@@ -15,8 +15,15 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include <Rcpp.h>
 
+#include "commons/ByteOrder.h"
 #include "commons/Data.h"
 #include "forest/ForestOptions.h"
 #include "RcppUtilities.h"
@@ -24,14 +31,139 @@
 using namespace grf;
 
 Rcpp::List RcppUtilities::create_forest_object(Forest& forest,
-                                               const std::vector<Prediction>& predictions) {
+                                               const Rcpp::List& predictions) {
   Rcpp::List result = serialize_forest(forest);
-  if (!predictions.empty()) {
-    add_predictions(result, predictions);
+  if (predictions.size() > 0) {
+    Rcpp::CharacterVector names = predictions.names();
+    for (R_xlen_t i = 0; i < predictions.size(); i++) {
+      result.push_back(predictions[i], Rcpp::as<std::string>(names[i]));
+    }
   }
   return result;
 }
 
+Rcpp::List RcppUtilities::train(const ForestTrainer& trainer,
+                                const Data& data,
+                                const ForestOptions& options,
+                                bool compute_oob_predictions) {
+  if (!compute_oob_predictions) {
+    Forest forest = trainer.train(data, options);
+    return create_forest_object(forest, Rcpp::List());
+  }
+
+  const OptimizedPredictionStrategy* strategy = trainer.get_prediction_strategy();
+  if (strategy == nullptr) {
+    throw std::runtime_error("OOB predictions during training require precomputed prediction values.");
+  }
+
+  size_t num_samples = data.get_num_rows();
+  size_t prediction_length = strategy->prediction_length();
+  OOBPredictionAccumulator oob_accumulator(num_samples, strategy->prediction_value_length(),
+                                           strategy->has_streamed_error_estimates());
+  Forest forest = trainer.train(data, options, oob_accumulator);
+
+  Rcpp::NumericMatrix predictions(num_samples, prediction_length);
+  Rcpp::NumericMatrix error_estimates(num_samples, 1);
+  Rcpp::NumericMatrix excess_error_estimates(num_samples, 1);
+  PredictionOutput output(num_samples, prediction_length, predictions.begin(), nullptr,
+                          error_estimates.begin(), excess_error_estimates.begin());
+  oob_accumulator.predict(*strategy, data, output);
+
+  Rcpp::List result;
+  result.push_back(predictions, "predictions");
+  result.push_back(Rcpp::NumericMatrix(0), "variance.estimates");
+  result.push_back(error_estimates, "debiased.error");
+  result.push_back(excess_error_estimates, "excess.error");
+  return create_forest_object(forest, result);
+}
+
+namespace {
+
+const char* const CACHE_KEY = "_cache";
+const char* const CACHED_FOREST = "forest";
+
+const std::vector<std::string> TREE_FIELDS = {
+  "_ci_group_size", "_num_variables", "_num_trees", "_root_nodes", "_child_nodes",
+  "_leaf_samples", "_split_vars", "_split_values", "_drawn_samples",
+  "_send_missing_left", "_pv_values", "_pv_num_types"};
+
+// The cached forest holds the serialized fields it was built from in its external pointer's
+// protected slot. Since the fields are then referenced twice, R copies them on any
+// modification, including nested in-place ones such as f[["_split_values"]][[1]] <- v,
+// so a changed field is always a different object. Holding them also keeps their
+// addresses from being reused by other objects after garbage collection.
+Rcpp::List get_source_fields(const Rcpp::List& forest_object) {
+  Rcpp::List fields(TREE_FIELDS.size());
+  for (size_t i = 0; i < TREE_FIELDS.size(); i++) {
+    fields[i] = forest_object[TREE_FIELDS[i]];
+  }
+  return fields;
+}
+
+bool is_same_source(SEXP cached, const Rcpp::List& current) {
+  if (TYPEOF(cached) != VECSXP || Rf_xlength(cached) != current.size()) {
+    return false;
+  }
+  for (R_xlen_t i = 0; i < current.size(); i++) {
+    if (VECTOR_ELT(cached, i) != VECTOR_ELT(current, i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// R has no 64-bit integers, so the drawn sample bitmaps are stored as the bytes of their
+// words in little-endian order. In R, rawToBits then gives one bit per sample.
+Rcpp::RawVector serialize_bitmap(const Bitmap& bitmap) {
+  const std::vector<uint64_t>& words = bitmap.get_words();
+  Rcpp::RawVector bytes(words.size() * sizeof(uint64_t));
+  for (size_t w = 0; w < words.size(); w++) {
+    uint64_t word = to_little_endian(words[w]);
+    std::memcpy(bytes.begin() + w * sizeof(uint64_t), &word, sizeof(word));
+  }
+  return bytes;
+}
+
+Bitmap deserialize_bitmap(const Rcpp::RawVector& bytes) {
+  std::vector<uint64_t> words(bytes.size() / sizeof(uint64_t));
+  for (size_t w = 0; w < words.size(); w++) {
+    uint64_t word;
+    std::memcpy(&word, bytes.begin() + w * sizeof(uint64_t), sizeof(word));
+    words[w] = from_little_endian(word);
+  }
+  return Bitmap::from_words(words);
+}
+
+} // namespace
+
+Rcpp::XPtr<Forest> RcppUtilities::get_forest(const Rcpp::List& forest_object) {
+  if (!forest_object.containsElementNamed(CACHE_KEY)) {
+    return Rcpp::XPtr<Forest>(new Forest(deserialize_forest(forest_object)));
+  }
+
+  Rcpp::Environment cache = forest_object[CACHE_KEY];
+  Rcpp::List fields = get_source_fields(forest_object);
+
+  if (cache.exists(CACHED_FOREST)) {
+    SEXP reference = cache.get(CACHED_FOREST);
+    SEXP cached = TYPEOF(reference) == WEAKREFSXP ? R_WeakRefValue(reference) : R_NilValue;
+    if (TYPEOF(cached) == EXTPTRSXP) {
+      Rcpp::XPtr<Forest> forest(cached);
+      if (forest.get() != nullptr && is_same_source(forest.prot(), fields)) {
+        return forest;
+      }
+    }
+  }
+
+  // The forest is kept alive by a weak reference keyed on the cache environment. R does
+  // not serialize the contents of weak references, so saving the forest object does not
+  // write the fields held by the cache a second time.
+  Rcpp::XPtr<Forest> forest(new Forest(deserialize_forest(forest_object)), true, R_NilValue, fields);
+  Rcpp::RObject reference(R_MakeWeakRef(cache, forest, R_NilValue, FALSE));
+  cache.assign(CACHED_FOREST, reference);
+  return forest;
+}
+
 Forest RcppUtilities::deserialize_forest(const Rcpp::List& forest_object) {
   size_t ci_group_size = forest_object["_ci_group_size"];
   size_t num_variables = forest_object["_num_variables"];
@@ -58,9 +190,10 @@ Forest RcppUtilities::deserialize_forest(const Rcpp::List& forest_object) {
                          leaf_samples.at(t),
                          split_vars.at(t),
                          split_values.at(t),
-                         drawn_samples.at(t),
+                         std::vector<size_t>(),
                          send_missing_left.at(t),
                          PredictionValues(prediction_values.at(t), num_types)));
+    trees.back()->set_drawn_samples(deserialize_bitmap(drawn_samples.at(t)));
   }
 
   return Forest(trees, num_variables, ci_group_size);
@@ -93,7 +226,7 @@ Rcpp::List RcppUtilities::serialize_forest(Forest& forest) {
     leaf_samples[t] = tree->get_leaf_samples();
     split_vars[t] = tree->get_split_vars();
     split_values[t] = tree->get_split_values();
-    drawn_samples[t] = tree->get_drawn_samples();
+    drawn_samples[t] = serialize_bitmap(tree->get_drawn_sample_bitmap());
     send_missing_left[t] = tree->get_send_missing_left();
 
     prediction_values[t] = tree->get_prediction_values().get_all_values();
@@ -109,109 +242,156 @@ Rcpp::List RcppUtilities::serialize_forest(Forest& forest) {
   result.push_back(send_missing_left, "_send_missing_left");
   result.push_back(prediction_values, "_pv_values");
   result.push_back(num_types, "_pv_num_types");
+  result.push_back(Rcpp::Environment::empty_env().new_child(false), CACHE_KEY);
   return result;
 };
 
-Data RcppUtilities::convert_data(const Rcpp::NumericMatrix& input_data) {
-  return Data(input_data.begin(), input_data.nrow(), input_data.ncol());
-}
+Rcpp::List RcppUtilities::merge_forest_objects(const Rcpp::List& forest_objects) {
+  if (forest_objects.size() == 0) {
+    throw std::runtime_error("At least one forest must be provided to merge.");
+  }
 
-Rcpp::List RcppUtilities::create_prediction_object(const std::vector<Prediction>& predictions) {
-  Rcpp::List result;
-  add_predictions(result, predictions);
-  return result;
-};
+  const std::vector<std::string> tree_fields = {
+    "_root_nodes", "_child_nodes", "_leaf_samples", "_split_vars", "_split_values",
+    "_drawn_samples", "_send_missing_left", "_pv_values"};
 
-void RcppUtilities::add_predictions(Rcpp::List& output,
-                                    const std::vector<Prediction>& predictions) {
-  output.push_back(RcppUtilities::create_prediction_matrix(predictions), "predictions");
-  output.push_back(RcppUtilities::create_variance_matrix(predictions), "variance.estimates");
-  output.push_back(RcppUtilities::create_error_matrix(predictions), "debiased.error");
-  output.push_back(RcppUtilities::create_excess_error_matrix(predictions), "excess.error");
-}
-
-Rcpp::NumericMatrix RcppUtilities::create_prediction_matrix(const std::vector<Prediction>& predictions) {
-  if (predictions.empty()) {
-    return Rcpp::NumericMatrix(0);
-  }
+  Rcpp::List first_forest = forest_objects[0];
+  size_t ci_group_size = first_forest["_ci_group_size"];
+  size_t num_variables = first_forest["_num_variables"];
+  size_t num_types = 0;
 
-  size_t prediction_length = predictions.at(0).size();
-  Rcpp::NumericMatrix result(predictions.size(), prediction_length);
+  // Validate every forest up front, before allocating the merged lists.
+  size_t num_trees = 0;
+  for (R_xlen_t i = 0; i < forest_objects.size(); i++) {
+    Rcpp::List forest_object = forest_objects[i];
+    size_t forest_ci_group_size = forest_object["_ci_group_size"];
+    size_t forest_num_variables = forest_object["_num_variables"];
+    if (forest_ci_group_size != ci_group_size) {
+      throw std::runtime_error("All forests being merged must have the same ci_group_size.");
+    }
+    if (forest_num_variables != num_variables) {
+      throw std::runtime_error("All forests being merged must have the same num_variables.");
+    }
 
-  for (size_t i = 0; i < predictions.size(); i++) {
-    const std::vector<double>& prediction = predictions[i].get_predictions();
-    for (size_t j = 0; j < prediction.size(); j++) {
-      double value = prediction[j];
-      result(i, j) = value;
+    size_t forest_num_trees = forest_object["_num_trees"];
+    if (forest_num_trees > 0) {
+      size_t forest_num_types = forest_object["_pv_num_types"];
+      if (num_types > 0 && forest_num_types != num_types) {
+        throw std::runtime_error("All forests being merged must have the same prediction value types.");
+      }
+      num_types = forest_num_types;
     }
+    num_trees += forest_num_trees;
   }
-  return result;
-}
 
-Rcpp::NumericMatrix RcppUtilities::create_variance_matrix(const std::vector<Prediction>& predictions) {
-  if (predictions.empty()) {
-    return Rcpp::NumericMatrix(0);
+  std::vector<Rcpp::List> merged_fields;
+  for (size_t field = 0; field < tree_fields.size(); field++) {
+    merged_fields.emplace_back(num_trees);
   }
 
-  Prediction first_prediction = predictions.at(0);
-  if (!first_prediction.contains_variance_estimates()) {
-    return Rcpp::NumericMatrix(0);
+  // Copying list elements only copies references to the underlying R vectors.
+  size_t offset = 0;
+  for (R_xlen_t i = 0; i < forest_objects.size(); i++) {
+    Rcpp::List forest_object = forest_objects[i];
+    size_t forest_num_trees = forest_object["_num_trees"];
+    for (size_t field = 0; field < tree_fields.size(); field++) {
+      Rcpp::List values = forest_object[tree_fields[field]];
+      for (size_t t = 0; t < forest_num_trees; t++) {
+        merged_fields[field][offset + t] = values[t];
+      }
+    }
+    offset += forest_num_trees;
   }
 
-  size_t prediction_length = first_prediction.size();
-  Rcpp::NumericMatrix result(predictions.size(), prediction_length);
-
-  for (size_t i = 0; i < predictions.size(); i++) {
-    const std::vector<double>& variance_estimate = predictions[i].get_variance_estimates();
-    for (size_t j = 0; j < variance_estimate.size(); j++) {
-      double value = variance_estimate[j];
-      result(i, j) = value;
-    }
+  Rcpp::List result;
+  result.push_back(ci_group_size, "_ci_group_size");
+  result.push_back(num_variables, "_num_variables");
+  result.push_back(num_trees, "_num_trees");
+  for (size_t field = 0; field < tree_fields.size(); field++) {
+    result.push_back(merged_fields[field], tree_fields[field]);
   }
+  result.push_back(num_types, "_pv_num_types");
+  result.push_back(Rcpp::Environment::empty_env().new_child(false), CACHE_KEY);
   return result;
 }
 
-Rcpp::NumericMatrix RcppUtilities::create_error_matrix(const std::vector<Prediction>& predictions) {
-  if (predictions.empty()) {
-    return Rcpp::NumericMatrix(0);
-  }
+Data RcppUtilities::convert_data(const Rcpp::NumericMatrix& input_data) {
+  return Data(input_data.begin(), input_data.nrow(), input_data.ncol());
+}
 
-  Prediction first_prediction = predictions.at(0);
-  if (!first_prediction.contains_error_estimates()) {
-    return Rcpp::NumericMatrix(0);
+Data RcppUtilities::convert_data(const Rcpp::NumericMatrix& train_matrix,
+                                 const Rcpp::NumericMatrix& response_matrix) {
+  size_t num_rows = train_matrix.nrow();
+  if (static_cast<size_t>(response_matrix.nrow()) != num_rows) {
+    throw std::runtime_error("The response matrix must have as many rows as the training matrix.");
   }
 
-  Rcpp::NumericMatrix result(predictions.size(), 1);
-
-  for (size_t i = 0; i < predictions.size(); i++) {
-    const std::vector<double>& error_estimate = predictions[i].get_error_estimates();
-    for (size_t j = 0; j < error_estimate.size(); j++) {
-      double value = error_estimate[j];
-      result(i, j) = value;
-    }
+  std::vector<const double*> columns;
+  columns.reserve(train_matrix.ncol() + response_matrix.ncol());
+  for (int col = 0; col < train_matrix.ncol(); col++) {
+    columns.push_back(train_matrix.begin() + col * num_rows);
   }
-  return result;
+  for (int col = 0; col < response_matrix.ncol(); col++) {
+    columns.push_back(response_matrix.begin() + col * num_rows);
+  }
+  return Data(columns, num_rows);
 }
 
+Rcpp::List RcppUtilities::predict(const ForestPredictor& predictor,
+                                  const Forest& forest,
+                                  const Data& train_data,
+                                  const Data& data,
+                                  bool estimate_variance) {
+  size_t num_samples = data.get_num_rows();
+  size_t prediction_length = predictor.get_prediction_length();
 
-Rcpp::NumericMatrix RcppUtilities::create_excess_error_matrix(const std::vector<Prediction>& predictions) {
-  if (predictions.empty()) {
-    return Rcpp::NumericMatrix(0);
-  }
+  Rcpp::NumericMatrix predictions(num_samples, prediction_length);
+  Rcpp::NumericMatrix variance_estimates = estimate_variance
+      ? Rcpp::NumericMatrix(num_samples, prediction_length)
+      : Rcpp::NumericMatrix(0);
 
-  Prediction first_prediction = predictions.at(0);
-  if (!first_prediction.contains_error_estimates()) {
-    return Rcpp::NumericMatrix(0);
-  }
+  PredictionOutput output(num_samples, prediction_length, predictions.begin(),
+                          estimate_variance ? variance_estimates.begin() : nullptr,
+                          nullptr, nullptr);
+  predictor.predict(forest, train_data, data, output);
+
+  Rcpp::List result;
+  result.push_back(predictions, "predictions");
+  result.push_back(variance_estimates, "variance.estimates");
+  result.push_back(Rcpp::NumericMatrix(0), "debiased.error");
+  result.push_back(Rcpp::NumericMatrix(0), "excess.error");
+  return result;
+}
 
-  Rcpp::NumericMatrix result(predictions.size(), 1);
+Rcpp::List RcppUtilities::predict_oob(const ForestPredictor& predictor,
+                                      const Forest& forest,
+                                      const Data& data,
+                                      bool estimate_variance) {
+  size_t num_samples = data.get_num_rows();
+  size_t prediction_length = predictor.get_prediction_length();
+  bool estimate_error = predictor.supports_error_estimates();
+
+  Rcpp::NumericMatrix predictions(num_samples, prediction_length);
+  Rcpp::NumericMatrix variance_estimates = estimate_variance
+      ? Rcpp::NumericMatrix(num_samples, prediction_length)
+      : Rcpp::NumericMatrix(0);
+  Rcpp::NumericMatrix error_estimates = estimate_error
+      ? Rcpp::NumericMatrix(num_samples, 1)
+      : Rcpp::NumericMatrix(0);
+  Rcpp::NumericMatrix excess_error_estimates = estimate_error
+      ? Rcpp::NumericMatrix(num_samples, 1)
+      : Rcpp::NumericMatrix(0);
+
+  PredictionOutput output(num_samples, prediction_length, predictions.begin(),
+                          estimate_variance ? variance_estimates.begin() : nullptr,
+                          estimate_error ? error_estimates.begin() : nullptr,
+                          estimate_error ? excess_error_estimates.begin() : nullptr);
+  predictor.predict_oob(forest, data, output);
 
-  for (size_t i = 0; i < predictions.size(); i++) {
-    const std::vector<double>& error_estimate = predictions[i].get_excess_error_estimates();
-    for (size_t j = 0; j < error_estimate.size(); j++) {
-      double value = error_estimate[j];
-      result(i, j) = value;
-    }
-  }
+  Rcpp::List result;
+  result.push_back(predictions, "predictions");
+  result.push_back(variance_estimates, "variance.estimates");
+  result.push_back(error_estimates, "debiased.error");
+  result.push_back(excess_error_estimates, "excess.error");
   return result;
 }
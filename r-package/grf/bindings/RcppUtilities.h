@@ -19,6 +19,7 @@
 #define GRF_RCPPUTILITIES_H
 
 #include "commons/globals.h"
+#include "forest/ForestPredictor.h"
 #include "forest/ForestTrainer.h"
 
 using namespace grf;
@@ -27,30 +28,82 @@ class RcppUtilities {
 public:
 
   /**
-   * Converts the provided {@link Forest} object and OOB predictions to an R list
-   * to be returned through the Rcpp bindings. The provided predictions vector can
-   * be present if OOB predictions were not requested as part of training.
+   * Converts the provided {@link Forest} object to an R list to be returned through the
+   * Rcpp bindings, attaching the entries of a prediction list such as the one returned
+   * by predict_oob. The list is empty if OOB predictions were not requested as part of
+   * training.
    *
    * NOTE: To conserve memory, this method destructively modifies the forest
    * object by clearing out individual {@link Tree} objects. The forest cannot
    * be used once it has been passed to the method.
    */
   static Rcpp::List create_forest_object(Forest& forest,
-                                         const std::vector<Prediction>& predictions);
+                                         const Rcpp::List& predictions);
+
+  /**
+   * Trains a forest with a trainer that precomputes prediction values, and converts it
+   * to an R list as in create_forest_object. If compute_oob_predictions is set, the OOB
+   * predictions and error estimates are accumulated while the trees are grown, and are
+   * attached in the layout of predict_oob without a second pass over the forest.
+   *
+   * The error estimates are those of OptimizedPredictionStrategy::compute_error from
+   * running sums, so this should only be used where those match predict_oob. Causal and
+   * instrumental forests instead call predict_oob, whose jackknife error estimates the
+   * streamed sums only approximate.
+   */
+  static Rcpp::List train(const ForestTrainer& trainer,
+                          const Data& data,
+                          const ForestOptions& options,
+                          bool compute_oob_predictions);
 
   static Rcpp::List serialize_forest(Forest& forest);
   static Forest deserialize_forest(const Rcpp::List& forest_object);
 
+  /**
+   * Returns the C++ {@link Forest} backing the given R forest object, deserializing
+   * it only on first use. The built forest is cached through an external pointer in
+   * the object's '_cache' environment, which is shared by all R copies of the list,
+   * so repeated predictions on the same forest skip deserialization entirely.
+   *
+   * The cache is rebuilt whenever it is missing (it is not saved by saveRDS) or when
+   * any of the serialized tree fields is no longer the R object it was built from.
+   * The cache holds references to those fields, so R copies them on modification.
+   * Objects without a '_cache' entry get a fresh forest.
+   */
+  static Rcpp::XPtr<Forest> get_forest(const Rcpp::List& forest_object);
+
+  /**
+   * Merges serialized forests by concatenating their per-tree entries directly in the
+   * R list representation. The tree payloads are shared with the input objects rather
+   * than being rebuilt as {@link Tree} objects, so merging does not transiently hold
+   * several copies of each forest in memory.
+   */
+  static Rcpp::List merge_forest_objects(const Rcpp::List& forest_objects);
+
   static Data convert_data(const Rcpp::NumericMatrix& input_data);
 
-  static Rcpp::List create_prediction_object(const std::vector<Prediction>& predictions);
-  static void add_predictions(Rcpp::List& output,
-                              const std::vector<Prediction>& predictions);
+  /**
+   * Wraps the covariates in train_matrix followed by the outcomes, treatments and other
+   * columns in response_matrix, without copying either matrix into one array.
+   */
+  static Data convert_data(const Rcpp::NumericMatrix& train_matrix,
+                           const Rcpp::NumericMatrix& response_matrix);
 
-  static Rcpp::NumericMatrix create_prediction_matrix(const std::vector<Prediction>& predictions);
-  static Rcpp::NumericMatrix create_variance_matrix(const std::vector<Prediction>& predictions);
-  static Rcpp::NumericMatrix create_error_matrix(const std::vector<Prediction>& predictions);
-  static Rcpp::NumericMatrix create_excess_error_matrix(const std::vector<Prediction>& predictions);
+  /**
+   * Predicts directly into newly allocated R matrices, returned as a list with entries
+   * predictions, variance.estimates, debiased.error and excess.error. The collectors
+   * write into the matrices' column-major storage, so no per-sample Prediction objects
+   * are created.
+   */
+  static Rcpp::List predict(const ForestPredictor& predictor,
+                            const Forest& forest,
+                            const Data& train_data,
+                            const Data& data,
+                            bool estimate_variance);
+  static Rcpp::List predict_oob(const ForestPredictor& predictor,
+                                const Forest& forest,
+                                const Data& data,
+                                bool estimate_variance);
 
 };
 
@@ -27,6 +27,7 @@ using namespace grf;
 
 // [[Rcpp::export]]
 Rcpp::List regression_train(const Rcpp::NumericMatrix& train_matrix,
+                            const Rcpp::NumericMatrix& response_matrix,
                             size_t outcome_index,
                             size_t sample_weight_index,
                             bool use_sample_weights,
@@ -43,68 +44,61 @@ Rcpp::List regression_train(const Rcpp::NumericMatrix& train_matrix,
                             std::vector<size_t> clusters,
                             unsigned int samples_per_cluster,
                             bool compute_oob_predictions,
+                            bool store_leaf_samples,
                             unsigned int num_threads,
                             unsigned int seed) {
   ForestTrainer trainer = regression_trainer();
 
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
   data.set_outcome_index(outcome_index);
   if (use_sample_weights) {
     data.set_weight_index(sample_weight_index);
   }
 
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
-  Forest forest = trainer.train(data, options);
-
-  std::vector<Prediction> predictions;
-  if (compute_oob_predictions) {
-    ForestPredictor predictor = regression_predictor(num_threads);
-    predictions = predictor.predict_oob(forest, data, false);
-  }
-
-  return RcppUtilities::create_forest_object(forest, predictions);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster, store_leaf_samples);
+  return RcppUtilities::train(trainer, data, options, compute_oob_predictions);
 }
 
 // [[Rcpp::export]]
 Rcpp::List regression_predict(const Rcpp::List& forest_object,
                               const Rcpp::NumericMatrix& train_matrix,
+                              const Rcpp::NumericMatrix& response_matrix,
                               size_t outcome_index,
                               const Rcpp::NumericMatrix& test_matrix,
                               unsigned int num_threads,
                               unsigned int estimate_variance) {
-  Data train_data = RcppUtilities::convert_data(train_matrix);
+  Data train_data = RcppUtilities::convert_data(train_matrix, response_matrix);
   train_data.set_outcome_index(outcome_index);
 
   Data data = RcppUtilities::convert_data(test_matrix);
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = regression_predictor(num_threads);
-  std::vector<Prediction> predictions = predictor.predict(forest, train_data, data, estimate_variance);
-
-  return RcppUtilities::create_prediction_object(predictions);
+  return RcppUtilities::predict(predictor, forest, train_data, data, estimate_variance);
 }
 
 // [[Rcpp::export]]
 Rcpp::List regression_predict_oob(const Rcpp::List& forest_object,
                                   const Rcpp::NumericMatrix& train_matrix,
+                                  const Rcpp::NumericMatrix& response_matrix,
                                   size_t outcome_index,
                                   unsigned int num_threads,
                                   bool estimate_variance) {
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
   data.set_outcome_index(outcome_index);
 
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = regression_predictor(num_threads);
-  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, estimate_variance);
-
-  Rcpp::List result = RcppUtilities::create_prediction_object(predictions);
-  return result;
+  return RcppUtilities::predict_oob(predictor, forest, data, estimate_variance);
 }
 
 // [[Rcpp::export]]
 Rcpp::List ll_regression_train(const Rcpp::NumericMatrix& train_matrix,
+                               const Rcpp::NumericMatrix& response_matrix,
                             size_t outcome_index,
                             double ll_split_lambda,
                             bool ll_split_weight_penalty,
@@ -128,20 +122,20 @@ Rcpp::List ll_regression_train(const Rcpp::NumericMatrix& train_matrix,
   ForestTrainer trainer = ll_regression_trainer(ll_split_lambda, ll_split_weight_penalty, overall_beta,
                                                ll_split_cutoff, ll_split_variables);
 
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
   data.set_outcome_index(outcome_index);
 
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
                         honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
   Forest forest = trainer.train(data, options);
 
-  std::vector<Prediction> predictions;
-  return RcppUtilities::create_forest_object(forest, predictions);
+  return RcppUtilities::create_forest_object(forest, Rcpp::List());
 }
 
 // [[Rcpp::export]]
 Rcpp::List ll_regression_predict(const Rcpp::List& forest_object,
                                 const Rcpp::NumericMatrix& train_matrix,
+                                const Rcpp::NumericMatrix& response_matrix,
                                 size_t outcome_index,
                                 const Rcpp::NumericMatrix& test_matrix,
                                 std::vector<double> ll_lambda,
@@ -149,38 +143,35 @@ Rcpp::List ll_regression_predict(const Rcpp::List& forest_object,
                                 std::vector<size_t> linear_correction_variables,
                                 unsigned int num_threads,
                                 bool estimate_variance) {
-  Data train_data = RcppUtilities::convert_data(train_matrix);
+  Data train_data = RcppUtilities::convert_data(train_matrix, response_matrix);
   train_data.set_outcome_index(outcome_index);
   Data data = RcppUtilities::convert_data(test_matrix);
 
-  Forest deserialized_forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = ll_regression_predictor(num_threads,
       ll_lambda, ll_weight_penalty, linear_correction_variables);
-  std::vector<Prediction> predictions = predictor.predict(deserialized_forest, train_data, data, estimate_variance);
-  Rcpp::List result = RcppUtilities::create_prediction_object(predictions);
-
-  return result;
+  return RcppUtilities::predict(predictor, forest, train_data, data, estimate_variance);
 }
 
 // [[Rcpp::export]]
 Rcpp::List ll_regression_predict_oob(const Rcpp::List& forest_object,
                                     const Rcpp::NumericMatrix& train_matrix,
+                                    const Rcpp::NumericMatrix& response_matrix,
                                     size_t outcome_index,
                                     std::vector<double> ll_lambda,
                                     bool ll_weight_penalty,
                                     std::vector<size_t> linear_correction_variables,
                                     unsigned int num_threads,
                                     bool estimate_variance) {
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
   data.set_outcome_index(outcome_index);
 
-  Forest deserialized_forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   ForestPredictor predictor = ll_regression_predictor(num_threads,
       ll_lambda, ll_weight_penalty, linear_correction_variables);
-  std::vector<Prediction> predictions = predictor.predict_oob(deserialized_forest, data, estimate_variance);
-  Rcpp::List result = RcppUtilities::create_prediction_object(predictions);
-
-  return result;
+  return RcppUtilities::predict_oob(predictor, forest, data, estimate_variance);
 }
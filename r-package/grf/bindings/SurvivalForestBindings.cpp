@@ -27,6 +27,7 @@ using namespace grf;
 
 // [[Rcpp::export]]
 Rcpp::List survival_train(const Rcpp::NumericMatrix& train_matrix,
+                          const Rcpp::NumericMatrix& response_matrix,
                           size_t outcome_index,
                           size_t censor_index,
                           size_t sample_weight_index,
@@ -48,7 +49,7 @@ Rcpp::List survival_train(const Rcpp::NumericMatrix& train_matrix,
                           unsigned int seed) {
   ForestTrainer trainer = survival_trainer();
 
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
   data.set_outcome_index(outcome_index);
   data.set_censor_index(censor_index);
   if (use_sample_weights) {
@@ -61,10 +62,10 @@ Rcpp::List survival_train(const Rcpp::NumericMatrix& train_matrix,
       honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
   Forest forest = trainer.train(data, options);
 
-  std::vector<Prediction> predictions;
+  Rcpp::List predictions;
   if (compute_oob_predictions) {
     ForestPredictor predictor = survival_predictor(num_threads, num_failures, prediction_type);
-    predictions = predictor.predict_oob(forest, data, false);
+    predictions = RcppUtilities::predict_oob(predictor, forest, data, false);
   }
 
   return RcppUtilities::create_forest_object(forest, predictions);
@@ -73,6 +74,7 @@ Rcpp::List survival_train(const Rcpp::NumericMatrix& train_matrix,
 // [[Rcpp::export]]
 Rcpp::List survival_predict(const Rcpp::List& forest_object,
                             const Rcpp::NumericMatrix& train_matrix,
+                            const Rcpp::NumericMatrix& response_matrix,
                             size_t outcome_index,
                             size_t censor_index,
                             size_t sample_weight_index,
@@ -81,7 +83,7 @@ Rcpp::List survival_predict(const Rcpp::List& forest_object,
                             const Rcpp::NumericMatrix& test_matrix,
                             unsigned int num_threads,
                             size_t num_failures) {
-  Data train_data = RcppUtilities::convert_data(train_matrix);
+  Data train_data = RcppUtilities::convert_data(train_matrix, response_matrix);
   train_data.set_outcome_index(outcome_index);
   train_data.set_censor_index(censor_index);
   if (use_sample_weights) {
@@ -89,18 +91,18 @@ Rcpp::List survival_predict(const Rcpp::List& forest_object,
   }
 
   Data data = RcppUtilities::convert_data(test_matrix);
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   bool estimate_variance = false;
   ForestPredictor predictor = survival_predictor(num_threads, num_failures, prediction_type);
-  std::vector<Prediction> predictions = predictor.predict(forest, train_data, data, estimate_variance);
-
-  return RcppUtilities::create_prediction_object(predictions);
+  return RcppUtilities::predict(predictor, forest, train_data, data, estimate_variance);
 }
 
 // [[Rcpp::export]]
 Rcpp::List survival_predict_oob(const Rcpp::List& forest_object,
                                 const Rcpp::NumericMatrix& train_matrix,
+                                const Rcpp::NumericMatrix& response_matrix,
                                 size_t outcome_index,
                                 size_t censor_index,
                                 size_t sample_weight_index,
@@ -108,19 +110,17 @@ Rcpp::List survival_predict_oob(const Rcpp::List& forest_object,
                                 int prediction_type,
                                 unsigned int num_threads,
                                 size_t num_failures) {
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, response_matrix);
   data.set_outcome_index(outcome_index);
   data.set_censor_index(censor_index);
   if (use_sample_weights) {
     data.set_weight_index(sample_weight_index);
   }
 
-  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  Rcpp::XPtr<Forest> forest_ptr = RcppUtilities::get_forest(forest_object);
+  const Forest& forest = *forest_ptr;
 
   bool estimate_variance = false;
   ForestPredictor predictor = survival_predictor(num_threads, num_failures, prediction_type);
-  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, estimate_variance);
-
-  Rcpp::List result = RcppUtilities::create_prediction_object(predictions);
-  return result;
+  return RcppUtilities::predict_oob(predictor, forest, data, estimate_variance);
 }